@@ -4,6 +4,7 @@
 #include <Common/Tokenizer.h>
 #include <DesignExtractor/DesignExtractor.h>
 #include <Parser/Parser.h>
+#include <Query/Cache/QueryCache.h>
 #include <Query/Evaluator/QueryEvaluator.h>
 #include <Query/Optimizer/QueryOptimizer.h>
 #include <Query/Parser/QueryLexerParserCommon.h>
@@ -29,6 +30,7 @@ volatile bool AbstractWrapper::GlobalStop = false;
 // a default constructor
 TestWrapper::TestWrapper() {
   pkb = new PKB();
+  queryCache = new QueryCache(pkb);
   this->OurOwnGlobalStop = false;
 }
 
@@ -64,19 +66,19 @@ void TestWrapper::evaluate(std::string query, std::list<std::string>& results) {
   }
 
   try {
-    tuple<SynonymMap, SelectClause> parsedQuery = QueryParser().Parse(query);
+    // parsing and clause preprocessing are skipped for repeated queries
+    const cache::CachedQuery& cachedQuery = queryCache->GetOrParse(query);
     DMOprintInfoMsg("Query Parser was successful");
 
-    QueryOptimizer* queryOptimizer = new QueryOptimizer(pkb);
-    queryOptimizer->PreprocessClauses(get<0>(parsedQuery), get<1>(parsedQuery));
-
-    query::FinalQueryResults evaluatedResult =
-        QueryEvaluator(pkb, queryOptimizer)
-            .evaluateQuery(get<0>(parsedQuery), get<1>(parsedQuery));
+    QueryOptimizer queryOptimizer = cachedQuery.optimizer;
+    query::FactorisedQueryResults evaluatedResult =
+        QueryEvaluator(pkb, &queryOptimizer)
+            .evaluateQueryFactorised(cachedQuery.synonymMap,
+                                     cachedQuery.selectClause);
     DMOprintInfoMsg("Query Evaluator was successful");
 
-    SelectClause selectClause = get<1>(parsedQuery);
-    results = ResultProjector(pkb).formatResults(
+    SelectClause selectClause = cachedQuery.selectClause;
+    results = ResultProjector(pkb).formatFactorisedResults(
         selectClause.selectType, selectClause.selectSynonyms, evaluatedResult);
     DMOprintInfoMsg("Query Result Projector was successful");
 
@@ -8,10 +8,12 @@
 // include your other headers here
 #include "AbstractWrapper.h"
 #include "PKB/PKB.h"
+#include "Query/Cache/QueryCache.h"
 
 class TestWrapper : public AbstractWrapper {
  private:
   PKB* pkb;
+  QueryCache* queryCache;
   bool OurOwnGlobalStop;
 
  public:
@@ -3,6 +3,7 @@
 #include <Query/Evaluator/QueryEvaluator.h>
 
 #include <iostream>
+#include <tuple>
 
 #include "../TestQueryUtil.h"
 #include "catch.hpp"
@@ -1318,3 +1319,436 @@ TEST_CASE("QueryEvaluator: Multiple NextT - Ensure Cache Correctness") {
     }
   }
 }
+
+TEST_CASE("QueryEvaluator: Synonym Domains Narrowed Across Clauses") {
+  // 1 -> 2 -> 3 follow each other, 3 is a while with 4 (assign) and
+  // 5 (print) nested in it
+  PKB* pkb = new PKB();
+  pkb->addStmt(DesignEntity::ASSIGN, 1);
+  pkb->addStmt(DesignEntity::ASSIGN, 2);
+  pkb->addStmt(DesignEntity::WHILE, 3);
+  pkb->addStmt(DesignEntity::ASSIGN, 4);
+  pkb->addStmt(DesignEntity::PRINT, 5);
+
+  pkb->addRs(RelationshipType::FOLLOWS, 1, 2);
+  pkb->addRs(RelationshipType::FOLLOWS, 2, 3);
+  pkb->addRs(RelationshipType::FOLLOWS, 4, 5);
+  pkb->addRs(RelationshipType::PARENT, 3, 4);
+  pkb->addRs(RelationshipType::PARENT, 3, 5);
+  pkb->addRs(RelationshipType::USES_S, 5, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::USES_S, 3, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::USES_S, 2, TableType::VAR_TABLE, "y");
+
+  unordered_map<string, DesignEntity> synonyms = {
+      {"s1", DesignEntity::STATEMENT},
+      {"s2", DesignEntity::STATEMENT},
+      {"a", DesignEntity::ASSIGN},
+      {"w", DesignEntity::WHILE}};
+  Synonym s1 = {DesignEntity::STATEMENT, "s1"};
+  Synonym s2 = {DesignEntity::STATEMENT, "s2"};
+  Synonym a = {DesignEntity::ASSIGN, "a"};
+  vector<ConditionClause> conditionClauses = {};
+
+  SECTION("Select <s1, s2> such that Follows(s1, s2) and Uses(s2, \"x\")") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::FOLLOWS, ParamType::SYNONYM, "s1",
+        ParamType::SYNONYM, "s2");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::USES_S, ParamType::SYNONYM, "s2",
+        ParamType::NAME_LITERAL, "x");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {s1, s2});
+    REQUIRE(results == FinalQueryResults({{2, 3}, {4, 5}}));
+  }
+
+  SECTION("Select a such that Follows(a, s1) and Parent(w, s1)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::FOLLOWS, ParamType::SYNONYM, "a",
+        ParamType::SYNONYM, "s1");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::PARENT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "s1");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {a});
+    REQUIRE(results == FinalQueryResults({{4}}));
+  }
+
+  SECTION("Select s1 such that Follows(s1, a) and Uses(a, \"x\")") {
+    // assignments never use x, so the domain of a becomes empty
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::FOLLOWS, ParamType::SYNONYM, "s1",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::USES_S, ParamType::SYNONYM, "a",
+        ParamType::NAME_LITERAL, "x");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {s1});
+    REQUIRE(results.empty());
+  }
+}
+
+TEST_CASE("QueryEvaluator: Boolean Groups Stop At First Result") {
+  // same procedure as the NextT cache test above
+  // 1: x = 1;
+  // 2: while (x == 1) {
+  // 3:   if (y == 2) then {
+  // 4:     y = 3; }
+  // 5:   else { z = 4; } }
+  // 6: if (z == 4) then {
+  // 7:   if (x == y) then {
+  // 8:     z = 3; }
+  // 9:   else { y = 4; } }
+  // 10: else { z = 6; }
+  // 11: while (z == 2) {
+  // 12:  while (y == 7) {
+  // 13:    z = x; } }
+  // 14: x = 5;
+  PKB* pkb = new PKB();
+  for (int i : {1, 4, 5, 8, 9, 10, 13, 14}) {
+    pkb->addStmt(DesignEntity::ASSIGN, i);
+  }
+  for (int i : {2, 11, 12}) {
+    pkb->addStmt(DesignEntity::WHILE, i);
+  }
+  for (int i : {3, 6, 7}) {
+    pkb->addStmt(DesignEntity::IF, i);
+  }
+  vector<pair<int, int>> nextPairs = {
+      {1, 2},   {2, 3},   {3, 4},   {3, 5},   {4, 2},   {5, 2},
+      {2, 6},   {6, 7},   {6, 10},  {10, 11}, {7, 8},   {7, 9},
+      {8, 11},  {9, 11},  {11, 12}, {12, 13}, {13, 12}, {12, 11},
+      {11, 14}};
+  for (const pair<int, int>& next : nextPairs) {
+    pkb->addRs(RelationshipType::NEXT, next.first, next.second);
+  }
+  vector<tuple<int, string, string>> assignments = {
+      {1, "x", "1"}, {4, "y", "3"},  {5, "z", "4"}, {8, "z", "3"},
+      {9, "y", "4"}, {10, "z", "6"}, {13, "z", "x"}, {14, "x", "5"}};
+  for (const auto& [stmt, var, expr] : assignments) {
+    pkb->addPatternRs(RelationshipType::PTT_ASSIGN_FULL_EXPR, stmt, var, expr);
+  }
+
+  unordered_map<string, DesignEntity> synonyms = {
+      {"s", DesignEntity::STATEMENT},
+      {"a", DesignEntity::ASSIGN},
+      {"a1", DesignEntity::ASSIGN},
+      {"v", DesignEntity::VARIABLE},
+      {"w", DesignEntity::WHILE},
+      {"ifs", DesignEntity::IF}};
+  vector<ConditionClause> conditionClauses = {};
+
+  SECTION("Select BOOLEAN such that Next*(ifs, w)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "ifs",
+        ParamType::SYNONYM, "w");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({TRUE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next*(s, _) and Next*(s, s)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s",
+        ParamType::WILDCARD, "_");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s",
+        ParamType::SYNONYM, "s");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({TRUE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next(w, a)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "a");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({TRUE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next(w, a) and Next(a, ifs)") {
+    // 13 and 14 are the only assignments after a while, and neither is
+    // followed by an if
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "a",
+        ParamType::SYNONYM, "ifs");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({FALSE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next(w, a) and Next(a, 12)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "a",
+        ParamType::INTEGER_LITERAL, "12");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({TRUE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next*(s, a) and Next*(a, s) pattern "
+          "a(\"z\", \"x\")") {
+    // 13 is the only assignment of z to x, and lies in the loop at 12
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "a",
+        ParamType::SYNONYM, "s");
+    TestQueryUtil::AddPatternClause(
+        conditionClauses, {DesignEntity::ASSIGN, "a"},
+        ParamType::NAME_LITERAL, "z", {MatchType::EXACT, "x"});
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({TRUE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next(w, a) pattern a(v, _) and "
+          "Next(ifs, a1) pattern a1(v, _)") {
+    // 13 after a while and 8, 10 after an if all assign z
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddPatternClause(
+        conditionClauses, {DesignEntity::ASSIGN, "a"}, ParamType::SYNONYM,
+        "v", {MatchType::ANY, "_"});
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "ifs",
+        ParamType::SYNONYM, "a1");
+    TestQueryUtil::AddPatternClause(
+        conditionClauses, {DesignEntity::ASSIGN, "a1"}, ParamType::SYNONYM,
+        "v", {MatchType::ANY, "_"});
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({TRUE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next(w, a) and Next(ifs, a1) with "
+          "a.stmt# = a1.stmt#") {
+    // 13 and 14 follow a while, while 4, 5, 8, 9 and 10 follow an if
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "ifs",
+        ParamType::SYNONYM, "a1");
+    TestQueryUtil::AddWithClause(conditionClauses,
+                                 ParamType::ATTRIBUTE_STMT_NUM, "a",
+                                 ParamType::ATTRIBUTE_STMT_NUM, "a1");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({FALSE_SELECT_BOOL_RESULT}));
+  }
+
+  SECTION("Select BOOLEAN such that Next(w, a) pattern a(\"y\", _)") {
+    // y is assigned at 4 and 9, neither of which follows a while
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddPatternClause(
+        conditionClauses, {DesignEntity::ASSIGN, "a"},
+        ParamType::NAME_LITERAL, "y", {MatchType::ANY, "_"});
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::BOOLEAN, synonyms, {});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({FALSE_SELECT_BOOL_RESULT}));
+  }
+}
+
+TEST_CASE("QueryEvaluator: Independent Groups Evaluated Concurrently") {
+  // 1 -> 2 -> 3 follow each other, 3 is a while with 4 and 5 nested in it
+  PKB* pkb = new PKB();
+  pkb->addStmt(DesignEntity::ASSIGN, 1);
+  pkb->addStmt(DesignEntity::ASSIGN, 2);
+  pkb->addStmt(DesignEntity::WHILE, 3);
+  pkb->addStmt(DesignEntity::ASSIGN, 4);
+  pkb->addStmt(DesignEntity::PRINT, 5);
+  pkb->addRs(RelationshipType::FOLLOWS, 1, 2);
+  pkb->addRs(RelationshipType::FOLLOWS, 2, 3);
+  pkb->addRs(RelationshipType::FOLLOWS, 4, 5);
+  pkb->addRs(RelationshipType::PARENT, 3, 4);
+  pkb->addRs(RelationshipType::PARENT, 3, 5);
+
+  unordered_map<string, DesignEntity> synonyms = {
+      {"s1", DesignEntity::STATEMENT},
+      {"s2", DesignEntity::STATEMENT},
+      {"a", DesignEntity::ASSIGN},
+      {"w", DesignEntity::WHILE},
+      {"pn", DesignEntity::PRINT}};
+  Synonym s1 = {DesignEntity::STATEMENT, "s1"};
+  Synonym w = {DesignEntity::WHILE, "w"};
+  vector<ConditionClause> conditionClauses = {};
+
+  // evaluates with a pool of the given size, where no threads means the
+  // groups are evaluated one after another
+  auto evaluateWithThreads = [&](int numThreads) {
+    SelectClause select = {{s1, w}, SelectType::SYNONYMS, conditionClauses};
+    QueryOptimizer optimizer(pkb);
+    optimizer.PreprocessClauses(synonyms, select);
+    ThreadPool threadPool(numThreads);
+    return QueryEvaluator(pkb, &optimizer, &threadPool)
+        .evaluateQuery(synonyms, select);
+  };
+
+  SECTION("Select <s1, w> such that Follows(s1, a) and Parent(w, pn)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::FOLLOWS, ParamType::SYNONYM, "s1",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::PARENT, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "pn");
+
+    FinalQueryResults results = evaluateWithThreads(2);
+    REQUIRE(results == FinalQueryResults({{1, 3}}));
+    REQUIRE(results == evaluateWithThreads(0));
+  }
+
+  SECTION("Select <s1, w> such that Follows(s1, s2) and Parent(pn, w)") {
+    // prints are never parents, so the second group cancels the first
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::FOLLOWS, ParamType::SYNONYM, "s1",
+        ParamType::SYNONYM, "s2");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::PARENT, ParamType::SYNONYM, "pn",
+        ParamType::SYNONYM, "w");
+
+    REQUIRE(evaluateWithThreads(2).empty());
+    REQUIRE(evaluateWithThreads(0).empty());
+  }
+
+  SECTION("Select <s1, w> such that Next*(s1, a) and Next*(w, pn)") {
+    // both groups read Next* off the on demand cache they share
+    for (const pair<int, int>& next :
+         vector<pair<int, int>>{{1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 3}}) {
+      pkb->addRs(RelationshipType::NEXT, next.first, next.second);
+    }
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s1",
+        ParamType::SYNONYM, "a");
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "w",
+        ParamType::SYNONYM, "pn");
+
+    FinalQueryResults results = evaluateWithThreads(2);
+    REQUIRE(results ==
+            FinalQueryResults({{1, 3}, {2, 3}, {3, 3}, {4, 3}, {5, 3}}));
+    REQUIRE(results == evaluateWithThreads(0));
+  }
+}
+
+TEST_CASE("QueryEvaluator: NextT Of Statements Bound By Previous Clauses") {
+  // the statements bound by Parent have their NextT computed together, which
+  // must give the same results as one traversal each
+  PKB* pkb = new PKB();
+  for (int i = 1; i <= 14; i++) {
+    pkb->addStmt(DesignEntity::STATEMENT, i);
+  }
+  // example procedure
+  // 1: x = 1;
+  // 2: while (x == 1) {
+  // 3:   if (y == 2) then {
+  // 4:     y = 3; }
+  // 5:   else { z = 4; } }
+  // 6: if (z == 4) then {
+  // 7:   if (x == y) then {
+  // 8:     z = 3; }
+  // 9:   else { y = 4; } }
+  // 10: else { z = 6; }
+  // 11: while (z == 2) {
+  // 12:  while (y == 7) {
+  // 13:    z = x; } }
+  // 14: x = 5;
+  vector<pair<int, int>> nextPairs = {
+      {1, 2}, {2, 3}, {3, 4}, {3, 5}, {4, 2}, {5, 2}, {2, 6},
+      {6, 7}, {6, 10}, {10, 11}, {7, 8}, {7, 9}, {8, 11}, {9, 11},
+      {11, 12}, {12, 13}, {13, 12}, {12, 11}, {11, 14}};
+  for (const auto& [stmt, nextStmt] : nextPairs) {
+    pkb->addRs(RelationshipType::NEXT, stmt, nextStmt);
+  }
+  vector<pair<int, int>> parentPairs = {{2, 3}, {3, 4}, {3, 5},
+                                        {6, 7}, {6, 10}, {7, 8},
+                                        {7, 9}, {11, 12}, {12, 13}};
+  for (const auto& [stmt, childStmt] : parentPairs) {
+    pkb->addRs(RelationshipType::PARENT, stmt, childStmt);
+  }
+
+  unordered_map<string, DesignEntity> synonyms = {
+      {"s1", DesignEntity::STATEMENT}, {"s2", DesignEntity::STATEMENT}};
+  Synonym s1 = {DesignEntity::STATEMENT, "s1"};
+  Synonym s2 = {DesignEntity::STATEMENT, "s2"};
+  vector<ConditionClause> conditionClauses = {};
+  TestQueryUtil::AddSuchThatClause(conditionClauses, RelationshipType::PARENT,
+                                   ParamType::SYNONYM, "s1", ParamType::SYNONYM,
+                                   "s2");
+
+  SECTION("Select s2 such that Parent(s1, s2) and NextT(s2, _)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s2",
+        ParamType::WILDCARD, "_");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {s2});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({3, 4, 5, 7, 8, 9, 10, 12, 13}));
+  }
+
+  SECTION("Select s2 such that Parent(s1, s2) and NextT(s2, 6)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s2",
+        ParamType::INTEGER_LITERAL, "6");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {s2});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({3, 4, 5}));
+  }
+
+  SECTION("Select s1 such that Parent(s1, s2) and NextT(8, s1)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::INTEGER_LITERAL,
+        "8", ParamType::SYNONYM, "s1");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {s1});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({11, 12}));
+  }
+
+  SECTION("Select s1 such that Parent(s1, s2) and NextT(s2, s1)") {
+    TestQueryUtil::AddSuchThatClause(
+        conditionClauses, RelationshipType::NEXT_T, ParamType::SYNONYM, "s2",
+        ParamType::SYNONYM, "s1");
+
+    FinalQueryResults results = TestQueryUtil::EvaluateQuery(
+        pkb, conditionClauses, SelectType::SYNONYMS, synonyms, {s1});
+    REQUIRE(TestQueryUtil::GetUniqueSelectSingleQEResults(results) ==
+            set<int>({2, 3, 11, 12}));
+  }
+}
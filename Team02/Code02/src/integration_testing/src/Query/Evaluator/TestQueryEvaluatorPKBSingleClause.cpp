@@ -3388,23 +3388,28 @@ TEST_CASE("QueryEvaluator: NextBip & NextBipT") {
   }
   // proc A {
   // 1: while (x != 0) {
-  // 2:   x = x - 1; }}
-  // proc B {
+  // 2:   x = x - 1; }
   // 3: if (x == 2) then {
   // 4:   read x; }
-  // 5: else { x = 3; } }
-  // proc C {
+  // 5: else { x = 3; }
   // 6: y = 2; }
 
   RelationshipType nextBipRsType = RelationshipType::NEXT_BIP;
   RelationshipType nextBipTRsType = RelationshipType::NEXT_BIP_T;
-  pkb->addRs(nextBipRsType, 1, 2);
-  pkb->addRs(nextBipRsType, 2, 1);
-  pkb->addRs(nextBipRsType, 1, 3);
-  pkb->addRs(nextBipRsType, 3, 4);
-  pkb->addRs(nextBipRsType, 3, 5);
-  pkb->addRs(nextBipRsType, 4, 6);
-  pkb->addRs(nextBipRsType, 5, 6);
+  // without calls, NextBip and Next coincide
+  for (RelationshipType rsType : {nextBipRsType, RelationshipType::NEXT}) {
+    pkb->addRs(rsType, 1, 2);
+    pkb->addRs(rsType, 2, 1);
+    pkb->addRs(rsType, 1, 3);
+    pkb->addRs(rsType, 3, 4);
+    pkb->addRs(rsType, 3, 5);
+    pkb->addRs(rsType, 4, 6);
+    pkb->addRs(rsType, 5, 6);
+  }
+  pkb->addFirstStmtOfProc("A", 1);
+  for (int i = 1; i <= 6; i++) {
+    pkb->addProcOfStmt("A", i);
+  }
 
   unordered_map<string, DesignEntity> synonyms = {
       {"s1", DesignEntity::STATEMENT}, {"s2", DesignEntity::STATEMENT}};
@@ -628,3 +628,89 @@ TEST_CASE("Groups are grouped and sorted in the correct order") {
     REQUIRE_FALSE(optimizer.GetNextGroupDetails().has_value());
   }
 }
+
+TEST_CASE("Clauses are ordered by estimated sizes of intermediate results") {
+  PKB* pkb = new PKB();
+  SynonymCountsTable emptyCountTable = {};
+  for (int i = 1; i <= 10; i++) {
+    pkb->addStmt(DesignEntity::ASSIGN, i);
+    pkb->addRs(RelationshipType::MODIFIES_S, i, TableType::VAR_TABLE,
+               i == 1 ? "x" : "v" + to_string(i));
+    for (int j = 1; j <= 10; j++) {
+      pkb->addRs(RelationshipType::NEXT, i, j);
+      if (i < j) {
+        pkb->addRs(RelationshipType::FOLLOWS_T, i, j);
+      }
+    }
+  }
+  pkb->computeStatistics();
+
+  SynonymMap synonymMap = {{"a", DesignEntity::STATEMENT},
+                           {"b", DesignEntity::STATEMENT},
+                           {"c", DesignEntity::STATEMENT}};
+  ConditionClause stFollowsTAB = TestQueryUtil::BuildSuchThatClause(
+      RelationshipType::FOLLOWS_T, ParamType::SYNONYM, "a", ParamType::SYNONYM,
+      "b");  // 45
+  ConditionClause stNextBC = TestQueryUtil::BuildSuchThatClause(
+      RelationshipType::NEXT, ParamType::SYNONYM, "b", ParamType::SYNONYM,
+      "c");  // 100
+  ConditionClause stModifiesC = TestQueryUtil::BuildSuchThatClause(
+      RelationshipType::MODIFIES_S, ParamType::SYNONYM, "c",
+      ParamType::NAME_LITERAL, "x");  // 1
+  vector<ConditionClause> givenClauses = {stFollowsTAB, stNextBC, stModifiesC};
+  SelectClause givenSelectClause = {{}, SelectType::BOOLEAN, givenClauses};
+
+  SECTION("Clause sizes are estimated from pkb statistics") {
+    QueryOptimizer optimizer(pkb);
+    optimizer.PreprocessClauses(synonymMap, givenSelectClause);
+    REQUIRE(optimizer.GetEstimatedSizeOfClause(stFollowsTAB) == 45);
+    REQUIRE(optimizer.GetEstimatedSizeOfClause(stNextBC) == 100);
+    REQUIRE(optimizer.GetEstimatedSizeOfClause(stModifiesC) == 1);
+  }
+
+  SECTION("Planned order avoids the cross product of the smallest clauses") {
+    QueryOptimizer optimizer(pkb);
+    optimizer.PreprocessClauses(synonymMap, givenSelectClause);
+    REQUIRE(optimizer.GetNextGroupDetails().has_value());
+    REQUIRE(optimizer.GetNextClause(emptyCountTable).value() == stModifiesC);
+    REQUIRE(optimizer.GetNextClause(emptyCountTable).value() == stNextBC);
+    REQUIRE(optimizer.GetNextClause(emptyCountTable).value() == stFollowsTAB);
+    REQUIRE_FALSE(optimizer.GetNextClause(emptyCountTable).has_value());
+  }
+
+  SECTION("Synonyms die after the last clause using them") {
+    QueryOptimizer optimizer(pkb);
+    optimizer.PreprocessClauses(synonymMap, givenSelectClause);
+    REQUIRE(optimizer.GetNextGroupDetails().has_value());
+    ConditionClause clause = optimizer.GetNextClause(emptyCountTable).value();
+    REQUIRE(optimizer.GetDeadSynonyms(clause).empty());
+    clause = optimizer.GetNextClause(emptyCountTable).value();
+    REQUIRE(optimizer.GetDeadSynonyms(clause) == vector<SynName>({"c"}));
+    clause = optimizer.GetNextClause(emptyCountTable).value();
+    REQUIRE(optimizer.GetDeadSynonyms(clause) == vector<SynName>({"a", "b"}));
+  }
+
+  SECTION("Selected synonyms never die") {
+    SelectClause selectA = {{{DesignEntity::STATEMENT, "a", false, {}}},
+                            SelectType::SYNONYMS,
+                            givenClauses};
+    QueryOptimizer optimizer(pkb);
+    optimizer.PreprocessClauses(synonymMap, selectA);
+    REQUIRE(optimizer.GetNextGroupDetails().has_value());
+    optimizer.GetNextClause(emptyCountTable);
+    optimizer.GetNextClause(emptyCountTable);
+    ConditionClause clause = optimizer.GetNextClause(emptyCountTable).value();
+    REQUIRE(clause == stFollowsTAB);
+    REQUIRE(optimizer.GetDeadSynonyms(clause) == vector<SynName>({"b"}));
+  }
+
+  SECTION("Groups above the planned size are ordered greedily") {
+    QueryOptimizer optimizer(pkb, 2);
+    optimizer.PreprocessClauses(synonymMap, givenSelectClause);
+    REQUIRE(optimizer.GetNextGroupDetails().has_value());
+    REQUIRE(optimizer.GetNextClause(emptyCountTable).value() == stModifiesC);
+    REQUIRE(optimizer.GetNextClause(emptyCountTable).value() == stFollowsTAB);
+    REQUIRE(optimizer.GetNextClause(emptyCountTable).value() == stNextBC);
+    REQUIRE_FALSE(optimizer.GetNextClause(emptyCountTable).has_value());
+  }
+}
@@ -0,0 +1,140 @@
+#include "IntervalSet.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+IntervalSet::IntervalSet(const unordered_set<int>& values) {
+  vector<int> sortedValues(values.begin(), values.end());
+  sort(sortedValues.begin(), sortedValues.end());
+  for (int value : sortedValues) {
+    appendInterval(value, value);
+  }
+}
+
+void IntervalSet::insert(int value) { insertInterval(value, value); }
+
+void IntervalSet::insertInterval(int start, int end) {
+  if (start > end) {
+    return;
+  }
+  if (intervals.empty() || start >= intervals.back().first) {
+    appendInterval(start, end);
+    return;
+  }
+  IntervalSet interval;
+  interval.appendInterval(start, end);
+  *this = unionWith(interval);
+}
+
+void IntervalSet::appendInterval(int start, int end) {
+  if (!intervals.empty() && start <= intervals.back().second + 1) {
+    if (end > intervals.back().second) {
+      numValues += end - intervals.back().second;
+      intervals.back().second = end;
+    }
+    return;
+  }
+  intervals.push_back({start, end});
+  numValues += end - start + 1;
+}
+
+bool IntervalSet::contains(int value) const {
+  // the first interval ending at or after the value is the only one that
+  // may hold it
+  auto it = lower_bound(intervals.begin(), intervals.end(), value,
+                        [](const Interval& interval, int value) {
+                          return interval.second < value;
+                        });
+  return it != intervals.end() && it->first <= value;
+}
+
+bool IntervalSet::empty() const { return intervals.empty(); }
+
+int IntervalSet::size() const { return numValues; }
+
+const vector<IntervalSet::Interval>& IntervalSet::getIntervals() const {
+  return intervals;
+}
+
+unordered_set<int> IntervalSet::toSet() const {
+  unordered_set<int> values;
+  values.reserve(numValues);
+  for (const auto& [start, end] : intervals) {
+    for (int value = start; value <= end; value++) {
+      values.insert(value);
+    }
+  }
+  return values;
+}
+
+IntervalSet IntervalSet::unionWith(const IntervalSet& other) const {
+  IntervalSet result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < intervals.size() || j < other.intervals.size()) {
+    if (j == other.intervals.size() ||
+        (i < intervals.size() &&
+         intervals[i].first <= other.intervals[j].first)) {
+      result.appendInterval(intervals[i].first, intervals[i].second);
+      i++;
+    } else {
+      result.appendInterval(other.intervals[j].first,
+                            other.intervals[j].second);
+      j++;
+    }
+  }
+  return result;
+}
+
+IntervalSet IntervalSet::intersectWith(const IntervalSet& other) const {
+  IntervalSet result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < intervals.size() && j < other.intervals.size()) {
+    int start = max(intervals[i].first, other.intervals[j].first);
+    int end = min(intervals[i].second, other.intervals[j].second);
+    if (start <= end) {
+      result.appendInterval(start, end);
+    }
+    // the interval ending first cannot overlap any later one of the other
+    if (intervals[i].second < other.intervals[j].second) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+  return result;
+}
+
+IntervalSet IntervalSet::differenceWith(const IntervalSet& other) const {
+  IntervalSet result;
+  size_t j = 0;
+  for (const auto& [start, end] : intervals) {
+    int remainingStart = start;
+    while (j < other.intervals.size() && other.intervals[j].second < start) {
+      j++;
+    }
+    // intervals of the other set covering part of this one cut it apart,
+    // and the last of them may cover the next one too
+    size_t k = j;
+    while (k < other.intervals.size() && other.intervals[k].first <= end) {
+      if (other.intervals[k].first > remainingStart) {
+        result.appendInterval(remainingStart, other.intervals[k].first - 1);
+      }
+      remainingStart = max(remainingStart, other.intervals[k].second + 1);
+      k++;
+    }
+    if (remainingStart <= end) {
+      result.appendInterval(remainingStart, end);
+    }
+  }
+  return result;
+}
+
+bool IntervalSet::operator==(const IntervalSet& other) const {
+  return intervals == other.intervals;
+}
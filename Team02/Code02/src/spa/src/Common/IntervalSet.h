@@ -0,0 +1,39 @@
+#pragma once
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// A set of ints stored as sorted closed intervals, no two of which overlap or
+// touch. Statements reached along the control flow of a procedure are mostly
+// a few runs of consecutive numbers, each kept here as a single pair.
+class IntervalSet {
+ public:
+  typedef std::pair<int, int> Interval;
+
+  IntervalSet() = default;
+  explicit IntervalSet(const std::unordered_set<int>& values);
+
+  // values inserted in increasing order are appended in constant time
+  void insert(int value);
+  void insertInterval(int start, int end);
+
+  bool contains(int value) const;
+  bool empty() const;
+  // number of values, not of intervals
+  int size() const;
+  const std::vector<Interval>& getIntervals() const;
+  std::unordered_set<int> toSet() const;
+
+  IntervalSet unionWith(const IntervalSet& other) const;
+  IntervalSet intersectWith(const IntervalSet& other) const;
+  IntervalSet differenceWith(const IntervalSet& other) const;
+  bool operator==(const IntervalSet& other) const;
+
+ private:
+  std::vector<Interval> intervals;
+  int numValues = 0;
+
+  // appends an interval starting at or after the start of the last one
+  void appendInterval(int start, int end);
+};
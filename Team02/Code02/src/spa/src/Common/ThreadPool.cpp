@@ -0,0 +1,96 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int numThreads) {
+  for (int i = 0; i < numThreads; i++) {
+    workers.emplace_back(&ThreadPool::runWorker, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<mutex> lock(tasksMutex);
+    isStopping = true;
+  }
+  hasTasksOrStopping.notify_all();
+  for (thread& worker : workers) {
+    worker.join();
+  }
+}
+
+future<void> ThreadPool::submit(function<void()> task) {
+  packaged_task<void()> packagedTask(move(task));
+  future<void> result = packagedTask.get_future();
+  {
+    lock_guard<mutex> lock(tasksMutex);
+    tasks.push(move(packagedTask));
+  }
+  hasTasksOrStopping.notify_one();
+  return result;
+}
+
+void ThreadPool::wait(vector<future<void>>* futures) {
+  for (future<void>& result : *futures) {
+    while (result.wait_for(chrono::seconds(0)) != future_status::ready) {
+      // a task still queued may be the one being waited on
+      if (!runPendingTask()) {
+        result.wait();
+      }
+    }
+  }
+  // rethrows exceptions of the tasks
+  for (future<void>& result : *futures) {
+    result.get();
+  }
+}
+
+int ThreadPool::getNumThreads() { return workers.size(); }
+
+ThreadPool& ThreadPool::getSharedPool() {
+  // never destroyed, so that workers outlive the static destructors run when
+  // a task exits the program
+  static ThreadPool* sharedPool =
+      new ThreadPool(max(1u, thread::hardware_concurrency()));
+  return *sharedPool;
+}
+
+void ThreadPool::runWorker() {
+  while (true) {
+    packaged_task<void()> task;
+    {
+      unique_lock<mutex> lock(tasksMutex);
+      hasTasksOrStopping.wait(lock,
+                              [this] { return isStopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
+
+bool ThreadPool::runPendingTask() {
+  packaged_task<void()> task;
+  {
+    lock_guard<mutex> lock(tasksMutex);
+    if (tasks.empty()) {
+      return false;
+    }
+    task = move(tasks.front());
+    tasks.pop();
+  }
+  task();
+  return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running submitted tasks in submission order.
+// Threads waiting on tasks help run pending ones, so tasks may submit and
+// wait on further tasks without exhausting the workers.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int numThreads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::future<void> submit(std::function<void()> task);
+  void wait(std::vector<std::future<void>>* futures);
+  int getNumThreads();
+
+  // one worker per hardware thread, shared by all queries
+  static ThreadPool& getSharedPool();
+
+ private:
+  std::vector<std::thread> workers;
+  std::queue<std::packaged_task<void()>> tasks;
+  std::mutex tasksMutex;
+  std::condition_variable hasTasksOrStopping;
+  bool isStopping = false;
+
+  void runWorker();
+  bool runPendingTask();
+};
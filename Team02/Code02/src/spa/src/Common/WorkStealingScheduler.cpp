@@ -0,0 +1,93 @@
+#include "WorkStealingScheduler.h"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+WorkStealingScheduler::WorkStealingScheduler(ThreadPool* threadPool,
+                                             int numWorkers) {
+  this->threadPool = threadPool;
+  this->numWorkers = max(1, numWorkers);
+}
+
+void WorkStealingScheduler::run(int numTasks,
+                                const function<void(int, int)>& runTask) {
+  int numUsedWorkers = min(numWorkers, numTasks);
+  if (numUsedWorkers <= 1) {
+    for (int task = 0; task < numTasks; task++) {
+      runTask(task, 0);
+    }
+    return;
+  }
+
+  // contiguous ranges keep neighbouring tasks, which tend to cost the same,
+  // on the same worker
+  vector<WorkerQueue> queues(numUsedWorkers);
+  for (int task = 0; task < numTasks; task++) {
+    int worker = static_cast<long long>(task) * numUsedWorkers / numTasks;
+    queues[worker].tasks.push_back(task);
+  }
+
+  vector<future<void>> workerFutures;
+  for (int worker = 1; worker < numUsedWorkers; worker++) {
+    workerFutures.push_back(threadPool->submit(
+        [worker, &queues, &runTask] { runWorker(worker, &queues, runTask); }));
+  }
+  runWorker(0, &queues, runTask);
+  threadPool->wait(&workerFutures);
+}
+
+int WorkStealingScheduler::getNumWorkers() { return numWorkers; }
+
+WorkStealingScheduler& WorkStealingScheduler::getSharedScheduler() {
+  static WorkStealingScheduler sharedScheduler(
+      &ThreadPool::getSharedPool(),
+      ThreadPool::getSharedPool().getNumThreads());
+  return sharedScheduler;
+}
+
+void WorkStealingScheduler::runWorker(
+    int worker, vector<WorkerQueue>* queues,
+    const function<void(int, int)>& runTask) {
+  int numQueues = queues->size();
+  int task;
+  while (true) {
+    if (popOwnTask(&(*queues)[worker], &task)) {
+      runTask(task, worker);
+      continue;
+    }
+    // tasks never add tasks, so once every queue is empty all are taken
+    bool hasStolen = false;
+    for (int i = 1; i < numQueues && !hasStolen; i++) {
+      hasStolen = stealTask(&(*queues)[(worker + i) % numQueues], &task);
+    }
+    if (!hasStolen) {
+      return;
+    }
+    runTask(task, worker);
+  }
+}
+
+bool WorkStealingScheduler::popOwnTask(WorkerQueue* queue, int* task) {
+  lock_guard<mutex> lock(queue->mutex);
+  if (queue->tasks.empty()) {
+    return false;
+  }
+  *task = queue->tasks.back();
+  queue->tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingScheduler::stealTask(WorkerQueue* queue, int* task) {
+  lock_guard<mutex> lock(queue->mutex);
+  if (queue->tasks.empty()) {
+    return false;
+  }
+  *task = queue->tasks.front();
+  queue->tasks.pop_front();
+  return true;
+}
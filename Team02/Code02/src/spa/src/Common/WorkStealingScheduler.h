@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Common/ThreadPool.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Runs a batch of independent tasks on a fixed number of workers, the calling
+// thread being one of them. Tasks start split evenly between the workers, and
+// a worker that runs out takes tasks from the front of the others' queues, so
+// uneven tasks still keep every worker busy.
+class WorkStealingScheduler {
+ public:
+  WorkStealingScheduler(ThreadPool* threadPool, int numWorkers);
+
+  // calls runTask(task, worker) once for every task in [0, numTasks), where
+  // worker in [0, getNumWorkers()) identifies the worker running it
+  void run(int numTasks, const std::function<void(int, int)>& runTask);
+  int getNumWorkers();
+
+  // one worker per thread of the shared pool
+  static WorkStealingScheduler& getSharedScheduler();
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<int> tasks;
+  };
+
+  ThreadPool* threadPool;
+  int numWorkers;
+
+  static void runWorker(int worker, std::vector<WorkerQueue>* queues,
+                        const std::function<void(int, int)>& runTask);
+  static bool popOwnTask(WorkerQueue* queue, int* task);
+  static bool stealTask(WorkerQueue* queue, int* task);
+};
@@ -43,6 +43,7 @@ void DesignExtractor::Extract(const ProgramAST* programAST) {
 
   vector<ProcName> topoProcs =
       GetTopoSortedProcs(callGraph, reverseCallGraph, allProcs);
+  pkb->addTopoSortedProcs(topoProcs);
 
   ExtractCallsTrans(reverseCallGraph, topoProcs, allProcs);
 
@@ -50,7 +51,11 @@ void DesignExtractor::Extract(const ProgramAST* programAST) {
   ExtractModifies(programAST);
 
   ExtractNext(programAST);
-  ExtractNextBip(programAST, topoProcs);
+  ExtractStmtRanges(programAST);
+  ExtractDominators(programAST);
+  ExtractNextBip(programAST);
+
+  pkb->freeze();
 }
 
 unordered_set<Name> DesignExtractor::ExtractProcAndStmt(
@@ -63,14 +68,15 @@ unordered_set<Name> DesignExtractor::ExtractProcAndStmt(
     allProcs.insert(procedure->ProcName);
     pkb->insertAt(TableType::PROC_TABLE, procedure->ProcName);
 
-    ExtractProcAndStmtHelper(procedure->StmtList);
+    ExtractProcAndStmtHelper(procedure->StmtList, procedure->ProcName);
   }
   return allProcs;
 }
 
 void DesignExtractor::ExtractProcAndStmtHelper(
-    const vector<StmtAST*> stmtList) {
+    const vector<StmtAST*> stmtList, ProcName procName) {
   for (auto stmt : stmtList) {
+    pkb->addProcOfStmt(procName, stmt->StmtNo);
     if (dynamic_cast<const ReadStmtAST*>(stmt)) {
       pkb->addStmt(DesignEntity::READ, stmt->StmtNo);
     } else if (dynamic_cast<const PrintStmtAST*>(stmt)) {
@@ -80,12 +86,12 @@ void DesignExtractor::ExtractProcAndStmtHelper(
     } else if (auto whileStmt = dynamic_cast<const WhileStmtAST*>(stmt)) {
       pkb->addStmt(DesignEntity::WHILE, stmt->StmtNo);
 
-      ExtractProcAndStmtHelper(whileStmt->StmtList);
+      ExtractProcAndStmtHelper(whileStmt->StmtList, procName);
     } else if (auto ifStmt = dynamic_cast<const IfStmtAST*>(stmt)) {
       pkb->addStmt(DesignEntity::IF, stmt->StmtNo);
 
-      ExtractProcAndStmtHelper(ifStmt->ThenBlock);
-      ExtractProcAndStmtHelper(ifStmt->ElseBlock);
+      ExtractProcAndStmtHelper(ifStmt->ThenBlock, procName);
+      ExtractProcAndStmtHelper(ifStmt->ElseBlock, procName);
     } else if (dynamic_cast<const AssignStmtAST*>(stmt)) {
       pkb->addStmt(DesignEntity::ASSIGN, stmt->StmtNo);
     } else {
@@ -709,136 +715,163 @@ void DesignExtractor::ExtractNextHelper(const vector<StmtAST*> stmtList,
   }
 }
 
-void DesignExtractor::ExtractNextBip(const ProgramAST* programAST,
-                                     vector<ProcName> topoProcs) {
-  unordered_map<Name, StmtNo> procNameToItsFirstStmt;
-  for (auto procedure : programAST->ProcedureList) {
-    procNameToItsFirstStmt[procedure->ProcName] =
-        procedure->StmtList[0]->StmtNo;
-  }
-
-  unordered_map<ProcName, const ProcedureAST*> procNameToProc;
+void DesignExtractor::ExtractStmtRanges(const ProgramAST* programAST) {
   for (auto procedure : programAST->ProcedureList) {
-    procNameToProc[procedure->ProcName] = procedure;
+    StmtNo lastStmt = ExtractStmtRangesHelper(procedure->StmtList);
+    pkb->addProcRange(procedure->ProcName, procedure->StmtList.front()->StmtNo,
+                      lastStmt);
   }
+}
 
-  // for storing callee's procName to the last stmts in this call path
-  unordered_map<ProcName, unordered_set<StmtNo>> lastStmtsOfCallPath;
-
-  reverse(topoProcs.begin(), topoProcs.end());
-
-  for (auto procName : topoProcs) {
-    ExtractNextBipHelper(procNameToProc[procName]->StmtList, -1, -1, procName,
-                         procNameToItsFirstStmt, &lastStmtsOfCallPath, true);
+// returns the last stmt in stmtList, nested stmts included
+StmtNo DesignExtractor::ExtractStmtRangesHelper(
+    const vector<StmtAST*> stmtList) {
+  StmtNo lastStmt = -1;
+  for (auto stmt : stmtList) {
+    lastStmt = stmt->StmtNo;
+    if (auto whileStmt = dynamic_cast<const WhileStmtAST*>(stmt)) {
+      lastStmt = ExtractStmtRangesHelper(whileStmt->StmtList);
+      pkb->addWhileRange(stmt->StmtNo, lastStmt);
+    } else if (auto ifStmt = dynamic_cast<const IfStmtAST*>(stmt)) {
+      StmtNo lastStmtInThen = ExtractStmtRangesHelper(ifStmt->ThenBlock);
+      lastStmt = ExtractStmtRangesHelper(ifStmt->ElseBlock);
+      pkb->addIfRanges(stmt->StmtNo, lastStmtInThen, lastStmt);
+    }
   }
+  return lastStmt;
 }
 
-void DesignExtractor::ExtractNextBipHelper(
-    const std::vector<StmtAST*> stmtList, StmtNo prevStmt,
-    StmtNo nextStmtForLastStmt, ProcName currProcName,
-    const unordered_map<Name, StmtNo>& procNameToItsFirstStmt,
-    unordered_map<ProcName, unordered_set<StmtNo>>* lastStmtsOfCallPath,
-    bool isAtProcLevel) {
-  auto addNextBip = [this](StmtNo s1, StmtNo s2) {
-    if (s1 == -1 || s2 == -1) return;
-    pkb->addRs(RelationshipType::NEXT_BIP, s1, s2);
-  };
-  auto getNextStmtNoAfterCurrIdx = [stmtList](size_t i) {
-    if (i + 1 < stmtList.size()) {
-      return stmtList[i + 1]->StmtNo;
+void DesignExtractor::ExtractDominators(const ProgramAST* programAST) {
+  for (auto procedure : programAST->ProcedureList) {
+    // statements of a procedure are numbered consecutively, so each is a
+    // node numbered from the first statement
+    pair<StmtNo, StmtNo> procRange = pkb->getProcRange(
+        pkb->getIndexOf(TableType::PROC_TABLE, procedure->ProcName));
+    StmtNo firstStmt = procRange.first;
+    StmtNo lastStmt = procRange.second;
+    if (firstStmt == -1) {
+      continue;
     }
-    return -1;
-  };
-
-  for (size_t i = 0; i < stmtList.size(); ++i) {
-    auto stmt = stmtList[i];
-
-    addNextBip(prevStmt, stmt->StmtNo);
-
-    if (dynamic_cast<const ReadStmtAST*>(stmt) ||
-        dynamic_cast<const PrintStmtAST*>(stmt) ||
-        dynamic_cast<const AssignStmtAST*>(stmt)) {
-      prevStmt = stmt->StmtNo;
-
-    } else if (auto whileStmt = dynamic_cast<const WhileStmtAST*>(stmt)) {
-      ExtractNextBipHelper(whileStmt->StmtList, stmt->StmtNo, stmt->StmtNo,
-                           currProcName, procNameToItsFirstStmt,
-                           lastStmtsOfCallPath, false);
-      prevStmt = stmt->StmtNo;
-
-    } else if (auto callStmt = dynamic_cast<const CallStmtAST*>(stmt)) {
-      auto nextStmtAfterCall = getNextStmtNoAfterCurrIdx(i);
-      auto callee = callStmt->ProcName;
-      auto firstStmtInCallee = procNameToItsFirstStmt.at(callee);
-      auto lastStmtsInThisCallPath = lastStmtsOfCallPath->at(callee);
-
-      addNextBip(callStmt->StmtNo, firstStmtInCallee);
-
-      for (auto lastStmt : lastStmtsInThisCallPath) {
-        addNextBip(lastStmt, nextStmtAfterCall);
-      }
-
-      prevStmt = -1;
-
-    } else if (auto ifStmt = dynamic_cast<const IfStmtAST*>(stmt)) {
-      StmtNo nextStmtAfterIf = getNextStmtNoAfterCurrIdx(i);
-
-      if (nextStmtAfterIf != -1) {
-        // skip extraction if this stmt is the last stmt in current stmtList,
-        // let the next block of code handles it, for better performance
-        ExtractNextBipHelper(ifStmt->ThenBlock, ifStmt->StmtNo, nextStmtAfterIf,
-                             currProcName, procNameToItsFirstStmt,
-                             lastStmtsOfCallPath, false);
-        ExtractNextBipHelper(ifStmt->ElseBlock, ifStmt->StmtNo, nextStmtAfterIf,
-                             currProcName, procNameToItsFirstStmt,
-                             lastStmtsOfCallPath, false);
+    int numStmts = lastStmt - firstStmt + 1;
+    vector<vector<int>> successors(numStmts);
+    // post-dominators are dominators of the reversed CFG, from a node after
+    // every statement leaving the procedure
+    vector<vector<int>> predecessors(numStmts + 1);
+    for (StmtNo stmt = firstStmt; stmt <= lastStmt; stmt++) {
+      for (StmtNo nextStmt : pkb->getRight(RelationshipType::NEXT, stmt)) {
+        successors[stmt - firstStmt].push_back(nextStmt - firstStmt);
+        predecessors[nextStmt - firstStmt].push_back(stmt - firstStmt);
       }
+    }
+    for (StmtNo exitStmt : GetExitStmts(procedure->StmtList)) {
+      predecessors[numStmts].push_back(exitStmt - firstStmt);
+    }
 
-      prevStmt = -1;  // because there's no Next r/s between the current if
-                      // stmt and the next stmt in the current stmtList
-
-    } else {
-      DMOprintErrMsgAndExit(
-          "[DE][ExtractNextBipHelper][for loop] shouldn't reach "
-          "here.");
-      return;
+    vector<int> dominators = GetImmediateDominators(successors, 0);
+    vector<int> postDominators =
+        GetImmediateDominators(predecessors, numStmts);
+    // the first statement and the node after the exits are the roots
+    auto getStmt = [firstStmt, numStmts](int node) {
+      return node == -1 || node == numStmts ? -1 : firstStmt + node;
+    };
+    for (int node = 0; node < numStmts; node++) {
+      pkb->addImmediateDominator(firstStmt + node, getStmt(dominators[node]));
+      pkb->addImmediatePostDominator(firstStmt + node,
+                                     getStmt(postDominators[node]));
     }
   }
+}
 
-  // settle last stmt in curr stmtList
-  auto stmt = stmtList[stmtList.size() - 1];
-  if (dynamic_cast<const ReadStmtAST*>(stmt) ||
-      dynamic_cast<const PrintStmtAST*>(stmt) ||
-      dynamic_cast<const AssignStmtAST*>(stmt) ||
-      dynamic_cast<const WhileStmtAST*>(stmt)) {
-    addNextBip(stmt->StmtNo, nextStmtForLastStmt);
+// returns the stmts control may leave stmtList from
+vector<StmtNo> DesignExtractor::GetExitStmts(const vector<StmtAST*> stmtList) {
+  auto stmt = stmtList.back();
+  if (auto ifStmt = dynamic_cast<const IfStmtAST*>(stmt)) {
+    vector<StmtNo> exitStmts = GetExitStmts(ifStmt->ThenBlock);
+    vector<StmtNo> elseExitStmts = GetExitStmts(ifStmt->ElseBlock);
+    exitStmts.insert(exitStmts.end(), elseExitStmts.begin(),
+                     elseExitStmts.end());
+    return exitStmts;
+  }
+  return {stmt->StmtNo};
+}
 
-    if (isAtProcLevel)
-      (*lastStmtsOfCallPath)[currProcName].insert(stmt->StmtNo);
+// immediate dominators of the nodes of a graph by the iterative algorithm of
+// Cooper, Harvey and Kennedy, -1 for the root and nodes it does not reach
+vector<int> DesignExtractor::GetImmediateDominators(
+    const vector<vector<int>>& successors, int root) {
+  int numNodes = successors.size();
+  vector<int> postorder;
+  vector<int> postNumbers(numNodes, -1);
+  vector<bool> isVisited(numNodes, false);
+  vector<pair<int, int>> nodeStack = {{root, 0}};
+  isVisited[root] = true;
+  while (!nodeStack.empty()) {
+    auto& [node, nextSuccessor] = nodeStack.back();
+    if (nextSuccessor == successors[node].size()) {
+      postNumbers[node] = postorder.size();
+      postorder.push_back(node);
+      nodeStack.pop_back();
+      continue;
+    }
+    int successor = successors[node][nextSuccessor++];
+    if (!isVisited[successor]) {
+      isVisited[successor] = true;
+      nodeStack.push_back({successor, 0});
+    }
+  }
+  vector<vector<int>> predecessors(numNodes);
+  for (int node = 0; node < numNodes; node++) {
+    for (int successor : successors[node]) {
+      predecessors[successor].push_back(node);
+    }
+  }
 
-  } else if (auto ifStmt = dynamic_cast<const IfStmtAST*>(stmt)) {
-    ExtractNextBipHelper(ifStmt->ThenBlock, ifStmt->StmtNo, nextStmtForLastStmt,
-                         currProcName, procNameToItsFirstStmt,
-                         lastStmtsOfCallPath, isAtProcLevel);
-    ExtractNextBipHelper(ifStmt->ElseBlock, ifStmt->StmtNo, nextStmtForLastStmt,
-                         currProcName, procNameToItsFirstStmt,
-                         lastStmtsOfCallPath, isAtProcLevel);
-  } else if (auto callStmt = dynamic_cast<const CallStmtAST*>(stmt)) {
-    ProcName callee = callStmt->ProcName;
-
-    for (auto lastStmt : (*lastStmtsOfCallPath)[callee]) {
-      addNextBip(lastStmt, nextStmtForLastStmt);
-    }
-
-    if (isAtProcLevel) {
-      for (auto lastStmt : (*lastStmtsOfCallPath)[callee]) {
-        (*lastStmtsOfCallPath)[currProcName].insert(lastStmt);
+  // climbs from both nodes to their nearest common dominator
+  vector<int> dominators(numNodes, -1);
+  auto intersect = [&](int left, int right) {
+    while (left != right) {
+      while (postNumbers[left] < postNumbers[right]) {
+        left = dominators[left];
+      }
+      while (postNumbers[right] < postNumbers[left]) {
+        right = dominators[right];
+      }
+    }
+    return left;
+  };
+  dominators[root] = root;
+  int numReachedNodes = postorder.size();
+  bool isChanged = true;
+  while (isChanged) {
+    isChanged = false;
+    // in reverse postorder, the root being last in postorder
+    for (int i = numReachedNodes - 2; i >= 0; i--) {
+      int node = postorder[i];
+      int newDominator = -1;
+      for (int predecessor : predecessors[node]) {
+        if (dominators[predecessor] == -1) {
+          continue;
+        }
+        newDominator = newDominator == -1
+                           ? predecessor
+                           : intersect(predecessor, newDominator);
+      }
+      if (dominators[node] != newDominator) {
+        dominators[node] = newDominator;
+        isChanged = true;
       }
     }
+  }
+  dominators[root] = -1;
+  return dominators;
+}
 
-  } else {
-    DMOprintErrMsgAndExit(
-        "[DE][ExtractNextBipHelper][last stmt] shouldn't reach here.");
-    return;
+void DesignExtractor::ExtractNextBip(const ProgramAST* programAST) {
+  // NextBip is derived from Next and the calls in the pkb, which only needs
+  // the stmts each procedure returns from
+  for (auto procedure : programAST->ProcedureList) {
+    for (StmtNo exitStmt : GetExitStmts(procedure->StmtList)) {
+      pkb->addExitStmtOfProc(procedure->ProcName, exitStmt);
+    }
   }
 }
@@ -22,7 +22,7 @@ class DesignExtractor {
   PKB* pkb;
 
   std::unordered_set<Name> ExtractProcAndStmt(const ProgramAST*);
-  void ExtractProcAndStmtHelper(const std::vector<StmtAST*>);
+  void ExtractProcAndStmtHelper(const std::vector<StmtAST*>, ProcName);
 
   void ExtractUses(const ProgramAST*);
   std::unordered_set<StmtNoNamePair, StmtNoNamePairHash> ExtractUsesHelper(
@@ -66,9 +66,13 @@ class DesignExtractor {
   void ExtractNext(const ProgramAST*);
   void ExtractNextHelper(const std::vector<StmtAST*>, StmtNo, StmtNo);
 
-  void ExtractNextBip(const ProgramAST*, std::vector<ProcName>);
-  void ExtractNextBipHelper(
-      const std::vector<StmtAST*>, StmtNo, StmtNo, ProcName,
-      const std::unordered_map<Name, StmtNo>&,
-      std::unordered_map<ProcName, std::unordered_set<StmtNo>>*, bool);
+  void ExtractStmtRanges(const ProgramAST*);
+  StmtNo ExtractStmtRangesHelper(const std::vector<StmtAST*>);
+
+  void ExtractDominators(const ProgramAST*);
+  std::vector<StmtNo> GetExitStmts(const std::vector<StmtAST*>);
+  std::vector<int> GetImmediateDominators(
+      const std::vector<std::vector<int>>&, int);
+
+  void ExtractNextBip(const ProgramAST*);
 };
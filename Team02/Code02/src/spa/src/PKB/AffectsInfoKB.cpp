@@ -1,5 +1,9 @@
 #include "AffectsInfoKB.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "Common/Global.h"
 
 using namespace std;
@@ -30,6 +34,33 @@ void AffectsInfoKB::addProcCallEdge(ProcName callerProcName,
   callGraph[callerProcIdx].insert(calleeProcIdx);
 }
 
+void AffectsInfoKB::addTopoSortedProcs(vector<ProcName> topoSortedProcNames) {
+  topoSortedProcs.clear();
+  for (const ProcName& procName : topoSortedProcNames) {
+    topoSortedProcs.push_back(procTable->insert(procName));
+  }
+}
+
+void AffectsInfoKB::addProcOfStmt(ProcName procName, StmtNo stmt) {
+  if (stmt < 0) {
+    return;
+  }
+  ProcIdx procIdx = procTable->insert(procName);
+  if (stmt >= tableOfStmtProcs.size()) {
+    tableOfStmtProcs.resize(stmt + 1, -1);
+  }
+  tableOfStmtProcs[stmt] = procIdx;
+
+  if (procIdx >= tableOfProcRanges.size()) {
+    tableOfProcRanges.resize(procIdx + 1, {-1, -1});
+  }
+  pair<StmtNo, StmtNo>& range = tableOfProcRanges[procIdx];
+  if (range.first == -1 || stmt < range.first) {
+    range.first = stmt;
+  }
+  range.second = max(range.second, stmt);
+}
+
 // QE Methods
 StmtNo AffectsInfoKB::getNextStmtForIfStmt(StmtNo ifStmt) {
   if (tableOfNextStmtForIfStmts.count(ifStmt) != 0) {
@@ -49,3 +80,36 @@ vector<StmtNo> AffectsInfoKB::getFirstStmtOfAllProcs() {
 unordered_map<ProcIdx, unordered_set<ProcIdx>> AffectsInfoKB::getCallGraph() {
   return callGraph;
 }
+
+StmtNo AffectsInfoKB::getFirstStmtOfProc(ProcIdx procIdx) {
+  if (tableOfProcFirstStmts.count(procIdx) != 0) {
+    return tableOfProcFirstStmts.at(procIdx);
+  }
+  return -1;
+}
+
+vector<ProcIdx> AffectsInfoKB::getTopoSortedProcs() {
+  if (!topoSortedProcs.empty()) {
+    return topoSortedProcs;
+  }
+  // no order was given, so every procedure with statements in any order
+  vector<ProcIdx> results;
+  for (auto procToFirstStmt : tableOfProcFirstStmts) {
+    results.push_back(procToFirstStmt.first);
+  }
+  return results;
+}
+
+ProcIdx AffectsInfoKB::getProcOfStmt(StmtNo stmt) {
+  if (stmt >= 0 && stmt < tableOfStmtProcs.size()) {
+    return tableOfStmtProcs[stmt];
+  }
+  return -1;
+}
+
+pair<StmtNo, StmtNo> AffectsInfoKB::getProcRange(ProcIdx procIdx) {
+  if (procIdx >= 0 && procIdx < tableOfProcRanges.size()) {
+    return tableOfProcRanges[procIdx];
+  }
+  return {-1, -1};
+}
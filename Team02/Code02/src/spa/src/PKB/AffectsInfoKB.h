@@ -6,6 +6,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 class AffectsInfoKB {
@@ -17,15 +18,27 @@ class AffectsInfoKB {
   void addNextStmtForIfStmt(StmtNo ifStmt, StmtNo nextStmtForIfStmt);
   void addFirstStmtOfProc(ProcName procName, StmtNo firstStmtOfProc);
   void addProcCallEdge(ProcName callerProcName, ProcName calleeProcName);
+  void addTopoSortedProcs(std::vector<ProcName> topoSortedProcNames);
+  void addProcOfStmt(ProcName procName, StmtNo stmt);
 
   // Methods for QE
   StmtNo getNextStmtForIfStmt(StmtNo ifStmt);
   std::vector<StmtNo> getFirstStmtOfAllProcs();
   std::unordered_map<ProcIdx, std::unordered_set<ProcIdx>> getCallGraph();
+  StmtNo getFirstStmtOfProc(ProcIdx procIdx);
+  // callers before callees
+  std::vector<ProcIdx> getTopoSortedProcs();
+  ProcIdx getProcOfStmt(StmtNo stmt);
+  // first and last stmts of the procedure, {-1, -1} if it has none
+  std::pair<StmtNo, StmtNo> getProcRange(ProcIdx procIdx);
 
  private:
   Table* procTable;
   std::unordered_map<ProcIdx, StmtNo> tableOfProcFirstStmts;
   std::unordered_map<StmtNo, StmtNo> tableOfNextStmtForIfStmts;
   std::unordered_map<ProcIdx, std::unordered_set<ProcIdx>> callGraph;
+  std::vector<ProcIdx> topoSortedProcs;
+  // both indexed directly, by stmt and by procedure
+  std::vector<ProcIdx> tableOfStmtProcs;
+  std::vector<std::pair<StmtNo, StmtNo>> tableOfProcRanges;
 };
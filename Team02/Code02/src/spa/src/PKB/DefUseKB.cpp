@@ -0,0 +1,219 @@
+#include "DefUseKB.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+vector<VarIdx> getSortedVars(const unordered_map<int, SetOfInts>& table,
+                             StmtNo stmt) {
+  auto it = table.find(stmt);
+  if (it == table.end()) {
+    return {};
+  }
+  vector<VarIdx> vars(it->second.begin(), it->second.end());
+  sort(vars.begin(), vars.end());
+  return vars;
+}
+
+// PKB Methods
+void DefUseKB::computeIndex(
+    const SetOfStmts& assignStmts, const SetOfStmts& readStmts,
+    const SetOfStmts& callStmts,
+    const unordered_map<int, SetOfInts>& tableOfNext,
+    const unordered_map<int, SetOfInts>& tableOfModifies,
+    const unordered_map<int, SetOfInts>& tableOfUses,
+    DominatorKB* dominatorKB, DominatorKB* postDominatorKB) {
+  StmtNo maxStmt = 0;
+  for (StmtNo stmt : assignStmts) {
+    maxStmt = max(maxStmt, stmt);
+  }
+  for (const auto& [stmt, nextStmts] : tableOfNext) {
+    maxStmt = max(maxStmt, stmt);
+    for (StmtNo nextStmt : nextStmts) {
+      maxStmt = max(maxStmt, nextStmt);
+    }
+  }
+  vector<vector<StmtNo>> successors(maxStmt + 1);
+  for (const auto& [stmt, nextStmts] : tableOfNext) {
+    for (StmtNo nextStmt : nextStmts) {
+      if (stmt >= 0 && nextStmt >= 0) {
+        successors[stmt].push_back(nextStmt);
+      }
+    }
+  }
+
+  // only assignments, reads and calls kill a definition. containers modify
+  // what their nested statements do, which are walked themselves.
+  vector<vector<VarIdx>> killedVars(maxStmt + 1);
+  for (const SetOfStmts* stmts : {&assignStmts, &readStmts, &callStmts}) {
+    for (StmtNo stmt : *stmts) {
+      if (stmt >= 0 && stmt <= maxStmt) {
+        killedVars[stmt] = getSortedVars(tableOfModifies, stmt);
+      }
+    }
+  }
+  vector<bool> isAssign(maxStmt + 1, false);
+  vector<vector<VarIdx>> usedVars(maxStmt + 1);
+  for (StmtNo stmt : assignStmts) {
+    if (stmt >= 0) {
+      isAssign[stmt] = true;
+      usedVars[stmt] = getSortedVars(tableOfUses, stmt);
+    }
+  }
+  auto hasVar = [](const vector<VarIdx>& vars, VarIdx varIdx) {
+    return binary_search(vars.begin(), vars.end(), varIdx);
+  };
+
+  // a kill of the variable dominating a use but not the definition, or
+  // post-dominating the definition but not the use, lies on every path
+  // between them. only the nearest kill up either tree need be checked, as
+  // those above it dominate whatever it does.
+  bool isPruned = dominatorKB->hasTree() && postDominatorKB->hasTree();
+  for (StmtNo stmt : assignStmts) {
+    isPruned = isPruned && dominatorKB->isDominator(stmt, stmt) &&
+               postDominatorKB->isDominator(stmt, stmt);
+  }
+  auto getNearestKill = [&](DominatorKB* tree, StmtNo stmt, VarIdx varIdx) {
+    for (StmtNo dominator = tree->getImmediateDominator(stmt);
+         dominator != -1; dominator = tree->getImmediateDominator(dominator)) {
+      if (dominator <= maxStmt && hasVar(killedVars[dominator], varIdx)) {
+        return dominator;
+      }
+    }
+    return -1;
+  };
+  auto getRoot = [&](StmtNo stmt) {
+    while (dominatorKB->getImmediateDominator(stmt) != -1) {
+      stmt = dominatorKB->getImmediateDominator(stmt);
+    }
+    return stmt;
+  };
+  // uses of each variable by the procedure, with the nearest kill
+  // dominating each
+  unordered_map<StmtNo, unordered_map<VarIdx, vector<pair<StmtNo, StmtNo>>>>
+      usesInProcs;
+  if (isPruned) {
+    for (StmtNo stmt : assignStmts) {
+      StmtNo root = getRoot(stmt);
+      for (VarIdx varIdx : usedVars[stmt]) {
+        usesInProcs[root][varIdx].push_back(
+            {stmt, getNearestKill(dominatorKB, stmt, varIdx)});
+      }
+    }
+  }
+
+  // a search from each definition over the one variable it defines, marking
+  // statements with the number of the search that reached them
+  vector<vector<StmtNo>> rows(maxStmt + 1);
+  vector<int> searchOfStmt(maxStmt + 1, -1);
+  int searchNo = 0;
+  vector<StmtNo> stmtStack;
+  for (StmtNo def = 0; def <= maxStmt; def++) {
+    if (!isAssign[def]) {
+      continue;
+    }
+    for (VarIdx varIdx : killedVars[def]) {
+      // the search stops once it has found every use not cut off from the
+      // definition, and is skipped if there are none
+      int numReachableUses = -1;
+      if (isPruned) {
+        numReachableUses = 0;
+        StmtNo postDominatingKill =
+            getNearestKill(postDominatorKB, def, varIdx);
+        for (const auto& [use, dominatingKill] :
+             usesInProcs[getRoot(def)][varIdx]) {
+          bool isCutOff =
+              (dominatingKill != -1 &&
+               !dominatorKB->isDominator(dominatingKill, def)) ||
+              (postDominatingKill != -1 &&
+               !postDominatorKB->isDominator(postDominatingKill, use));
+          if (!isCutOff) {
+            numReachableUses++;
+          }
+        }
+      }
+      int numFoundUses = 0;
+      if (numReachableUses != 0) {
+        stmtStack.push_back(def);
+      }
+      while (!stmtStack.empty()) {
+        StmtNo stmt = stmtStack.back();
+        stmtStack.pop_back();
+        for (StmtNo nextStmt : successors[stmt]) {
+          if (searchOfStmt[nextStmt] == searchNo) {
+            continue;
+          }
+          searchOfStmt[nextStmt] = searchNo;
+          if (isAssign[nextStmt] && hasVar(usedVars[nextStmt], varIdx)) {
+            rows[def].push_back(nextStmt);
+            numFoundUses++;
+          }
+          if (numFoundUses == numReachableUses) {
+            stmtStack.clear();
+            break;
+          }
+          if (!hasVar(killedVars[nextStmt], varIdx)) {
+            stmtStack.push_back(nextStmt);
+          }
+        }
+      }
+      searchNo++;
+    }
+    sort(rows[def].begin(), rows[def].end());
+    rows[def].erase(unique(rows[def].begin(), rows[def].end()),
+                    rows[def].end());
+  }
+
+  affectsOffsets.assign(maxStmt + 2, 0);
+  affectsInvOffsets.assign(maxStmt + 2, 0);
+  for (StmtNo stmt = 0; stmt <= maxStmt; stmt++) {
+    affectsOffsets[stmt + 1] = affectsOffsets[stmt] + rows[stmt].size();
+    for (StmtNo affectedStmt : rows[stmt]) {
+      affectsInvOffsets[affectedStmt + 1]++;
+    }
+  }
+  for (StmtNo stmt = 0; stmt <= maxStmt; stmt++) {
+    affectsInvOffsets[stmt + 1] += affectsInvOffsets[stmt];
+  }
+  affectsStmts.clear();
+  affectsStmts.reserve(affectsOffsets.back());
+  affectsInvStmts.assign(affectsInvOffsets.back(), 0);
+  // taking definitions in increasing order leaves inverse rows sorted too
+  vector<int> invRowEnds(affectsInvOffsets.begin(),
+                         affectsInvOffsets.end() - 1);
+  for (StmtNo stmt = 0; stmt <= maxStmt; stmt++) {
+    for (StmtNo affectedStmt : rows[stmt]) {
+      affectsStmts.push_back(affectedStmt);
+      affectsInvStmts[invRowEnds[affectedStmt]++] = stmt;
+    }
+  }
+}
+
+// QE Methods
+bool DefUseKB::isInIndex(StmtNo stmt) {
+  return stmt >= 0 && stmt + 1 < affectsOffsets.size();
+}
+
+bool DefUseKB::isAffects(StmtNo a1, StmtNo a2) {
+  if (!isInIndex(a1)) {
+    return false;
+  }
+  return binary_search(affectsStmts.begin() + affectsOffsets[a1],
+                       affectsStmts.begin() + affectsOffsets[a1 + 1], a2);
+}
+
+unordered_set<StmtNo> DefUseKB::getAffects(StmtNo stmt, bool isForward) {
+  if (!isInIndex(stmt)) {
+    return {};
+  }
+  const vector<int>& offsets = isForward ? affectsOffsets : affectsInvOffsets;
+  const vector<StmtNo>& stmts = isForward ? affectsStmts : affectsInvStmts;
+  return unordered_set<StmtNo>(stmts.begin() + offsets[stmt],
+                               stmts.begin() + offsets[stmt + 1]);
+}
+
+int DefUseKB::getNumAffects() { return affectsStmts.size(); }
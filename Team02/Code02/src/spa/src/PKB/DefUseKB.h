@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Common/Common.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "DominatorKB.h"
+
+enum class DefUseIndexMode {
+  // built by the first read of Affects
+  LAZY,
+  // built when the pkb is frozen, for queries mostly of Affects
+  EAGER,
+  // Affects is always searched on demand
+  NONE
+};
+
+// Affects of every assignment, the assignments using the variable it defines
+// before any path modifies it again, and the reverse. Each direction is kept
+// as offsets into one array of rows sorted by statement.
+class DefUseKB {
+ public:
+  // Methods for PKB
+  // the searches are pruned by the dominator trees when every assignment is
+  // in them
+  void computeIndex(const SetOfStmts& assignStmts, const SetOfStmts& readStmts,
+                    const SetOfStmts& callStmts,
+                    const std::unordered_map<int, SetOfInts>& tableOfNext,
+                    const std::unordered_map<int, SetOfInts>& tableOfModifies,
+                    const std::unordered_map<int, SetOfInts>& tableOfUses,
+                    DominatorKB* dominatorKB, DominatorKB* postDominatorKB);
+
+  // Methods for QE
+  bool isAffects(StmtNo a1, StmtNo a2);
+  // Affects of the statement, or its inverse if not isForward
+  std::unordered_set<StmtNo> getAffects(StmtNo stmt, bool isForward);
+  int getNumAffects();
+
+ private:
+  // row of statement s is [offsets[s], offsets[s + 1]) of stmts
+  std::vector<int> affectsOffsets;
+  std::vector<StmtNo> affectsStmts;
+  std::vector<int> affectsInvOffsets;
+  std::vector<StmtNo> affectsInvStmts;
+
+  bool isInIndex(StmtNo stmt);
+};
@@ -0,0 +1,78 @@
+#include "DominatorKB.h"
+
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// DE Methods
+void DominatorKB::addImmediateDominator(StmtNo stmt, StmtNo dominator) {
+  if (stmt < 0) {
+    return;
+  }
+  if (stmt >= immediateDominators.size()) {
+    immediateDominators.resize(stmt + 1, -1);
+    isAdded.resize(stmt + 1, false);
+  }
+  immediateDominators[stmt] = dominator;
+  isAdded[stmt] = true;
+}
+
+// PKB Methods
+void DominatorKB::computeIndex() {
+  int numStmts = immediateDominators.size();
+  vector<vector<StmtNo>> children(numStmts);
+  vector<StmtNo> roots;
+  for (StmtNo stmt = 0; stmt < numStmts; stmt++) {
+    if (!isAdded[stmt]) {
+      continue;
+    }
+    StmtNo dominator = immediateDominators[stmt];
+    if (dominator >= 0 && dominator < numStmts && isAdded[dominator]) {
+      children[dominator].push_back(stmt);
+    } else {
+      roots.push_back(stmt);
+    }
+  }
+
+  // numbered in preorder with an explicit stack of (stmt, next child), so
+  // long chains of statements cannot overflow the call stack
+  firstNumbers.assign(numStmts, -1);
+  lastNumbers.assign(numStmts, -1);
+  int number = 0;
+  vector<pair<StmtNo, int>> stmtStack;
+  for (StmtNo root : roots) {
+    firstNumbers[root] = number++;
+    stmtStack.push_back({root, 0});
+    while (!stmtStack.empty()) {
+      auto& [stmt, nextChild] = stmtStack.back();
+      if (nextChild == children[stmt].size()) {
+        lastNumbers[stmt] = number - 1;
+        stmtStack.pop_back();
+        continue;
+      }
+      StmtNo child = children[stmt][nextChild++];
+      firstNumbers[child] = number++;
+      stmtStack.push_back({child, 0});
+    }
+  }
+}
+
+// QE Methods
+bool DominatorKB::hasTree() { return !firstNumbers.empty(); }
+
+bool DominatorKB::isInTree(StmtNo stmt) {
+  return stmt >= 0 && stmt < firstNumbers.size() && firstNumbers[stmt] != -1;
+}
+
+StmtNo DominatorKB::getImmediateDominator(StmtNo stmt) {
+  return isInTree(stmt) ? immediateDominators[stmt] : -1;
+}
+
+bool DominatorKB::isDominator(StmtNo dominator, StmtNo stmt) {
+  if (!isInTree(dominator) || !isInTree(stmt)) {
+    return false;
+  }
+  return firstNumbers[dominator] <= firstNumbers[stmt] &&
+         firstNumbers[stmt] <= lastNumbers[dominator];
+}
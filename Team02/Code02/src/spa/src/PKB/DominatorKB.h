@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Common/Common.h>
+
+#include <vector>
+
+// A dominator or post-dominator tree of the CFG of every procedure, kept as
+// the immediate dominator of each statement. Statements are numbered by a
+// depth first walk of the trees, so that a statement dominates exactly the
+// statements numbered within its interval.
+class DominatorKB {
+ public:
+  // Methods for DE
+  // dominator is -1 for the root of a procedure's tree
+  void addImmediateDominator(StmtNo stmt, StmtNo dominator);
+
+  // Methods for PKB
+  // called after the dominators are added, before any of the methods below
+  void computeIndex();
+
+  // Methods for QE
+  bool hasTree();
+  // -1 for roots and statements not in any tree
+  StmtNo getImmediateDominator(StmtNo stmt);
+  // every statement dominates itself, false for statements not in any tree
+  bool isDominator(StmtNo dominator, StmtNo stmt);
+
+ private:
+  std::vector<StmtNo> immediateDominators;
+  std::vector<bool> isAdded;
+  // [first, last] numbers of the subtree of each statement, -1 if absent
+  std::vector<int> firstNumbers;
+  std::vector<int> lastNumbers;
+
+  bool isInTree(StmtNo stmt);
+};
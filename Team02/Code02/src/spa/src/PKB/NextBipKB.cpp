@@ -0,0 +1,147 @@
+#include "NextBipKB.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+const unordered_set<StmtNo> NO_STMTS = {};
+const vector<StmtNo> NO_STMT_LIST = {};
+
+// DE Methods
+void NextBipKB::addExitStmt(ProcIdx procIdx, StmtNo exitStmt) {
+  exitStmtsOfProcs[procIdx].push_back(exitStmt);
+  procOfExitStmts[exitStmt] = procIdx;
+}
+
+// PKB Methods
+void NextBipKB::computeIndex(
+    const unordered_map<int, SetOfInts>& nextTable,
+    const unordered_map<int, SetOfInts>& callsTable,
+    const unordered_map<ProcIdx, StmtNo>& firstStmts) {
+  calleeOfCalls.clear();
+  callsOfProcs.clear();
+  for (const auto& [callStmt, callees] : callsTable) {
+    if (callees.empty()) {
+      continue;
+    }
+    calleeOfCalls[callStmt] = *callees.begin();
+    callsOfProcs[*callees.begin()].push_back(callStmt);
+  }
+  firstStmtOfProcs = firstStmts;
+  procOfFirstStmts.clear();
+  for (const auto& [procIdx, firstStmt] : firstStmts) {
+    procOfFirstStmts[firstStmt] = procIdx;
+  }
+
+  returnStmtsOfProcs.clear();
+  lastStmtsOfProcs.clear();
+  for (const auto& [procIdx, exitStmts] : exitStmtsOfProcs) {
+    computeReturnStmts(procIdx, nextTable);
+    computeLastStmts(procIdx);
+  }
+  for (const auto& [procIdx, callStmts] : callsOfProcs) {
+    computeLastStmts(procIdx);
+  }
+}
+
+const unordered_set<StmtNo>& NextBipKB::computeReturnStmts(
+    ProcIdx procIdx, const unordered_map<int, SetOfInts>& nextTable) {
+  auto [returnIt, isNew] = returnStmtsOfProcs.try_emplace(procIdx);
+  if (!isNew) {
+    return returnIt->second;
+  }
+  // a call at the end of its procedure returns wherever that one does
+  unordered_set<StmtNo> returnStmts;
+  auto callsIt = callsOfProcs.find(procIdx);
+  const vector<StmtNo>& callStmts =
+      callsIt == callsOfProcs.end() ? NO_STMT_LIST : callsIt->second;
+  for (StmtNo callStmt : callStmts) {
+    auto nextIt = nextTable.find(callStmt);
+    if (nextIt != nextTable.end() && !nextIt->second.empty()) {
+      returnStmts.insert(nextIt->second.begin(), nextIt->second.end());
+      continue;
+    }
+    auto callerIt = procOfExitStmts.find(callStmt);
+    if (callerIt != procOfExitStmts.end()) {
+      const unordered_set<StmtNo>& callerReturnStmts =
+          computeReturnStmts(callerIt->second, nextTable);
+      returnStmts.insert(callerReturnStmts.begin(), callerReturnStmts.end());
+    }
+  }
+  returnIt->second = returnStmts;
+  return returnIt->second;
+}
+
+const unordered_set<StmtNo>& NextBipKB::computeLastStmts(ProcIdx procIdx) {
+  auto [lastIt, isNew] = lastStmtsOfProcs.try_emplace(procIdx);
+  if (!isNew) {
+    return lastIt->second;
+  }
+  unordered_set<StmtNo> lastStmts;
+  auto exitsIt = exitStmtsOfProcs.find(procIdx);
+  const vector<StmtNo>& exitStmts =
+      exitsIt == exitStmtsOfProcs.end() ? NO_STMT_LIST : exitsIt->second;
+  for (StmtNo exitStmt : exitStmts) {
+    auto calleeIt = calleeOfCalls.find(exitStmt);
+    if (calleeIt == calleeOfCalls.end()) {
+      lastStmts.insert(exitStmt);
+      continue;
+    }
+    const unordered_set<StmtNo>& calleeLastStmts =
+        computeLastStmts(calleeIt->second);
+    lastStmts.insert(calleeLastStmts.begin(), calleeLastStmts.end());
+  }
+  lastIt->second = lastStmts;
+  return lastIt->second;
+}
+
+// QE Methods
+bool NextBipKB::hasExitStmts() { return !exitStmtsOfProcs.empty(); }
+
+unordered_set<StmtNo> NextBipKB::getNextBipStmts(StmtNo stmt, bool isForward,
+                                                 const SetOfStmts& nextStmts) {
+  unordered_set<StmtNo> results;
+  if (isForward) {
+    auto calleeIt = calleeOfCalls.find(stmt);
+    if (calleeIt != calleeOfCalls.end()) {
+      auto firstIt = firstStmtOfProcs.find(calleeIt->second);
+      if (firstIt != firstStmtOfProcs.end()) {
+        results.insert(firstIt->second);
+      }
+      return results;
+    }
+    results = nextStmts;
+    auto procIt = procOfExitStmts.find(stmt);
+    if (procIt != procOfExitStmts.end()) {
+      auto returnIt = returnStmtsOfProcs.find(procIt->second);
+      const unordered_set<StmtNo>& returnStmts =
+          returnIt == returnStmtsOfProcs.end() ? NO_STMTS : returnIt->second;
+      results.insert(returnStmts.begin(), returnStmts.end());
+    }
+    return results;
+  }
+
+  // a call before the statement is returned to from the last statements of
+  // its callee, and the first statement is entered from every call
+  for (StmtNo prevStmt : nextStmts) {
+    auto calleeIt = calleeOfCalls.find(prevStmt);
+    if (calleeIt == calleeOfCalls.end()) {
+      results.insert(prevStmt);
+      continue;
+    }
+    auto lastIt = lastStmtsOfProcs.find(calleeIt->second);
+    if (lastIt != lastStmtsOfProcs.end()) {
+      results.insert(lastIt->second.begin(), lastIt->second.end());
+    }
+  }
+  auto procIt = procOfFirstStmts.find(stmt);
+  if (procIt != procOfFirstStmts.end()) {
+    auto callsIt = callsOfProcs.find(procIt->second);
+    if (callsIt != callsOfProcs.end()) {
+      results.insert(callsIt->second.begin(), callsIt->second.end());
+    }
+  }
+  return results;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Common/Common.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// NextBip is Next, except that a call leads to the first statement of its
+// callee, and the exits of a procedure lead to the statements after each call
+// of it. Rather than pairing every exit with every call site, each procedure
+// keeps the statements its exits return to and the exits returning through
+// it, and rows are read off these together with Next.
+class NextBipKB {
+ public:
+  // Methods for DE
+  // statements control leaves the procedure from, calls at its end included
+  void addExitStmt(ProcIdx procIdx, StmtNo exitStmt);
+
+  // Methods for PKB
+  // called after the exits are added, before any of the methods below
+  void computeIndex(const std::unordered_map<int, SetOfInts>& nextTable,
+                    const std::unordered_map<int, SetOfInts>& callsTable,
+                    const std::unordered_map<ProcIdx, StmtNo>& firstStmts);
+
+  // Methods for QE
+  bool hasExitStmts();
+  // NextBip of the statement given its Next, or the inverse of both if not
+  // isForward
+  std::unordered_set<StmtNo> getNextBipStmts(StmtNo stmt, bool isForward,
+                                             const SetOfStmts& nextStmts);
+
+ private:
+  std::unordered_map<ProcIdx, std::vector<StmtNo>> exitStmtsOfProcs;
+  std::unordered_map<StmtNo, ProcIdx> procOfExitStmts;
+
+  std::unordered_map<StmtNo, ProcIdx> calleeOfCalls;
+  std::unordered_map<ProcIdx, std::vector<StmtNo>> callsOfProcs;
+  std::unordered_map<ProcIdx, StmtNo> firstStmtOfProcs;
+  std::unordered_map<StmtNo, ProcIdx> procOfFirstStmts;
+  // statements after the calls the procedure returns to, and the exits that
+  // are not calls returning through it, through calls at its end included
+  std::unordered_map<ProcIdx, std::unordered_set<StmtNo>> returnStmtsOfProcs;
+  std::unordered_map<ProcIdx, std::unordered_set<StmtNo>> lastStmtsOfProcs;
+
+  const std::unordered_set<StmtNo>& computeReturnStmts(
+      ProcIdx procIdx, const std::unordered_map<int, SetOfInts>& nextTable);
+  const std::unordered_set<StmtNo>& computeLastStmts(ProcIdx procIdx);
+};
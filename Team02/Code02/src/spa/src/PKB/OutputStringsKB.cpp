@@ -0,0 +1,114 @@
+#include "OutputStringsKB.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// PKB Methods
+void OutputStringsKB::computeOutputStrings(
+    Table* varTable, Table* procTable, Table* constTable,
+    const TablesRs& tablesRs,
+    const unordered_map<DesignEntity, SetOfStmts>& tableOfStmts) {
+  pool.clear();
+  unordered_map<string, pair<int, int>> internedStrings;
+  auto intern = [this, &internedStrings](const string& value) {
+    auto it = internedStrings.find(value);
+    if (it != internedStrings.end()) {
+      return it->second;
+    }
+    pair<int, int> span = {static_cast<int>(pool.size()),
+                           static_cast<int>(value.size())};
+    pool += value;
+    internedStrings[value] = span;
+    return span;
+  };
+
+  auto internTable = [&intern](Table* table,
+                               vector<pair<int, int>>* strings) {
+    strings->assign(table->getSize(), {0, 0});
+    for (int i = 0; i < table->getSize(); i++) {
+      (*strings)[i] = intern(table->getElement(i));
+    }
+  };
+  internTable(varTable, &varStrings);
+  internTable(procTable, &procStrings);
+  internTable(constTable, &constStrings);
+
+  stmtStrings.clear();
+  nameAttributeStrings.clear();
+  auto stmtsIt = tableOfStmts.find(DesignEntity::STATEMENT);
+  if (stmtsIt == tableOfStmts.end()) {
+    return;
+  }
+  StmtNo maxStmt = 0;
+  for (StmtNo stmt : stmtsIt->second) {
+    maxStmt = max(maxStmt, stmt);
+  }
+  stmtStrings.assign(maxStmt + 1, {0, 0});
+  nameAttributeStrings.assign(maxStmt + 1, {0, 0});
+  for (StmtNo stmt : stmtsIt->second) {
+    stmtStrings[stmt] = intern(to_string(stmt));
+  }
+
+  // each call, read and print has exactly one name attribute
+  auto internNameAttributes = [&](DesignEntity entity, RelationshipType rs,
+                                  Table* table) {
+    auto entityIt = tableOfStmts.find(entity);
+    auto rsIt = tablesRs.find(rs);
+    if (entityIt == tableOfStmts.end() || rsIt == tablesRs.end()) {
+      return;
+    }
+    for (StmtNo stmt : entityIt->second) {
+      auto namesIt = rsIt->second.find(stmt);
+      if (namesIt == rsIt->second.end() || namesIt->second.empty()) {
+        continue;
+      }
+      nameAttributeStrings[stmt] =
+          intern(table->getElement(*namesIt->second.begin()));
+    }
+  };
+  internNameAttributes(DesignEntity::CALL, RelationshipType::CALLS_S,
+                       procTable);
+  internNameAttributes(DesignEntity::READ, RelationshipType::MODIFIES_S,
+                       varTable);
+  internNameAttributes(DesignEntity::PRINT, RelationshipType::USES_S,
+                       varTable);
+}
+
+// QP Methods
+string_view OutputStringsKB::getElementString(TableType type,
+                                              TableElemIdx index) {
+  switch (type) {
+    case TableType::VAR_TABLE:
+      return getString(varStrings, index);
+    case TableType::PROC_TABLE:
+      return getString(procStrings, index);
+    case TableType::CONST_TABLE:
+      return getString(constStrings, index);
+    default:
+      return {};
+  }
+}
+
+string_view OutputStringsKB::getStmtString(StmtNo stmt) {
+  return getString(stmtStrings, stmt);
+}
+
+string_view OutputStringsKB::getNameAttributeString(StmtNo stmt) {
+  return getString(nameAttributeStrings, stmt);
+}
+
+string_view OutputStringsKB::getString(const vector<pair<int, int>>& strings,
+                                       int index) {
+  if (index < 0 || index >= strings.size()) {
+    return {};
+  }
+  // views are made on access as the pool moves when the pkb is copied
+  return string_view(pool.data() + strings[index].first,
+                     strings[index].second);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Common/Common.h>
+#include <PKB/Table.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class OutputStringsKB {
+ public:
+  // Methods for PKB
+  void computeOutputStrings(
+      Table* varTable, Table* procTable, Table* constTable,
+      const TablesRs& tablesRs,
+      const std::unordered_map<DesignEntity, SetOfStmts>& tableOfStmts);
+
+  // Methods for QP, empty for values that were not in the pkb when computed
+  std::string_view getElementString(TableType type, TableElemIdx index);
+  std::string_view getStmtString(StmtNo stmt);
+  // procName of a call, varName of a read or print
+  std::string_view getNameAttributeString(StmtNo stmt);
+
+ private:
+  // every distinct string is stored once in the pool, and the tables below
+  // hold the (offset, length) of a value's string in the pool
+  std::string pool;
+  std::vector<std::pair<int, int>> varStrings;
+  std::vector<std::pair<int, int>> procStrings;
+  std::vector<std::pair<int, int>> constStrings;
+  std::vector<std::pair<int, int>> stmtStrings;
+  std::vector<std::pair<int, int>> nameAttributeStrings;
+
+  std::string_view getString(const std::vector<std::pair<int, int>>& strings,
+                             int index);
+};
@@ -1,7 +1,10 @@
 #include "PKB.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -10,12 +13,44 @@ void PKB::addStmt(DesignEntity de, StmtNo s) {
   tableOfStmts[DesignEntity::STATEMENT].insert(s);
   tableOfStmts[DesignEntity::PROG_LINE].insert(s);
   tableOfStmts[de].insert(s);
+  isStatisticsStale = true;
+  isOutputStringsStale = true;
+  isDefUseStale = true;
 }
 
-SetOfStmts PKB::getAllStmts(DesignEntity de) { return tableOfStmts[de]; }
+// reads never insert missing keys, so that queries may read concurrently
+const SetOfStmts EMPTY_STMTS = {};
+const SetOfStmtLists EMPTY_STMT_LISTS = {};
+const unordered_map<int, SetOfInts> EMPTY_TABLE_RS = {};
+
+const SetOfStmts& getStmtsOf(const TableOfStmts& tableOfStmts,
+                             DesignEntity de) {
+  auto it = tableOfStmts.find(de);
+  return it == tableOfStmts.end() ? EMPTY_STMTS : it->second;
+}
+
+const unordered_map<int, SetOfInts>& getTableRs(const TablesRs& tables,
+                                                RelationshipType rs) {
+  auto it = tables.find(rs);
+  return it == tables.end() ? EMPTY_TABLE_RS : it->second;
+}
+
+const unordered_set<int>& getValue(const TablesRs& tables, RelationshipType rs,
+                                   int key) {
+  auto tableIt = tables.find(rs);
+  if (tableIt == tables.end()) {
+    return EMPTY_STMTS;
+  }
+  auto valuesIt = tableIt->second.find(key);
+  return valuesIt == tableIt->second.end() ? EMPTY_STMTS : valuesIt->second;
+}
+
+SetOfStmts PKB::getAllStmts(DesignEntity de) {
+  return getStmtsOf(tableOfStmts, de);
+}
 
 bool PKB::isStmt(DesignEntity de, StmtNo s) {
-  return tableOfStmts[de].find(s) != tableOfStmts[de].end();
+  return getStmtsOf(tableOfStmts, de).count(s) > 0;
 }
 
 int PKB::getNumEntity(DesignEntity de) {
@@ -28,7 +63,7 @@ int PKB::getNumEntity(DesignEntity de) {
     case DesignEntity::IF:
     case DesignEntity::ASSIGN:
     case DesignEntity::PROG_LINE:
-      return tableOfStmts[de].size();
+      return getStmtsOf(tableOfStmts, de).size();
     case DesignEntity::VARIABLE:
       return tables.at(TableType::VAR_TABLE).getSize();
     case DesignEntity::CONSTANT:
@@ -63,6 +98,19 @@ void PKB::addRs(RelationshipType rs, int left, int right) {
   insertToTableRs(&tablesRs, rs, left, right);
   insertToTableRs(&invTablesRs, rs, right, left);
   insertToMappings(&mappingsRs, rs, left, right);
+  isStatisticsStale = true;
+  isOutputStringsStale = true;
+  if (rs == RelationshipType::NEXT) {
+    isReachabilityStale = true;
+  }
+  if (rs == RelationshipType::NEXT || rs == RelationshipType::CALLS_S) {
+    isNextBipStale = true;
+    isNextBipMappingsStale = true;
+  }
+  if (rs == RelationshipType::NEXT || rs == RelationshipType::MODIFIES_S ||
+      rs == RelationshipType::USES_S) {
+    isDefUseStale = true;
+  }
 }
 
 void PKB::addRs(RelationshipType rs, int left, TableType rightType,
@@ -79,7 +127,10 @@ void PKB::addRs(RelationshipType rs, TableType leftType, string left,
 }
 
 bool PKB::isRs(RelationshipType rs, int left, int right) {
-  return getRight(rs, left).count(right) > 0;
+  if (isDerivedNextBip(rs)) {
+    return getDerivedNextBip(left, true).count(right) > 0;
+  }
+  return getValue(tablesRs, rs, left).count(right) > 0;
 }
 
 bool PKB::isRs(RelationshipType rs, int left, TableType rightType,
@@ -95,12 +146,11 @@ bool PKB::isRs(RelationshipType rs, TableType leftType, string left,
   return isRs(rs, leftIndex, rightIndex);
 }
 
-unordered_set<int> getValue(TablesRs* tables, RelationshipType rs, int key) {
-  return (*tables)[rs][key];
-}
-
 bool PKB::hasRight(RelationshipType rs, int left) {
-  return !tablesRs[rs][left].empty();
+  if (isDerivedNextBip(rs)) {
+    return !getDerivedNextBip(left, true).empty();
+  }
+  return !getValue(tablesRs, rs, left).empty();
 }
 
 bool PKB::hasRight(RelationshipType rs, TableType leftType, std::string left) {
@@ -109,7 +159,10 @@ bool PKB::hasRight(RelationshipType rs, TableType leftType, std::string left) {
 }
 
 unordered_set<int> PKB::getRight(RelationshipType rs, int left) {
-  return tablesRs[rs][left];
+  if (isDerivedNextBip(rs)) {
+    return getDerivedNextBip(left, true);
+  }
+  return getValue(tablesRs, rs, left);
 }
 
 unordered_set<int> PKB::getRight(RelationshipType rs, TableType leftType,
@@ -119,7 +172,10 @@ unordered_set<int> PKB::getRight(RelationshipType rs, TableType leftType,
 }
 
 unordered_set<int> PKB::getLeft(RelationshipType rs, int right) {
-  return invTablesRs[rs][right];
+  if (isDerivedNextBip(rs)) {
+    return getDerivedNextBip(right, false);
+  }
+  return getValue(invTablesRs, rs, right);
 }
 
 unordered_set<int> PKB::getLeft(RelationshipType rs, TableType rightType,
@@ -128,14 +184,26 @@ unordered_set<int> PKB::getLeft(RelationshipType rs, TableType rightType,
   return getLeft(rs, rightIndex);
 }
 
-SetOfStmtLists PKB::getMappings(RelationshipType rs, ParamPosition param) {
-  return mappingsRs[rs][param];
+const SetOfStmtLists& PKB::getMappings(RelationshipType rs,
+                                       ParamPosition param) {
+  if (isDerivedNextBip(rs)) {
+    refreshNextBipMappingsIfStale();
+    return nextBipMappings.at(param);
+  }
+  auto mappingsIt = mappingsRs.find(rs);
+  if (mappingsIt == mappingsRs.end()) {
+    return EMPTY_STMT_LISTS;
+  }
+  auto listsIt = mappingsIt->second.find(param);
+  return listsIt == mappingsIt->second.end() ? EMPTY_STMT_LISTS
+                                             : listsIt->second;
 }
 
 void PKB::addPatternRs(RelationshipType rs, StmtNo stmtNo, string varName) {
   int varIndex = insertAt(TableType::VAR_TABLE, varName);
   insertToTableRs(&tablesRs, rs, varIndex, stmtNo);
   insertToMappings(&mappingsRs, rs, stmtNo, varIndex);
+  isStatisticsStale = true;
 }
 
 void PKB::addPatternRs(RelationshipType rs, StmtNo stmtNo, string varName,
@@ -159,8 +227,7 @@ void PKB::addPatternRs(RelationshipType rs, StmtNo stmtNo, string varName,
 bool PKB::isPatternRs(RelationshipType rs, StmtNo stmtno, int varIndex,
                       string expr) {
   int exprIndex = getIndexOf(TableType::EXPR_TABLE, expr);
-  auto key = pair(varIndex, exprIndex);
-  return tablesPttRs[rs][key].count(stmtno) != 0;
+  return getStmtsForVarAndExpr(rs, varIndex, exprIndex).count(stmtno) != 0;
 }
 
 bool PKB::isPatternRs(RelationshipType rs, StmtNo stmtno, int varIndex) {
@@ -170,8 +237,18 @@ bool PKB::isPatternRs(RelationshipType rs, StmtNo stmtno, int varIndex) {
 SetOfStmts PKB::getStmtsForVarAndExpr(RelationshipType rs, int varIndex,
                                       string expr) {
   int exprIndex = getIndexOf(TableType::EXPR_TABLE, expr);
-  pair newPair(varIndex, exprIndex);
-  return tablesPttRs[rs][newPair];
+  return getStmtsForVarAndExpr(rs, varIndex, exprIndex);
+}
+
+const SetOfStmts& PKB::getStmtsForVarAndExpr(RelationshipType rs,
+                                             VarIdx varIndex,
+                                             ExprIdx exprIndex) {
+  auto tableIt = tablesPttRs.find(rs);
+  if (tableIt == tablesPttRs.end()) {
+    return EMPTY_STMTS;
+  }
+  auto stmtsIt = tableIt->second.find(pair(varIndex, exprIndex));
+  return stmtsIt == tableIt->second.end() ? EMPTY_STMTS : stmtsIt->second;
 }
 
 SetOfStmts PKB::getStmtsForVar(RelationshipType rs, int varIndex) {
@@ -180,7 +257,7 @@ SetOfStmts PKB::getStmtsForVar(RelationshipType rs, int varIndex) {
 
 SetOfStmts PKB::getVarsForExpr(RelationshipType rs, std::string expr) {
   int exprIndex = getIndexOf(TableType::EXPR_TABLE, expr);
-  return getValue(&tablesExpr, rs, exprIndex);
+  return getValue(tablesExpr, rs, exprIndex);
 }
 
 // Affects Info API
@@ -189,10 +266,18 @@ void PKB::addNextStmtForIfStmt(StmtNo ifStmt, StmtNo nextStmtForIfStmt) {
 }
 void PKB::addFirstStmtOfProc(string procName, StmtNo firstStmtOfProc) {
   affectsInfoKB.addFirstStmtOfProc(procName, firstStmtOfProc);
+  isNextBipStale = true;
+  isNextBipMappingsStale = true;
 }
 void PKB::addProcCallEdge(ProcName callerProcName, ProcName calleeProcName) {
   affectsInfoKB.addProcCallEdge(callerProcName, calleeProcName);
 }
+void PKB::addTopoSortedProcs(vector<ProcName> topoSortedProcNames) {
+  affectsInfoKB.addTopoSortedProcs(topoSortedProcNames);
+}
+void PKB::addProcOfStmt(ProcName procName, StmtNo stmt) {
+  affectsInfoKB.addProcOfStmt(procName, stmt);
+}
 
 StmtNo PKB::getNextStmtForIfStmt(StmtNo ifStmt) {
   return affectsInfoKB.getNextStmtForIfStmt(ifStmt);
@@ -203,10 +288,392 @@ vector<StmtNo> PKB::getFirstStmtOfAllProcs() {
 unordered_map<ProcIdx, unordered_set<ProcIdx>> PKB::getCallGraph() {
   return affectsInfoKB.getCallGraph();
 }
+StmtNo PKB::getFirstStmtOfProc(ProcIdx procIdx) {
+  return affectsInfoKB.getFirstStmtOfProc(procIdx);
+}
+vector<ProcIdx> PKB::getTopoSortedProcs() {
+  return affectsInfoKB.getTopoSortedProcs();
+}
+ProcIdx PKB::getProcOfStmt(StmtNo stmt) {
+  return affectsInfoKB.getProcOfStmt(stmt);
+}
+pair<StmtNo, StmtNo> PKB::getProcRange(ProcIdx procIdx) {
+  return affectsInfoKB.getProcRange(procIdx);
+}
+
+// Statistics API
+void PKB::computeStatistics() {
+  hasComputedStatistics = true;
+  refreshStatistics();
+}
+bool PKB::hasStatistics() { return hasComputedStatistics; }
+const RsStatistics& PKB::getRsStatistics(RelationshipType rs) {
+  if (isStatisticsStale) {
+    refreshStatistics();
+  }
+  // derived NextBip has as many pairs as Next, bar those of calls
+  if (isDerivedNextBip(rs)) {
+    return statisticsKB.getRsStatistics(RelationshipType::NEXT);
+  }
+  return statisticsKB.getRsStatistics(rs);
+}
+long long PKB::getNumAssignDefUsePairs() {
+  if (isStatisticsStale) {
+    refreshStatistics();
+  }
+  return statisticsKB.getNumAssignDefUsePairs();
+}
+void PKB::prepareForConcurrentReads() {
+  if (isStatisticsStale) {
+    refreshStatistics();
+  }
+  if (isOutputStringsStale) {
+    refreshOutputStrings();
+  }
+  if (hasComputedReachability && isReachabilityStale) {
+    refreshReachability();
+  }
+  if (isStmtRangesStale) {
+    refreshStmtRanges();
+  }
+  if (isDominatorsStale) {
+    refreshDominators();
+  }
+  if (hasComputedDefUse && isDefUseStale) {
+    refreshDefUse();
+  }
+  if (isNextBipStale) {
+    refreshNextBip();
+  }
+}
+void PKB::refreshStatistics() {
+  statisticsKB.computeStatistics(tablesRs, tableOfStmts);
+  isStatisticsStale = false;
+}
+
+// Attribute API
+RelationshipType getNameAttributeRs(DesignEntity de) {
+  switch (de) {
+    case DesignEntity::CALL:
+      return RelationshipType::CALLS_S;
+    case DesignEntity::READ:
+      return RelationshipType::MODIFIES_S;
+    default:
+      return RelationshipType::USES_S;
+  }
+}
+
+TableElemIdx PKB::getNameAttribute(DesignEntity de, StmtNo s) {
+  if (s >= 0 && s < tableOfNameAttributes.size() &&
+      tableOfNameAttributes[s] >= 0) {
+    return tableOfNameAttributes[s];
+  }
+  // statements added after the pkb was frozen, or it never was
+  if (de != DesignEntity::CALL && de != DesignEntity::READ &&
+      de != DesignEntity::PRINT) {
+    return -1;
+  }
+  auto tableIt = tablesRs.find(getNameAttributeRs(de));
+  if (tableIt == tablesRs.end()) {
+    return -1;
+  }
+  auto namesIt = tableIt->second.find(s);
+  if (namesIt == tableIt->second.end() || namesIt->second.empty()) {
+    return -1;
+  }
+  return *namesIt->second.begin();
+}
+
+void PKB::computeNameAttributes() {
+  StmtNo maxStmt = 0;
+  for (StmtNo s : tableOfStmts[DesignEntity::STATEMENT]) {
+    maxStmt = max(maxStmt, s);
+  }
+  tableOfNameAttributes.assign(maxStmt + 1, -1);
+  for (DesignEntity de :
+       {DesignEntity::CALL, DesignEntity::READ, DesignEntity::PRINT}) {
+    auto tableIt = tablesRs.find(getNameAttributeRs(de));
+    if (tableIt == tablesRs.end()) {
+      continue;
+    }
+    for (StmtNo s : tableOfStmts[de]) {
+      auto namesIt = tableIt->second.find(s);
+      if (namesIt != tableIt->second.end() && !namesIt->second.empty()) {
+        tableOfNameAttributes[s] = *namesIt->second.begin();
+      }
+    }
+  }
+}
+
+// Output Strings API
+void PKB::freeze() {
+  computeStatistics();
+  computeNameAttributes();
+  isFrozen = true;
+  refreshOutputStrings();
+  // Next* of two statements is read off statement ranges whenever they exist,
+  // unless the reachability index is configured instead
+  if (nextTOracle == NextTOracle::REACHABILITY_INDEX ||
+      (nextTOracle == NextTOracle::STMT_RANGES && !hasStmtRanges())) {
+    computeReachabilityIndex();
+  }
+  if (defUseIndexMode == DefUseIndexMode::EAGER) {
+    computeDefUseIndex();
+  }
+}
+bool PKB::hasOutputStrings() { return isFrozen; }
+string_view PKB::getOutputString(TableType type, TableElemIdx index) {
+  if (isOutputStringsStale) {
+    refreshOutputStrings();
+  }
+  return outputStringsKB.getElementString(type, index);
+}
+string_view PKB::getStmtOutputString(StmtNo stmt) {
+  if (isOutputStringsStale) {
+    refreshOutputStrings();
+  }
+  return outputStringsKB.getStmtString(stmt);
+}
+string_view PKB::getNameAttributeOutputString(StmtNo stmt) {
+  if (isOutputStringsStale) {
+    refreshOutputStrings();
+  }
+  return outputStringsKB.getNameAttributeString(stmt);
+}
+void PKB::refreshOutputStrings() {
+  outputStringsKB.computeOutputStrings(
+      &tables.at(TableType::VAR_TABLE), &tables.at(TableType::PROC_TABLE),
+      &tables.at(TableType::CONST_TABLE), tablesRs, tableOfStmts);
+  isOutputStringsStale = false;
+}
+
+// Statement Ranges API
+void PKB::addProcRange(ProcName procName, StmtNo firstStmt, StmtNo lastStmt) {
+  ProcIdx procIdx = tables.at(TableType::PROC_TABLE).getIndex(procName);
+  stmtRangesKB.addProcRange(procIdx, firstStmt, lastStmt);
+  isStmtRangesStale = true;
+}
+void PKB::addWhileRange(StmtNo whileStmt, StmtNo lastStmtInLoop) {
+  stmtRangesKB.addWhileRange(whileStmt, lastStmtInLoop);
+  isStmtRangesStale = true;
+}
+void PKB::addIfRanges(StmtNo ifStmt, StmtNo lastStmtInThen,
+                      StmtNo lastStmtInElse) {
+  stmtRangesKB.addIfRanges(ifStmt, lastStmtInThen, lastStmtInElse);
+  isStmtRangesStale = true;
+}
+bool PKB::hasStmtRanges() {
+  if (isStmtRangesStale) {
+    refreshStmtRanges();
+  }
+  return stmtRangesKB.hasRanges();
+}
+bool PKB::isStructuralNextT(StmtNo fromStmt, StmtNo toStmt) {
+  if (isStmtRangesStale) {
+    refreshStmtRanges();
+  }
+  return stmtRangesKB.isNextT(fromStmt, toStmt);
+}
+IntervalSet PKB::getStructuralNextTStmts(StmtNo stmt, bool isForward) {
+  if (isStmtRangesStale) {
+    refreshStmtRanges();
+  }
+  return stmtRangesKB.getNextTStmts(stmt, isForward);
+}
+void PKB::refreshStmtRanges() {
+  stmtRangesKB.computeIndex();
+  isStmtRangesStale = false;
+}
+
+// Dominators API
+void PKB::addImmediateDominator(StmtNo stmt, StmtNo dominator) {
+  dominatorKB.addImmediateDominator(stmt, dominator);
+  isDominatorsStale = true;
+}
+void PKB::addImmediatePostDominator(StmtNo stmt, StmtNo postDominator) {
+  postDominatorKB.addImmediateDominator(stmt, postDominator);
+  isDominatorsStale = true;
+}
+bool PKB::hasDominators() {
+  if (isDominatorsStale) {
+    refreshDominators();
+  }
+  return dominatorKB.hasTree() && postDominatorKB.hasTree();
+}
+bool PKB::isDominator(StmtNo dominator, StmtNo stmt) {
+  if (isDominatorsStale) {
+    refreshDominators();
+  }
+  return dominatorKB.isDominator(dominator, stmt);
+}
+bool PKB::isPostDominator(StmtNo postDominator, StmtNo stmt) {
+  if (isDominatorsStale) {
+    refreshDominators();
+  }
+  return postDominatorKB.isDominator(postDominator, stmt);
+}
+void PKB::refreshDominators() {
+  dominatorKB.computeIndex();
+  postDominatorKB.computeIndex();
+  isDominatorsStale = false;
+}
+
+// Reachability API
+void PKB::setNextTOracle(NextTOracle oracle) { nextTOracle = oracle; }
+NextTOracle PKB::getNextTOracle() {
+  if (nextTOracle == NextTOracle::SEARCH) {
+    return NextTOracle::SEARCH;
+  }
+  if (nextTOracle == NextTOracle::REACHABILITY_INDEX &&
+      hasReachabilityIndex()) {
+    return NextTOracle::REACHABILITY_INDEX;
+  }
+  if (hasStmtRanges()) {
+    return NextTOracle::STMT_RANGES;
+  }
+  return hasReachabilityIndex() ? NextTOracle::REACHABILITY_INDEX
+                                : NextTOracle::SEARCH;
+}
+void PKB::setReachabilityIndexType(ReachabilityIndexType type) {
+  reachabilityIndexType = type;
+  isReachabilityStale = true;
+}
+void PKB::computeReachabilityIndex() {
+  hasComputedReachability = true;
+  refreshReachability();
+}
+bool PKB::hasReachabilityIndex() {
+  return hasComputedReachability &&
+         reachabilityIndexType != ReachabilityIndexType::NONE;
+}
+bool PKB::isNextT(StmtNo fromStmt, StmtNo toStmt) {
+  if (isReachabilityStale) {
+    refreshReachability();
+  }
+  return reachabilityKB.isReachable(fromStmt, toStmt);
+}
+void PKB::refreshReachability() {
+  reachabilityKB.computeIndex(reachabilityIndexType,
+                              tableOfStmts[DesignEntity::STATEMENT],
+                              tablesRs[RelationshipType::NEXT]);
+  isReachabilityStale = false;
+}
+
+// Def-Use API
+void PKB::setDefUseIndexMode(DefUseIndexMode mode) { defUseIndexMode = mode; }
+void PKB::computeDefUseIndex() { refreshDefUse(); }
+bool PKB::hasDefUseIndex() { return defUseIndexMode != DefUseIndexMode::NONE; }
+bool PKB::isAffects(StmtNo a1, StmtNo a2) {
+  refreshDefUseIfStale();
+  return defUseKB.isAffects(a1, a2);
+}
+unordered_set<StmtNo> PKB::getAffects(StmtNo stmt, bool isForward) {
+  refreshDefUseIfStale();
+  return defUseKB.getAffects(stmt, isForward);
+}
+int PKB::getNumAffects() {
+  refreshDefUseIfStale();
+  return defUseKB.getNumAffects();
+}
+void PKB::refreshDefUseIfStale() {
+  if (!isDefUseStale) {
+    return;
+  }
+  // reads of groups evaluated concurrently may all find it stale
+  lock_guard<mutex> lock(defUseMutex);
+  if (isDefUseStale) {
+    refreshDefUse();
+  }
+}
+void PKB::refreshDefUse() {
+  // may run while other reads do, so nothing missing is inserted
+  if (isDominatorsStale) {
+    refreshDominators();
+  }
+  defUseKB.computeIndex(getStmtsOf(tableOfStmts, DesignEntity::ASSIGN),
+                        getStmtsOf(tableOfStmts, DesignEntity::READ),
+                        getStmtsOf(tableOfStmts, DesignEntity::CALL),
+                        getTableRs(tablesRs, RelationshipType::NEXT),
+                        getTableRs(tablesRs, RelationshipType::MODIFIES_S),
+                        getTableRs(tablesRs, RelationshipType::USES_S),
+                        &dominatorKB, &postDominatorKB);
+  hasComputedDefUse = true;
+  isDefUseStale = false;
+}
+
+// NextBip API
+void PKB::addExitStmtOfProc(ProcName procName, StmtNo exitStmt) {
+  ProcIdx procIdx = insertAt(TableType::PROC_TABLE, procName);
+  nextBipKB.addExitStmt(procIdx, exitStmt);
+  isNextBipStale = true;
+  isNextBipMappingsStale = true;
+}
+bool PKB::isDerivedNextBip(RelationshipType rs) {
+  if (rs != RelationshipType::NEXT_BIP) {
+    return false;
+  }
+  refreshNextBipIfStale();
+  return nextBipKB.hasExitStmts();
+}
+unordered_set<int> PKB::getDerivedNextBip(StmtNo stmt, bool isForward) {
+  const TablesRs& nextTables = isForward ? tablesRs : invTablesRs;
+  return nextBipKB.getNextBipStmts(
+      stmt, isForward, getValue(nextTables, RelationshipType::NEXT, stmt));
+}
+void PKB::refreshNextBipIfStale() {
+  if (!isNextBipStale) {
+    return;
+  }
+  lock_guard<mutex> lock(nextBipMutex);
+  if (isNextBipStale) {
+    refreshNextBip();
+  }
+}
+void PKB::refreshNextBip() {
+  unordered_map<ProcIdx, StmtNo> firstStmts;
+  for (ProcIdx procIdx : getAllElementsAt(TableType::PROC_TABLE)) {
+    StmtNo firstStmt = affectsInfoKB.getFirstStmtOfProc(procIdx);
+    if (firstStmt != -1) {
+      firstStmts[procIdx] = firstStmt;
+    }
+  }
+  nextBipKB.computeIndex(getTableRs(tablesRs, RelationshipType::NEXT),
+                         getTableRs(tablesRs, RelationshipType::CALLS_S),
+                         firstStmts);
+  isNextBipStale = false;
+}
+void PKB::refreshNextBipMappingsIfStale() {
+  if (!isNextBipMappingsStale) {
+    return;
+  }
+  // only a query with NextBip pairs of synonyms or wildcards pays for them
+  lock_guard<mutex> lock(nextBipMutex);
+  if (!isNextBipMappingsStale) {
+    return;
+  }
+  nextBipMappings = {{ParamPosition::LEFT, SetOfStmtLists()},
+                     {ParamPosition::RIGHT, SetOfStmtLists()},
+                     {ParamPosition::BOTH, SetOfStmtLists()}};
+  for (StmtNo stmt : getStmtsOf(tableOfStmts, DesignEntity::STATEMENT)) {
+    for (StmtNo nextBipStmt : getDerivedNextBip(stmt, true)) {
+      nextBipMappings[ParamPosition::LEFT].insert(vector<int>({stmt}));
+      nextBipMappings[ParamPosition::RIGHT].insert(vector<int>({nextBipStmt}));
+      nextBipMappings[ParamPosition::BOTH].insert(
+          vector<int>({stmt, nextBipStmt}));
+    }
+  }
+  isNextBipMappingsStale = false;
+}
 
 // Table API
 TableElemIdx PKB::insertAt(TableType type, string element) {
-  return tables.at(type).insert(element);
+  Table& table = tables.at(type);
+  int size = table.getSize();
+  TableElemIdx index = table.insert(element);
+  if (table.getSize() != size) {
+    isOutputStringsStale = true;
+  }
+  return index;
 }
 string PKB::getElementAt(TableType type, TableElemIdx index) {
   return tables.at(type).getElement(index);
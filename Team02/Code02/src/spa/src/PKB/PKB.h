@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -10,6 +13,13 @@
 
 #include "AffectsInfoKB.h"
 #include "Common/Common.h"
+#include "DefUseKB.h"
+#include "DominatorKB.h"
+#include "NextBipKB.h"
+#include "OutputStringsKB.h"
+#include "ReachabilityKB.h"
+#include "StatisticsKB.h"
+#include "StmtRangesKB.h"
 #include "Table.h"
 
 typedef std::unordered_map<RelationshipType,
@@ -46,7 +56,7 @@ class PKB {
   std::unordered_set<int> getLeft(RelationshipType rs, int right);
   std::unordered_set<int> getLeft(RelationshipType rs, TableType rightType,
                                   std::string right);
-  SetOfStmtLists getMappings(RelationshipType rs, ParamPosition param);
+  const SetOfStmtLists& getMappings(RelationshipType rs, ParamPosition param);
 
   // Pattern API
   void addPatternRs(RelationshipType rs, StmtNo stmtNo, std::string varName,
@@ -64,9 +74,90 @@ class PKB {
   void addNextStmtForIfStmt(StmtNo ifStmt, StmtNo nextStmt);
   void addFirstStmtOfProc(ProcName procName, StmtNo firstStmtOfProc);
   void addProcCallEdge(ProcName callerProcName, ProcName calleeProcName);
+  void addTopoSortedProcs(std::vector<ProcName> topoSortedProcNames);
+  void addProcOfStmt(ProcName procName, StmtNo stmt);
   StmtNo getNextStmtForIfStmt(StmtNo ifStmt);
   std::vector<StmtNo> getFirstStmtOfAllProcs();
   std::unordered_map<ProcIdx, std::unordered_set<ProcIdx>> getCallGraph();
+  StmtNo getFirstStmtOfProc(ProcIdx procIdx);
+  std::vector<ProcIdx> getTopoSortedProcs();
+  ProcIdx getProcOfStmt(StmtNo stmt);
+  std::pair<StmtNo, StmtNo> getProcRange(ProcIdx procIdx);
+
+  // Statistics API
+  // called once extraction is done, recomputed lazily after later insertions
+  void computeStatistics();
+  bool hasStatistics();
+  const RsStatistics& getRsStatistics(RelationshipType rs);
+  long long getNumAssignDefUsePairs();
+  // recomputes whatever later reads would recompute lazily, after which
+  // reads may run concurrently. a lazy def-use index never built before is
+  // built by the first of them under a lock.
+  void prepareForConcurrentReads();
+
+  // Attribute API
+  // procName index of a call, varName index of a read or print, or -1
+  TableElemIdx getNameAttribute(DesignEntity de, StmtNo s);
+
+  // Output Strings API
+  // called once extraction is done, computes the statistics and the strings
+  // results are printed with, which are recomputed lazily after insertions
+  void freeze();
+  bool hasOutputStrings();
+  std::string_view getOutputString(TableType type, TableElemIdx index);
+  std::string_view getStmtOutputString(StmtNo stmt);
+  std::string_view getNameAttributeOutputString(StmtNo stmt);
+
+  // Statement Ranges API
+  // Next* within a procedure is read off how these ranges nest, without a
+  // search of the CFG, once they are added for every procedure
+  void addProcRange(ProcName procName, StmtNo firstStmt, StmtNo lastStmt);
+  void addWhileRange(StmtNo whileStmt, StmtNo lastStmtInLoop);
+  void addIfRanges(StmtNo ifStmt, StmtNo lastStmtInThen,
+                   StmtNo lastStmtInElse);
+  bool hasStmtRanges();
+  bool isStructuralNextT(StmtNo fromStmt, StmtNo toStmt);
+  // Next* of the statement, or its inverse if not isForward
+  IntervalSet getStructuralNextTStmts(StmtNo stmt, bool isForward);
+
+  // Dominators API
+  // dominator and post-dominator trees of the CFG of each procedure, roots
+  // added with -1, numbered lazily for dominance tests in constant time
+  void addImmediateDominator(StmtNo stmt, StmtNo dominator);
+  void addImmediatePostDominator(StmtNo stmt, StmtNo postDominator);
+  bool hasDominators();
+  // every statement dominates and post-dominates itself
+  bool isDominator(StmtNo dominator, StmtNo stmt);
+  bool isPostDominator(StmtNo postDominator, StmtNo stmt);
+
+  // Reachability API
+  // Next* of two statements is answered from an index of the CFG, built when
+  // computed, or when frozen with the oracle configured for it or without
+  // statement ranges, and rebuilt lazily after later insertions of Next
+  void setNextTOracle(NextTOracle oracle);
+  // the oracle configured, or the next one of those available
+  NextTOracle getNextTOracle();
+  void setReachabilityIndexType(ReachabilityIndexType type);
+  void computeReachabilityIndex();
+  bool hasReachabilityIndex();
+  bool isNextT(StmtNo fromStmt, StmtNo toStmt);
+
+  // NextBip API
+  // NextBip is derived from Next and the calls once the statements control
+  // leaves each procedure from are added, and is otherwise read off the
+  // NEXT_BIP rs added. getMappings materialises its pairs when first read.
+  void addExitStmtOfProc(ProcName procName, StmtNo exitStmt);
+
+  // Def-Use API
+  // Affects of assignments read off def-use chains, built when first read,
+  // or when frozen in eager mode, and rebuilt after later insertions
+  void setDefUseIndexMode(DefUseIndexMode mode);
+  void computeDefUseIndex();
+  bool hasDefUseIndex();
+  bool isAffects(StmtNo a1, StmtNo a2);
+  // Affects of the statement, or its inverse if not isForward
+  std::unordered_set<StmtNo> getAffects(StmtNo stmt, bool isForward);
+  int getNumAffects();
 
   // Table API
   TableElemIdx insertAt(TableType type, std::string element);
@@ -95,4 +186,50 @@ class PKB {
   // Design Abstractions
   AffectsInfoKB affectsInfoKB =
       AffectsInfoKB(&tables.at(TableType::PROC_TABLE));
+  StatisticsKB statisticsKB;
+  bool hasComputedStatistics = false;
+  bool isStatisticsStale = true;
+  // name attributes by statement, filled when frozen with -1 for statements
+  // that are not calls, reads or prints
+  std::vector<TableElemIdx> tableOfNameAttributes;
+  OutputStringsKB outputStringsKB;
+  bool isFrozen = false;
+  bool isOutputStringsStale = true;
+  StmtRangesKB stmtRangesKB;
+  bool isStmtRangesStale = false;
+  DominatorKB dominatorKB;
+  DominatorKB postDominatorKB;
+  bool isDominatorsStale = false;
+  ReachabilityKB reachabilityKB;
+  ReachabilityIndexType reachabilityIndexType =
+      ReachabilityIndexType::TWO_HOP_LABELS;
+  bool hasComputedReachability = false;
+  bool isReachabilityStale = true;
+  NextTOracle nextTOracle = NextTOracle::STMT_RANGES;
+  DefUseKB defUseKB;
+  DefUseIndexMode defUseIndexMode = DefUseIndexMode::LAZY;
+  bool hasComputedDefUse = false;
+  std::atomic<bool> isDefUseStale = true;
+  std::mutex defUseMutex;
+  NextBipKB nextBipKB;
+  std::atomic<bool> isNextBipStale = true;
+  std::atomic<bool> isNextBipMappingsStale = true;
+  std::mutex nextBipMutex;
+  std::unordered_map<ParamPosition, SetOfStmtLists> nextBipMappings;
+
+  const SetOfStmts& getStmtsForVarAndExpr(RelationshipType rs,
+                                          VarIdx varIndex, ExprIdx exprIndex);
+  void refreshStatistics();
+  void refreshOutputStrings();
+  void refreshReachability();
+  void refreshStmtRanges();
+  void refreshDominators();
+  void refreshDefUse();
+  void refreshDefUseIfStale();
+  void computeNameAttributes();
+  bool isDerivedNextBip(RelationshipType rs);
+  std::unordered_set<int> getDerivedNextBip(StmtNo stmt, bool isForward);
+  void refreshNextBipIfStale();
+  void refreshNextBip();
+  void refreshNextBipMappingsIfStale();
 };
@@ -0,0 +1,238 @@
+#include "ReachabilityKB.h"
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// PKB Methods
+void ReachabilityKB::computeIndex(
+    ReachabilityIndexType type, const SetOfStmts& stmts,
+    const unordered_map<int, SetOfInts>& tableOfNext) {
+  indexType = type;
+  componentOfStmt.clear();
+  isCyclicComponent.clear();
+  outLabels.clear();
+  inLabels.clear();
+  reachableComponents.clear();
+  if (type == ReachabilityIndexType::NONE) {
+    return;
+  }
+
+  StmtNo maxStmt = 0;
+  for (StmtNo stmt : stmts) {
+    maxStmt = max(maxStmt, stmt);
+  }
+  for (const auto& [stmt, nextStmts] : tableOfNext) {
+    maxStmt = max(maxStmt, stmt);
+    for (StmtNo nextStmt : nextStmts) {
+      maxStmt = max(maxStmt, nextStmt);
+    }
+  }
+  vector<vector<int>> successors(maxStmt + 1);
+  for (const auto& [stmt, nextStmts] : tableOfNext) {
+    for (StmtNo nextStmt : nextStmts) {
+      if (stmt >= 0 && nextStmt >= 0) {
+        successors[stmt].push_back(nextStmt);
+      }
+    }
+  }
+  computeComponents(successors);
+
+  int numComponents = isCyclicComponent.size();
+  vector<vector<int>> componentSuccessors(numComponents);
+  vector<vector<int>> componentPredecessors(numComponents);
+  for (StmtNo stmt = 0; stmt <= maxStmt; stmt++) {
+    for (StmtNo nextStmt : successors[stmt]) {
+      int fromComponent = componentOfStmt[stmt];
+      int toComponent = componentOfStmt[nextStmt];
+      if (fromComponent == toComponent) {
+        isCyclicComponent[fromComponent] = true;
+        continue;
+      }
+      componentSuccessors[fromComponent].push_back(toComponent);
+      componentPredecessors[toComponent].push_back(fromComponent);
+    }
+  }
+
+  if (type == ReachabilityIndexType::TWO_HOP_LABELS) {
+    computeTwoHopLabels(componentSuccessors, componentPredecessors);
+  } else {
+    computeFullClosure(componentSuccessors);
+  }
+}
+
+void ReachabilityKB::computeComponents(const vector<vector<int>>& successors) {
+  // Tarjan's algorithm with an explicit stack of (stmt, next successor), so
+  // long procedures cannot overflow the call stack. components are numbered
+  // in reverse topological order.
+  int numStmts = successors.size();
+  vector<int> indices(numStmts, -1);
+  vector<int> lowLinks(numStmts, 0);
+  vector<bool> isOnStack(numStmts, false);
+  vector<int> componentStack;
+  vector<pair<int, int>> callStack;
+  int nextIndex = 0;
+  componentOfStmt.assign(numStmts, -1);
+
+  for (int root = 0; root < numStmts; root++) {
+    if (indices[root] != -1) {
+      continue;
+    }
+    callStack.push_back({root, 0});
+    while (!callStack.empty()) {
+      int stmt = callStack.back().first;
+      int& successorIndex = callStack.back().second;
+      if (successorIndex == 0) {
+        indices[stmt] = lowLinks[stmt] = nextIndex++;
+        componentStack.push_back(stmt);
+        isOnStack[stmt] = true;
+      }
+
+      if (successorIndex < successors[stmt].size()) {
+        int successor = successors[stmt][successorIndex++];
+        if (indices[successor] == -1) {
+          callStack.push_back({successor, 0});
+        } else if (isOnStack[successor]) {
+          lowLinks[stmt] = min(lowLinks[stmt], indices[successor]);
+        }
+        continue;
+      }
+
+      if (lowLinks[stmt] == indices[stmt]) {
+        int component = isCyclicComponent.size();
+        int member;
+        do {
+          member = componentStack.back();
+          componentStack.pop_back();
+          isOnStack[member] = false;
+          componentOfStmt[member] = component;
+        } while (member != stmt);
+        // single statements are only cyclic with an edge to themselves
+        isCyclicComponent.push_back(false);
+      }
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        int parent = callStack.back().first;
+        lowLinks[parent] = min(lowLinks[parent], lowLinks[stmt]);
+      }
+    }
+  }
+}
+
+void ReachabilityKB::computeTwoHopLabels(
+    const vector<vector<int>>& componentSuccessors,
+    const vector<vector<int>>& componentPredecessors) {
+  // pruned landmark labelling: components are taken as landmarks in order of
+  // how many paths they are likely to cover, and the search from a landmark
+  // stops at components whose reachability the labels already answer
+  int numComponents = componentSuccessors.size();
+  vector<int> landmarks(numComponents);
+  iota(landmarks.begin(), landmarks.end(), 0);
+  auto getCoverage = [&](int component) {
+    return (long long)(componentSuccessors[component].size() + 1) *
+           (componentPredecessors[component].size() + 1);
+  };
+  stable_sort(landmarks.begin(), landmarks.end(), [&](int left, int right) {
+    return getCoverage(left) > getCoverage(right);
+  });
+
+  outLabels.assign(numComponents, {});
+  inLabels.assign(numComponents, {});
+  vector<int> visitedBy(numComponents, -1);
+  for (int rank = 0; rank < numComponents; rank++) {
+    int landmark = landmarks[rank];
+    for (bool isForward : {true, false}) {
+      // visits are marked with the rank and direction of the search
+      int searchId = 2 * rank + (isForward ? 0 : 1);
+      queue<int> componentQueue;
+      componentQueue.push(landmark);
+      visitedBy[landmark] = searchId;
+      while (!componentQueue.empty()) {
+        int component = componentQueue.front();
+        componentQueue.pop();
+        if (isForward ? isLabelReachable(landmark, component)
+                      : isLabelReachable(component, landmark)) {
+          continue;
+        }
+        if (isForward) {
+          inLabels[component].push_back(rank);
+        } else {
+          outLabels[component].push_back(rank);
+        }
+        for (int adjacent : isForward ? componentSuccessors[component]
+                                      : componentPredecessors[component]) {
+          if (visitedBy[adjacent] != searchId) {
+            visitedBy[adjacent] = searchId;
+            componentQueue.push(adjacent);
+          }
+        }
+      }
+    }
+  }
+}
+
+void ReachabilityKB::computeFullClosure(
+    const vector<vector<int>>& componentSuccessors) {
+  // successors of a component are numbered before it, so their closures are
+  // complete by the time it is reached
+  int numComponents = componentSuccessors.size();
+  int numWords = (numComponents + 63) / 64;
+  reachableComponents.assign(numComponents,
+                             vector<unsigned long long>(numWords, 0));
+  for (int component = 0; component < numComponents; component++) {
+    vector<unsigned long long>& reachable = reachableComponents[component];
+    for (int successor : componentSuccessors[component]) {
+      reachable[successor / 64] |= 1ULL << (successor % 64);
+      const vector<unsigned long long>& successorReachable =
+          reachableComponents[successor];
+      for (int word = 0; word < numWords; word++) {
+        reachable[word] |= successorReachable[word];
+      }
+    }
+  }
+}
+
+bool ReachabilityKB::isLabelReachable(int fromComponent, int toComponent) {
+  const vector<int>& outLabel = outLabels[fromComponent];
+  const vector<int>& inLabel = inLabels[toComponent];
+  size_t outIndex = 0;
+  size_t inIndex = 0;
+  while (outIndex < outLabel.size() && inIndex < inLabel.size()) {
+    if (outLabel[outIndex] == inLabel[inIndex]) {
+      return true;
+    }
+    if (outLabel[outIndex] < inLabel[inIndex]) {
+      outIndex++;
+    } else {
+      inIndex++;
+    }
+  }
+  return false;
+}
+
+// QE Methods
+bool ReachabilityKB::isReachable(StmtNo fromStmt, StmtNo toStmt) {
+  if (fromStmt < 0 || toStmt < 0 || fromStmt >= componentOfStmt.size() ||
+      toStmt >= componentOfStmt.size()) {
+    return false;
+  }
+  int fromComponent = componentOfStmt[fromStmt];
+  int toComponent = componentOfStmt[toStmt];
+  if (fromComponent == toComponent) {
+    return isCyclicComponent[fromComponent];
+  }
+  if (indexType == ReachabilityIndexType::TWO_HOP_LABELS) {
+    return isLabelReachable(fromComponent, toComponent);
+  }
+  if (indexType == ReachabilityIndexType::FULL_CLOSURE) {
+    return (reachableComponents[fromComponent][toComponent / 64] >>
+            (toComponent % 64)) &
+           1ULL;
+  }
+  return false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Common/Common.h>
+
+#include <unordered_map>
+#include <vector>
+
+enum class ReachabilityIndexType {
+  // 2-hop labels of landmarks, near linear in the size of the CFG
+  TWO_HOP_LABELS,
+  // the closure of Next as a bitset per strongly connected component,
+  // quadratic in the number of components
+  FULL_CLOSURE,
+  // Next* is always searched on demand
+  NONE
+};
+
+// what Next* of two statements is answered from
+enum class NextTOracle {
+  // statement ranges, or the reachability index where there are none
+  STMT_RANGES,
+  // the reachability index, which is then built even with statement ranges
+  REACHABILITY_INDEX,
+  // Next* is always searched on demand
+  SEARCH
+};
+
+class ReachabilityKB {
+ public:
+  // Methods for PKB
+  void computeIndex(ReachabilityIndexType type, const SetOfStmts& stmts,
+                    const std::unordered_map<int, SetOfInts>& tableOfNext);
+
+  // Methods for QE
+  // Next*(fromStmt, toStmt), false for statements not in the pkb when computed
+  bool isReachable(StmtNo fromStmt, StmtNo toStmt);
+
+ private:
+  ReachabilityIndexType indexType = ReachabilityIndexType::NONE;
+  // the CFG is condensed into a DAG of its strongly connected components,
+  // the loops of each procedure, which the index is built over
+  std::vector<int> componentOfStmt;
+  // statements of a component holding a cycle reach themselves
+  std::vector<bool> isCyclicComponent;
+
+  // ranks of the landmarks reached from and reaching each component, in
+  // increasing order. a reaches b iff outLabels[a] and inLabels[b] share one.
+  std::vector<std::vector<int>> outLabels;
+  std::vector<std::vector<int>> inLabels;
+  // bit c of a component's words is set if it reaches component c
+  std::vector<std::vector<unsigned long long>> reachableComponents;
+
+  void computeComponents(const std::vector<std::vector<int>>& successors);
+  void computeTwoHopLabels(
+      const std::vector<std::vector<int>>& componentSuccessors,
+      const std::vector<std::vector<int>>& componentPredecessors);
+  void computeFullClosure(
+      const std::vector<std::vector<int>>& componentSuccessors);
+  bool isLabelReachable(int fromComponent, int toComponent);
+};
@@ -0,0 +1,185 @@
+#include "StatisticsKB.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+const vector<DesignEntity> stmtEntities = {
+    DesignEntity::READ,  DesignEntity::PRINT, DesignEntity::CALL,
+    DesignEntity::WHILE, DesignEntity::IF,    DesignEntity::ASSIGN};
+
+// PKB Methods
+void StatisticsKB::computeStatistics(
+    const TablesRs& tablesRs,
+    const unordered_map<DesignEntity, SetOfStmts>& tableOfStmts) {
+  tableOfRsStatistics.clear();
+
+  unordered_map<StmtNo, DesignEntity> stmtToEntity;
+  for (DesignEntity entity : stmtEntities) {
+    auto it = tableOfStmts.find(entity);
+    if (it == tableOfStmts.end()) {
+      continue;
+    }
+    for (StmtNo stmt : it->second) {
+      stmtToEntity[stmt] = entity;
+    }
+  }
+
+  auto countByEntity = [&stmtToEntity](auto* counts, int value, int amount) {
+    auto it = stmtToEntity.find(value);
+    if (it == stmtToEntity.end()) {
+      return;
+    }
+    (*counts)[it->second] += amount;
+    (*counts)[DesignEntity::STATEMENT] += amount;
+    (*counts)[DesignEntity::PROG_LINE] += amount;
+  };
+
+  for (const auto& rsToTable : tablesRs) {
+    RelationshipType rs = rsToTable.first;
+    bool isLeftStmt = isStmtPosition(rs, ParamPosition::LEFT);
+    bool isRightStmt = isStmtPosition(rs, ParamPosition::RIGHT);
+    RsStatistics stats;
+
+    unordered_map<int, int> rightToFanOut;
+    for (const auto& leftToRights : rsToTable.second) {
+      int fanOut = leftToRights.second.size();
+      // lookups of missing keys leave empty entries behind
+      if (fanOut == 0) {
+        continue;
+      }
+      stats.numPairs += fanOut;
+      stats.numDistinctLeft += 1;
+      addToHistogram(&stats.leftFanOutHistogram, fanOut);
+      if (isLeftStmt) {
+        countByEntity(&stats.numPairsByLeftEntity, leftToRights.first, fanOut);
+        countByEntity(&stats.numDistinctLeftByEntity, leftToRights.first, 1);
+      }
+      for (int right : leftToRights.second) {
+        rightToFanOut[right] += 1;
+      }
+    }
+
+    stats.numDistinctRight = rightToFanOut.size();
+    for (const auto& rightAndFanOut : rightToFanOut) {
+      addToHistogram(&stats.rightFanOutHistogram, rightAndFanOut.second);
+      if (isRightStmt) {
+        countByEntity(&stats.numPairsByRightEntity, rightAndFanOut.first,
+                      rightAndFanOut.second);
+        countByEntity(&stats.numDistinctRightByEntity, rightAndFanOut.first,
+                      1);
+      }
+    }
+    tableOfRsStatistics[rs] = stats;
+  }
+
+  // every affects pair is a definition and a use of one variable by two
+  // assignments, so this bounds the size of the affects relationships
+  numAssignDefUsePairs = 0;
+  auto assignsIt = tableOfStmts.find(DesignEntity::ASSIGN);
+  if (assignsIt == tableOfStmts.end()) {
+    return;
+  }
+  unordered_map<VarIdx, long long> varToNumDefs;
+  unordered_map<VarIdx, long long> varToNumUses;
+  auto countVars = [&tablesRs, &assignsIt](RelationshipType rs,
+                                           unordered_map<VarIdx, long long>*
+                                               varToCount) {
+    auto tableIt = tablesRs.find(rs);
+    if (tableIt == tablesRs.end()) {
+      return;
+    }
+    for (StmtNo assign : assignsIt->second) {
+      auto varsIt = tableIt->second.find(assign);
+      if (varsIt == tableIt->second.end()) {
+        continue;
+      }
+      for (VarIdx var : varsIt->second) {
+        (*varToCount)[var] += 1;
+      }
+    }
+  };
+  countVars(RelationshipType::MODIFIES_S, &varToNumDefs);
+  countVars(RelationshipType::USES_S, &varToNumUses);
+  for (const auto& varAndNumDefs : varToNumDefs) {
+    auto usesIt = varToNumUses.find(varAndNumDefs.first);
+    if (usesIt != varToNumUses.end()) {
+      numAssignDefUsePairs += varAndNumDefs.second * usesIt->second;
+    }
+  }
+}
+
+// QE Methods
+const RsStatistics& StatisticsKB::getRsStatistics(RelationshipType rs) {
+  static const RsStatistics emptyStatistics;
+  auto it = tableOfRsStatistics.find(rs);
+  if (it == tableOfRsStatistics.end()) {
+    return emptyStatistics;
+  }
+  return it->second;
+}
+
+long long StatisticsKB::getNumAssignDefUsePairs() {
+  return numAssignDefUsePairs;
+}
+
+bool StatisticsKB::isStmtPosition(RelationshipType rs,
+                                  ParamPosition position) {
+  switch (rs) {
+    case RelationshipType::FOLLOWS:
+    case RelationshipType::FOLLOWS_T:
+    case RelationshipType::PARENT:
+    case RelationshipType::PARENT_T:
+    case RelationshipType::NEXT:
+    case RelationshipType::NEXT_T:
+    case RelationshipType::NEXT_BIP:
+    case RelationshipType::NEXT_BIP_T:
+    case RelationshipType::AFFECTS:
+    case RelationshipType::AFFECTS_T:
+    case RelationshipType::AFFECTS_BIP:
+    case RelationshipType::AFFECTS_BIP_T:
+      return true;
+    case RelationshipType::USES_S:
+    case RelationshipType::MODIFIES_S:
+    case RelationshipType::CALLS_S:
+      return position == ParamPosition::LEFT;
+    case RelationshipType::PTT_ASSIGN_FULL_EXPR:
+    case RelationshipType::PTT_ASSIGN_SUB_EXPR:
+    case RelationshipType::PTT_IF:
+    case RelationshipType::PTT_WHILE:
+      // pattern tables map variables to statements
+      return position == ParamPosition::RIGHT;
+    default:
+      return false;
+  }
+}
+
+double StatisticsKB::getTypicalFanOut(const vector<int>& fanOutHistogram) {
+  // median bucket, as a few heavily connected values skew the mean
+  long long total = 0;
+  for (int count : fanOutHistogram) {
+    total += count;
+  }
+  long long seen = 0;
+  for (int bucket = 0; bucket < fanOutHistogram.size(); bucket++) {
+    seen += fanOutHistogram[bucket];
+    if (2 * seen >= total && total > 0) {
+      long long lower = 1LL << bucket;
+      return bucket == 0 ? 1.0 : (lower + 2 * lower - 1) / 2.0;
+    }
+  }
+  return 0.0;
+}
+
+void StatisticsKB::addToHistogram(vector<int>* histogram, int fanOut) {
+  int bucket = 0;
+  while (fanOut > 1) {
+    fanOut >>= 1;
+    bucket++;
+  }
+  if (histogram->size() <= bucket) {
+    histogram->resize(bucket + 1, 0);
+  }
+  (*histogram)[bucket] += 1;
+}
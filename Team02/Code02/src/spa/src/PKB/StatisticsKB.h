@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Common/Common.h>
+
+#include <unordered_map>
+#include <vector>
+
+struct RsStatistics {
+  long long numPairs = 0;
+  int numDistinctLeft = 0;
+  int numDistinctRight = 0;
+
+  // bucket i counts the values with a fan-out within [2^i, 2^(i+1))
+  std::vector<int> leftFanOutHistogram;
+  std::vector<int> rightFanOutHistogram;
+
+  // only filled for positions holding statements, keyed by the entity of the
+  // statement (STATEMENT and PROG_LINE count every statement)
+  std::unordered_map<DesignEntity, long long> numPairsByLeftEntity;
+  std::unordered_map<DesignEntity, long long> numPairsByRightEntity;
+  std::unordered_map<DesignEntity, int> numDistinctLeftByEntity;
+  std::unordered_map<DesignEntity, int> numDistinctRightByEntity;
+};
+
+class StatisticsKB {
+ public:
+  // Methods for PKB
+  void computeStatistics(
+      const TablesRs& tablesRs,
+      const std::unordered_map<DesignEntity, SetOfStmts>& tableOfStmts);
+
+  // Methods for QE
+  const RsStatistics& getRsStatistics(RelationshipType rs);
+  long long getNumAssignDefUsePairs();
+
+  static bool isStmtPosition(RelationshipType rs, ParamPosition position);
+  static double getTypicalFanOut(const std::vector<int>& fanOutHistogram);
+
+ private:
+  std::unordered_map<RelationshipType, RsStatistics> tableOfRsStatistics;
+  // sum over variables of (assignments modifying it) * (assignments using it)
+  long long numAssignDefUsePairs = 0;
+
+  static void addToHistogram(std::vector<int>* histogram, int fanOut);
+};
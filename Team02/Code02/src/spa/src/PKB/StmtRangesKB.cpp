@@ -0,0 +1,173 @@
+#include "StmtRangesKB.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// DE Methods
+void StmtRangesKB::addProcRange(ProcIdx procIdx, StmtNo firstStmt,
+                                StmtNo lastStmt) {
+  if (procIdx < 0) {
+    return;
+  }
+  if (procIdx >= procRanges.size()) {
+    procRanges.resize(procIdx + 1, {-1, -1});
+  }
+  procRanges[procIdx] = {firstStmt, lastStmt};
+}
+
+void StmtRangesKB::addWhileRange(StmtNo whileStmt, StmtNo lastStmtInLoop) {
+  containers.push_back({whileStmt, lastStmtInLoop, -1});
+}
+
+void StmtRangesKB::addIfRanges(StmtNo ifStmt, StmtNo lastStmtInThen,
+                               StmtNo lastStmtInElse) {
+  containers.push_back({ifStmt, lastStmtInElse, lastStmtInThen});
+}
+
+// PKB Methods
+void StmtRangesKB::computeIndex() {
+  StmtNo maxStmt = 0;
+  for (const auto& [firstStmt, lastStmt] : procRanges) {
+    maxStmt = max(maxStmt, lastStmt);
+  }
+  procOfStmt.assign(maxStmt + 1, -1);
+  for (ProcIdx procIdx = 0; procIdx < procRanges.size(); procIdx++) {
+    const auto& [firstStmt, lastStmt] = procRanges[procIdx];
+    for (StmtNo stmt = max(firstStmt, 0); stmt <= lastStmt; stmt++) {
+      procOfStmt[stmt] = procIdx;
+    }
+  }
+
+  // inner containers start after the ones around them, so taking containers
+  // in order of their first statement leaves each statement with its
+  // innermost one
+  sort(containers.begin(), containers.end(),
+       [](const Container& left, const Container& right) {
+         return left.stmt < right.stmt;
+       });
+  containerOfStmt.assign(maxStmt + 1, -1);
+  whileOfStmt.assign(maxStmt + 1, -1);
+  for (int container = 0; container < containers.size(); container++) {
+    if (containers[container].lastStmtInThen == -1 &&
+        containers[container].stmt <= maxStmt) {
+      whileOfStmt[containers[container].stmt] = container;
+    }
+    StmtNo lastStmt = min(containers[container].lastStmt, maxStmt);
+    for (StmtNo stmt = containers[container].stmt + 1; stmt <= lastStmt;
+         stmt++) {
+      containerOfStmt[stmt] = container;
+    }
+  }
+}
+
+// QE Methods
+bool StmtRangesKB::hasRanges() { return !procOfStmt.empty(); }
+
+bool StmtRangesKB::isInRange(StmtNo stmt) {
+  return stmt >= 0 && stmt < procOfStmt.size() && procOfStmt[stmt] != -1;
+}
+
+int StmtRangesKB::getOutermostWhile(StmtNo stmt) {
+  // a while statement is part of its own loop
+  int outermostWhile = whileOfStmt[stmt];
+  for (int container = containerOfStmt[stmt]; container != -1;
+       container = containerOfStmt[containers[container].stmt]) {
+    if (containers[container].lastStmtInThen == -1) {
+      outermostWhile = container;
+    }
+  }
+  return outermostWhile;
+}
+
+bool StmtRangesKB::isNextT(StmtNo fromStmt, StmtNo toStmt) {
+  if (!isInRange(fromStmt) || !isInRange(toStmt) ||
+      procOfStmt[fromStmt] != procOfStmt[toStmt]) {
+    return false;
+  }
+  int outermostWhile = getOutermostWhile(fromStmt);
+  StmtNo lastReachedStmt = fromStmt;
+  if (outermostWhile != -1) {
+    const Container& loop = containers[outermostWhile];
+    if (toStmt >= loop.stmt && toStmt <= loop.lastStmt) {
+      return true;
+    }
+    lastReachedStmt = loop.lastStmt;
+  }
+  if (toStmt <= lastReachedStmt) {
+    return false;
+  }
+  // leaving a then branch skips its else branch
+  for (int container = containerOfStmt[fromStmt]; container != -1;
+       container = containerOfStmt[containers[container].stmt]) {
+    const Container& ifs = containers[container];
+    if (fromStmt <= ifs.lastStmtInThen && toStmt > ifs.lastStmtInThen &&
+        toStmt <= ifs.lastStmt) {
+      return false;
+    }
+  }
+  return true;
+}
+
+IntervalSet StmtRangesKB::getNextTStmts(StmtNo stmt, bool isForward) {
+  IntervalSet results;
+  if (!isInRange(stmt)) {
+    return results;
+  }
+  const auto& [firstStmtInProc, lastStmtInProc] = procRanges[procOfStmt[stmt]];
+  int outermostWhile = getOutermostWhile(stmt);
+  StmtNo loopStart = stmt;
+  StmtNo loopEnd = stmt;
+  if (outermostWhile != -1) {
+    loopStart = containers[outermostWhile].stmt;
+    loopEnd = containers[outermostWhile].lastStmt;
+  }
+
+  // branches the statement cannot reach outside the loops around it, in
+  // program order
+  vector<pair<StmtNo, StmtNo>> skippedRanges;
+  for (int container = containerOfStmt[stmt]; container != -1;
+       container = containerOfStmt[containers[container].stmt]) {
+    const Container& ifs = containers[container];
+    if (ifs.lastStmtInThen == -1) {
+      continue;
+    }
+    if (isForward && stmt <= ifs.lastStmtInThen &&
+        ifs.lastStmtInThen >= loopEnd) {
+      skippedRanges.push_back({ifs.lastStmtInThen + 1, ifs.lastStmt});
+    } else if (!isForward && stmt > ifs.lastStmtInThen &&
+               ifs.lastStmtInThen < loopStart) {
+      skippedRanges.push_back({ifs.stmt + 1, ifs.lastStmtInThen});
+    }
+  }
+  // enclosing ifs are visited from the innermost out, so their else
+  // branches come in increasing order and their then branches in decreasing
+  if (!isForward) {
+    reverse(skippedRanges.begin(), skippedRanges.end());
+  }
+
+  if (isForward) {
+    if (outermostWhile != -1) {
+      results.insertInterval(loopStart, loopEnd);
+    }
+    StmtNo nextStmt = loopEnd + 1;
+    for (const auto& [start, end] : skippedRanges) {
+      results.insertInterval(nextStmt, start - 1);
+      nextStmt = end + 1;
+    }
+    results.insertInterval(nextStmt, lastStmtInProc);
+  } else {
+    StmtNo nextStmt = firstStmtInProc;
+    for (const auto& [start, end] : skippedRanges) {
+      results.insertInterval(nextStmt, start - 1);
+      nextStmt = end + 1;
+    }
+    results.insertInterval(nextStmt, loopStart - 1);
+    if (outermostWhile != -1) {
+      results.insertInterval(loopStart, loopEnd);
+    }
+  }
+  return results;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Common/Common.h>
+#include <Common/IntervalSet.h>
+
+#include <utility>
+#include <vector>
+
+// Statements are numbered in program order, so every procedure, loop body
+// and branch is a range of them. Next* within a procedure follows from how
+// these ranges nest: a statement reaches all later statements of its
+// procedure except the else branches of the ifs it lies in the then branch
+// of, and reaches every statement of the loops around it.
+class StmtRangesKB {
+ public:
+  // Methods for DE
+  void addProcRange(ProcIdx procIdx, StmtNo firstStmt, StmtNo lastStmt);
+  void addWhileRange(StmtNo whileStmt, StmtNo lastStmtInLoop);
+  void addIfRanges(StmtNo ifStmt, StmtNo lastStmtInThen,
+                   StmtNo lastStmtInElse);
+
+  // Methods for PKB
+  // called after the ranges are added, before any of the methods below
+  void computeIndex();
+
+  // Methods for QE
+  bool hasRanges();
+  // both take time linear in how deeply the statements are nested
+  bool isNextT(StmtNo fromStmt, StmtNo toStmt);
+  IntervalSet getNextTStmts(StmtNo stmt, bool isForward);
+
+ private:
+  struct Container {
+    StmtNo stmt;
+    StmtNo lastStmt;
+    // -1 for while loops
+    StmtNo lastStmtInThen;
+  };
+
+  // [first, last] statements of each procedure by index, {-1, -1} if absent
+  std::vector<std::pair<StmtNo, StmtNo>> procRanges;
+  std::vector<Container> containers;
+
+  // procedure holding each statement, or -1
+  std::vector<ProcIdx> procOfStmt;
+  // index of the innermost while or if holding each statement, or -1
+  std::vector<int> containerOfStmt;
+  // index of the while loop of each while statement, or -1
+  std::vector<int> whileOfStmt;
+
+  bool isInRange(StmtNo stmt);
+  // the outermost while holding the statement, or -1
+  int getOutermostWhile(StmtNo stmt);
+};
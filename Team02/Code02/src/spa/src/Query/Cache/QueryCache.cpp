@@ -0,0 +1,113 @@
+#include "QueryCache.h"
+
+#include <Query/Parser/QueryLexer.h>
+#include <Query/Parser/QueryParser.h>
+
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace query;
+using namespace cache;
+using namespace qpp;
+
+QueryCache::QueryCache(PKB* pkb, size_t capacity) {
+  this->pkb = pkb;
+  this->capacity = capacity == 0 ? 1 : capacity;
+}
+
+const CachedQuery& QueryCache::GetOrParse(const string& query) {
+  // exact repeat, skip the lexer as well
+  auto rawIt = rawQueryToEntry.find(query);
+  if (rawIt != rawQueryToEntry.end()) {
+    markAsRecentlyUsed(rawIt->second);
+    return rawIt->second->cachedQuery;
+  }
+
+  string canonicalQuery = Canonicalise(query);
+  auto canonicalIt = canonicalQueryToEntry.find(canonicalQuery);
+  if (canonicalIt != canonicalQueryToEntry.end()) {
+    markAsRecentlyUsed(canonicalIt->second);
+    addRawQuery(canonicalIt->second, query);
+    return canonicalIt->second->cachedQuery;
+  }
+
+  // parse the canonical text so that every query sharing this entry sees
+  // the same synonym names; throws before anything is inserted
+  tuple<SynonymMap, SelectClause> parsedQuery =
+      QueryParser().Parse(canonicalQuery);
+  QueryOptimizer optimizer(pkb);
+  optimizer.PreprocessClauses(get<0>(parsedQuery), get<1>(parsedQuery));
+
+  if (entries.size() >= capacity) {
+    evictLeastRecentlyUsed();
+  }
+  entries.push_front(
+      {canonicalQuery,
+       {},
+       {get<0>(parsedQuery), get<1>(parsedQuery), optimizer}});
+  canonicalQueryToEntry[canonicalQuery] = entries.begin();
+  addRawQuery(entries.begin(), query);
+  return entries.front().cachedQuery;
+}
+
+string QueryCache::Canonicalise(const string& query) {
+  vector<QueryToken> tokens = get<0>(QueryLexer().Tokenize(query));
+
+  // synonyms are renamed by order of first appearance. NAMEs within quotes
+  // are program names and keywords keep their meaning, so both are kept.
+  unordered_map<string, string> nameToCanonicalName;
+  bool isWithinQuotes = false;
+  string canonicalQuery;
+  for (const QueryToken& token : tokens) {
+    string value = token.value;
+    if (token.tokenType == TokenType::CHAR_SYMBOL && value == "\"") {
+      isWithinQuotes = !isWithinQuotes;
+    } else if (!isWithinQuotes &&
+               token.tokenType == TokenType::NAME_OR_KEYWORD &&
+               !QueryParser::IsKeyword(value)) {
+      auto it = nameToCanonicalName.find(value);
+      if (it == nameToCanonicalName.end()) {
+        string canonicalName = "s" + to_string(nameToCanonicalName.size());
+        it = nameToCanonicalName.insert({value, canonicalName}).first;
+      }
+      value = it->second;
+    }
+
+    // tokens are self delimiting, so a single space keeps them apart
+    if (!canonicalQuery.empty()) {
+      canonicalQuery.push_back(' ');
+    }
+    canonicalQuery += value;
+  }
+  return canonicalQuery;
+}
+
+size_t QueryCache::GetSize() { return entries.size(); }
+
+void QueryCache::markAsRecentlyUsed(list<CacheEntry>::iterator entryIt) {
+  entries.splice(entries.begin(), entries, entryIt);
+}
+
+void QueryCache::addRawQuery(list<CacheEntry>::iterator entryIt,
+                             const string& rawQuery) {
+  if (entryIt->rawQueries.size() >= MAX_RAW_QUERIES_PER_ENTRY) {
+    return;
+  }
+  entryIt->rawQueries.push_back(rawQuery);
+  rawQueryToEntry[rawQuery] = entryIt;
+}
+
+void QueryCache::evictLeastRecentlyUsed() {
+  if (entries.empty()) {
+    return;
+  }
+  CacheEntry& leastRecentlyUsed = entries.back();
+  for (const string& rawQuery : leastRecentlyUsed.rawQueries) {
+    rawQueryToEntry.erase(rawQuery);
+  }
+  canonicalQueryToEntry.erase(leastRecentlyUsed.canonicalQuery);
+  entries.pop_back();
+}
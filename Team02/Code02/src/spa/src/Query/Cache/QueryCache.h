@@ -0,0 +1,59 @@
+#pragma once
+
+#include <PKB/PKB.h>
+#include <Query/Common.h>
+#include <Query/Optimizer/QueryOptimizer.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cache {
+struct CachedQuery {
+  query::SynonymMap synonymMap;
+  query::SelectClause selectClause;
+  // grouped and sorted plan, must be copied before use as it is consumed
+  QueryOptimizer optimizer;
+};
+
+struct CacheEntry {
+  std::string canonicalQuery;
+  std::vector<std::string> rawQueries;
+  CachedQuery cachedQuery;
+};
+}  // namespace cache
+
+// Bounded LRU cache from canonical query text to its parsed form and plan.
+// Queries that only differ in whitespace or synonym names share one entry.
+class QueryCache {
+ public:
+  explicit QueryCache(PKB* pkb, size_t capacity = DEFAULT_CAPACITY);
+
+  // returns the cached entry, parsing and planning the query on a miss.
+  // parser exceptions are propagated and nothing is cached for the query.
+  // the reference is only valid until the next call.
+  const cache::CachedQuery& GetOrParse(const std::string& query);
+  static std::string Canonicalise(const std::string& query);
+  size_t GetSize();
+
+  inline static const size_t DEFAULT_CAPACITY = 512;
+  // raw texts remembered per entry to skip lexing on exact repeats
+  inline static const size_t MAX_RAW_QUERIES_PER_ENTRY = 8;
+
+ private:
+  PKB* pkb;
+  size_t capacity;
+
+  // most recently used entry is at the front
+  std::list<cache::CacheEntry> entries;
+  std::unordered_map<std::string, std::list<cache::CacheEntry>::iterator>
+      canonicalQueryToEntry;
+  std::unordered_map<std::string, std::list<cache::CacheEntry>::iterator>
+      rawQueryToEntry;
+
+  void markAsRecentlyUsed(std::list<cache::CacheEntry>::iterator entryIt);
+  void addRawQuery(std::list<cache::CacheEntry>::iterator entryIt,
+                   const std::string& rawQuery);
+  void evictLeastRecentlyUsed();
+};
@@ -108,12 +108,23 @@ struct SelectClause {
 struct GroupDetails {
   bool isBooleanGroup;
   std::vector<Synonym> selectedSynonyms;
+  // synonyms of the group form a cycle, evaluated by a multi-way join
+  bool isCyclic = false;
   bool operator==(const GroupDetails& other) const {
     return isBooleanGroup == other.isBooleanGroup &&
-           selectedSynonyms == other.selectedSynonyms;
+           selectedSynonyms == other.selectedSynonyms &&
+           isCyclic == other.isCyclic;
   }
 };
 
+// planner estimate of a clause against what evaluating it produced
+struct ClauseExplanation {
+  ConditionClause clause;
+  unsigned long estimatedSize;
+  size_t numIncomingResults;
+  size_t numQueryResults;
+};
+
 const int FALSE_SELECT_BOOL_RESULT = 0;
 const int TRUE_SELECT_BOOL_RESULT = 1;
 
@@ -127,4 +138,20 @@ typedef std::unordered_map<std::string, int> SynonymCountsTable;
 typedef std::unordered_map<std::string, std::unordered_set<int>>
     SynonymValuesTable;
 typedef std::unordered_map<SynName, int> SynonymCountsTable;
+// bitset of the values a synonym can still take, indexed by value
+typedef std::vector<bool> CandidateDomain;
+typedef std::unordered_map<SynName, CandidateDomain> SynonymDomainsTable;
+
+// distinct values of some select synonyms, independent of all other factors
+struct ResultFactor {
+  std::vector<SynName> synonyms;
+  std::vector<std::vector<int>> rows;
+};
+
+// query results as the cross product of its factors, only expanded when the
+// output is written. for a boolean select only the truth value is used.
+struct FactorisedQueryResults {
+  bool isTrue;
+  std::vector<ResultFactor> factors;
+};
 }  // namespace query
@@ -7,13 +7,16 @@
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 using namespace std;
 using namespace query;
 
-AffectsOnDemandEvaluator::AffectsOnDemandEvaluator(PKB* pkb) {
+AffectsOnDemandEvaluator::AffectsOnDemandEvaluator(
+    PKB* pkb, WorkStealingScheduler* scheduler) {
   this->pkb = pkb;
+  this->scheduler = scheduler;
 }
 
 /* Getter Methods -------------------------------------------------------- */
@@ -45,13 +48,30 @@ unordered_set<StmtNo> AffectsOnDemandEvaluator::getAffectsInv(
 bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
                                                    const Param& left,
                                                    const Param& right) {
-  vector<StmtNo> firstStmtOfAllProcs = pkb->getFirstStmtOfAllProcs();
+  if (rsType == RelationshipType::AFFECTS_BIP) {
+    // AffectsBip is only computed whole, from procedure summaries
+    extractAllAffects(rsType);
+  }
+  if (isIndexedAffects(rsType)) {
+    if (left.type == ParamType::INTEGER_LITERAL &&
+        right.type == ParamType::INTEGER_LITERAL) {
+      return pkb->isAffects(stoi(left.value), stoi(right.value));
+    }
+    if (left.type == ParamType::INTEGER_LITERAL) {
+      return !pkb->getAffects(stoi(left.value), true).empty();
+    }
+    if (right.type == ParamType::INTEGER_LITERAL) {
+      return !pkb->getAffects(stoi(right.value), false).empty();
+    }
+    return pkb->getNumAffects() > 0;
+  }
 
   if (left.type == ParamType::INTEGER_LITERAL &&
       right.type == ParamType::INTEGER_LITERAL) {
     int leftStmt = stoi(left.value);
     int rightStmt = stoi(right.value);
-    if (isCompleteAffectsCache) {
+    if (isCompleteAffectsOfStmt(rsType, leftStmt, true) ||
+        isCompleteAffectsOfStmt(rsType, rightStmt, false)) {
       return isAffects(rsType, leftStmt, rightStmt);
     }
     // check incomplete cache
@@ -63,7 +83,21 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
         !pkb->isStmt(DesignEntity::ASSIGN, rightStmt)) {
       return false;
     }
+    // Affects never crosses procedures
+    ProcIdx leftProcIdx = pkb->getProcOfStmt(leftStmt);
+    ProcIdx rightProcIdx = pkb->getProcOfStmt(rightStmt);
+    if (rsType == RelationshipType::AFFECTS && leftProcIdx != -1 &&
+        rightProcIdx != -1 && leftProcIdx != rightProcIdx) {
+      return false;
+    }
 
+    if (rsType == RelationshipType::AFFECTS) {
+      if (isKilledOnEveryPath(leftStmt, rightStmt)) {
+        return false;
+      }
+      return searchSlicedAffects(leftStmt, true, rightStmt).count(rightStmt) >
+             0;
+    }
     LastModifiedTable LMT = {};
     extractAffects(rsType, leftStmt, rightStmt, -1, &LMT,
                    BoolParamCombo::LITERALS);
@@ -71,7 +105,7 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
   }
 
   if (left.type == ParamType::WILDCARD && right.type == ParamType::WILDCARD) {
-    if (isCompleteAffectsCache) {
+    if (isCompleteAffectsCache[rsType]) {
       return !affectsStmtPairs[rsType].empty();
     }
     // check incomplete cache
@@ -93,7 +127,7 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
 
   if (left.type == ParamType::INTEGER_LITERAL) {
     StmtNo leftStmt = stoi(left.value);
-    if (isCompleteAffectsCache) {
+    if (isCompleteAffectsOfStmt(rsType, leftStmt, true)) {
       return !getAffects(rsType, leftStmt).empty();
     }
     // check incomplete cache
@@ -105,6 +139,9 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
       return false;
     }
 
+    if (rsType == RelationshipType::AFFECTS) {
+      return !searchSlicedAffects(leftStmt, true, -1).empty();
+    }
     LastModifiedTable LMT = {};
     extractAffects(rsType, leftStmt, -1, -1, &LMT,
                    BoolParamCombo::LITERAL_WILDCARD);
@@ -113,7 +150,7 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
 
   if (right.type == ParamType::INTEGER_LITERAL) {
     StmtNo rightStmt = stoi(right.value);
-    if (isCompleteAffectsCache) {
+    if (isCompleteAffectsOfStmt(rsType, rightStmt, false)) {
       return !getAffectsInv(rsType, rightStmt).empty();
     }
     // check incomplete cache
@@ -125,14 +162,11 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
       return false;
     }
 
-    // check through all procs until a2 has been visited
-    for (auto firstStmt : firstStmtOfAllProcs) {
-      // skip proc if its first stmt is already larger than a2
-      // means a2 is unreachable
-      if (firstStmt > rightStmt) {
-        continue;
-      }
-
+    if (rsType == RelationshipType::AFFECTS) {
+      return !searchSlicedAffects(rightStmt, false, -1).empty();
+    }
+    // check through the procs that may hold a2 until it has been visited
+    for (auto firstStmt : getFirstStmtsOfProcsHolding(rightStmt)) {
       LastModifiedTable LMT = {};
       extractAffects(rsType, firstStmt, rightStmt, -1, &LMT,
                      BoolParamCombo::WILDCARD_LITERAL);
@@ -152,14 +186,26 @@ bool AffectsOnDemandEvaluator::evaluateBoolAffects(RelationshipType rsType,
 // synonym & integer literal - Affects(a1, 2), Affects(1, a2)
 unordered_set<StmtNo> AffectsOnDemandEvaluator::evaluateStmtAffects(
     RelationshipType rsType, const Param& left, const Param& right) {
+  if (rsType == RelationshipType::AFFECTS_BIP) {
+    extractAllAffects(rsType);
+  }
+  if (isIndexedAffects(rsType)) {
+    if (left.type == ParamType::INTEGER_LITERAL) {
+      return pkb->getAffects(stoi(left.value), true);
+    }
+    return pkb->getAffects(stoi(right.value), false);
+  }
   if (left.type == ParamType::INTEGER_LITERAL) {
     StmtNo leftStmt = stoi(left.value);
-    if (isCompleteAffectsCache) {
+    if (isCompleteAffectsOfStmt(rsType, leftStmt, true)) {
       return getAffects(rsType, leftStmt);
     }
     if (!pkb->isStmt(DesignEntity::ASSIGN, leftStmt)) {
       return {};
     }
+    if (rsType == RelationshipType::AFFECTS) {
+      return searchSlicedAffects(leftStmt, true, -1);
+    }
 
     LastModifiedTable LMT = {};
     extractAffects(rsType, leftStmt, -1, -1, &LMT, {});
@@ -167,22 +213,18 @@ unordered_set<StmtNo> AffectsOnDemandEvaluator::evaluateStmtAffects(
 
   } else {
     StmtNo rightStmt = stoi(right.value);
-    if (isCompleteAffectsCache) {
+    if (isCompleteAffectsOfStmt(rsType, rightStmt, false)) {
       return getAffectsInv(rsType, rightStmt);
     }
     if (!pkb->isStmt(DesignEntity::ASSIGN, rightStmt)) {
       return {};
     }
+    if (rsType == RelationshipType::AFFECTS) {
+      return searchSlicedAffects(rightStmt, false, -1);
+    }
 
-    vector<StmtNo> firstStmtOfAllProcs = pkb->getFirstStmtOfAllProcs();
-    // check through all procs until a2 has been visited
-    for (auto firstStmt : firstStmtOfAllProcs) {
-      // skip proc if its first stmt is already larger than a2
-      // means a2 is unreachable
-      if (firstStmt > rightStmt) {
-        continue;
-      }
-
+    // check through the procs that may hold a2 until it has been visited
+    for (auto firstStmt : getFirstStmtsOfProcsHolding(rightStmt)) {
       LastModifiedTable LMT = {};
       extractAffects(rsType, firstStmt, -1, -1, &LMT, {});
 
@@ -198,21 +240,15 @@ unordered_set<StmtNo> AffectsOnDemandEvaluator::evaluateStmtAffects(
 // Affects(a1, _), Affects(_, a2)
 ClauseIncomingResults AffectsOnDemandEvaluator::evaluateSynonymWildcard(
     RelationshipType rsType, const Param& left, const Param& right) {
-  if (isCompleteAffectsCache) {
+  if (isCompleteAffectsCache[rsType]) {
     if (left.type == ParamType::SYNONYM) {
       return affectsLeftStmtPairs[rsType];
     } else {
       return affectsRightStmtPairs[rsType];
     }
   }
-  vector<StmtNo> firstStmtOfAllProcs = pkb->getFirstStmtOfAllProcs();
-
   // get all Affects and return either a1 or a2
-  for (auto firstStmt : firstStmtOfAllProcs) {
-    LastModifiedTable LMT = {};
-    extractAffects(rsType, firstStmt, -1, -1, &LMT, {});
-  }
-  isCompleteAffectsCache = true;
+  extractAllAffects(rsType);
   if (left.type == ParamType::SYNONYM) {
     return affectsLeftStmtPairs[rsType];
   } else {
@@ -227,111 +263,209 @@ ClauseIncomingResults AffectsOnDemandEvaluator::evaluatePairAffects(
     return evaluateSynonymWildcard(rsType, left, right);
   }
 
-  if (isCompleteAffectsCache) {
+  if (isCompleteAffectsCache[rsType]) {
     return affectsStmtPairs[rsType];
   }
-  vector<StmtNo> firstStmtOfAllProcs = pkb->getFirstStmtOfAllProcs();
-
   // get all Affects and return (a1, a2)
-  for (auto firstStmt : firstStmtOfAllProcs) {
+  extractAllAffects(rsType);
+  return affectsStmtPairs[rsType];
+}
+
+void AffectsOnDemandEvaluator::cacheAffectsOfStmts(
+    const unordered_set<StmtNo>& stmts) {
+  RelationshipType rsType = RelationshipType::AFFECTS;
+  if (isIndexedAffects(rsType)) {
+    return;
+  }
+  unordered_set<ProcIdx> procs;
+  vector<StmtNo> uncachedStmts;
+  for (StmtNo stmt : stmts) {
+    if (completeAffectsStmts.count(stmt) > 0 ||
+        !pkb->isStmt(DesignEntity::ASSIGN, stmt)) {
+      continue;
+    }
+    ProcIdx procIdx = pkb->getProcOfStmt(stmt);
+    if (procIdx == -1) {
+      // without the procedure of each statement, every procedure is walked
+      extractAllAffects(rsType);
+      return;
+    }
+    procs.insert(procIdx);
+    uncachedStmts.push_back(stmt);
+  }
+
+  // Affects stays within a procedure, so one walk from its start finds all
+  // pairs of every statement in it
+  for (ProcIdx procIdx : procs) {
     LastModifiedTable LMT = {};
-    extractAffects(rsType, firstStmt, -1, -1, &LMT, {});
+    extractAffects(rsType, pkb->getFirstStmtOfProc(procIdx), -1, -1, &LMT, {});
   }
-  isCompleteAffectsCache = true;
-  return affectsStmtPairs[rsType];
+  completeAffectsStmts.insert(uncachedStmts.begin(), uncachedStmts.end());
 }
 
-bool AffectsOnDemandEvaluator::evaluateBoolAffectsT(const query::Param& left,
-                                                    const query::Param& right) {
-  if (left.type == ParamType::WILDCARD || right.type == ParamType::WILDCARD) {
-    return evaluateBoolAffects(RelationshipType::AFFECTS, left, right);
+bool AffectsOnDemandEvaluator::isIndexedAffects(RelationshipType rsType) {
+  return rsType == RelationshipType::AFFECTS && pkb->hasDefUseIndex();
+}
+
+bool AffectsOnDemandEvaluator::isCompleteAffectsOfStmt(RelationshipType rsType,
+                                                       StmtNo stmt,
+                                                       bool isForward) {
+  if (isCompleteAffectsCache[rsType]) {
+    return true;
   }
+  if (rsType != RelationshipType::AFFECTS) {
+    return false;
+  }
+  const unordered_set<StmtNo>& slicedStmts =
+      isForward ? slicedAffectsStmts : slicedAffectsInvStmts;
+  return completeAffectsStmts.count(stmt) > 0 || slicedStmts.count(stmt) > 0;
+}
 
-  // literals only
-  if (isCompleteAffectsTCache) {
-    return tableOfAffects[RelationshipType::AFFECTS_T]
-               .at(stoi(left.value))
-               .count(stoi(right.value)) > 0;
-  }
-  unordered_set<StmtNo> visited;
-  return evalBoolLitAffectsT(left, right, &visited);
-}
-
-bool AffectsOnDemandEvaluator::evalBoolLitAffectsT(
-    const query::Param& left, const query::Param& right,
-    unordered_set<StmtNo>* visited) {
-  bool hasFoundAffectsT =
-      evaluateBoolAffects(RelationshipType::AFFECTS, left, right);
-  bool allCombosTested = false;
-  while (!hasFoundAffectsT && !allCombosTested) {
-    unordered_set<StmtNo> affectedStmts;
-    unordered_set<StmtNo> visitedStmts;
-    try {
-      affectedStmts =
-          tableOfAffects[RelationshipType::AFFECTS].at(stoi(left.value));
-    } catch (const out_of_range& e) {
-      break;
-    }
-    for (StmtNo affectedStmt : affectedStmts) {
-      if (affectedStmt == stoi(left.value) ||
-          visited->count(affectedStmt) > 0) {
+bool AffectsOnDemandEvaluator::isKilledOnEveryPath(StmtNo a1, StmtNo a2) {
+  if (!pkb->hasDominators()) {
+    return false;
+  }
+  // a path from a1 to a2 missing a kill that post-dominates a1 but not a2
+  // would join a path from a2 to the exit missing it. likewise one missing a
+  // kill that dominates a2 but not a1 would follow a path from the entry.
+  for (VarIdx varIdx : pkb->getRight(RelationshipType::MODIFIES_S, a1)) {
+    for (StmtNo killStmt :
+         pkb->getLeft(RelationshipType::MODIFIES_S, varIdx)) {
+      if (killStmt == a1 || killStmt == a2 ||
+          !(pkb->isStmt(DesignEntity::ASSIGN, killStmt) ||
+            pkb->isStmt(DesignEntity::READ, killStmt) ||
+            pkb->isStmt(DesignEntity::CALL, killStmt))) {
         continue;
       }
-      visited->insert(affectedStmt);
-      Param newParam{ParamType::INTEGER_LITERAL, to_string(affectedStmt)};
-      hasFoundAffectsT = evalBoolLitAffectsT(newParam, right, visited);
-      if (hasFoundAffectsT) {
-        break;
+      if ((pkb->isPostDominator(killStmt, a1) &&
+           !pkb->isPostDominator(killStmt, a2)) ||
+          (pkb->isDominator(killStmt, a2) &&
+           !pkb->isDominator(killStmt, a1))) {
+        return true;
       }
     }
-    if (!hasFoundAffectsT) {
-      allCombosTested = true;
+  }
+  return false;
+}
+
+unordered_set<StmtNo> AffectsOnDemandEvaluator::searchSlicedAffects(
+    StmtNo stmt, bool isForward, StmtNo targetStmt) {
+  // a1 only affects through the variable it modifies, and a2 is affected
+  // through each variable it uses on its own, so every other variable is
+  // left out of the walk
+  RelationshipType rsType = RelationshipType::AFFECTS;
+  unordered_set<StmtNo> results;
+  unordered_set<VarIdx> vars = pkb->getRight(
+      isForward ? RelationshipType::MODIFIES_S : RelationshipType::USES_S,
+      stmt);
+  for (VarIdx varIdx : vars) {
+    unordered_set<StmtNo> visitedStmts;
+    queue<StmtNo> stmtQueue;
+    stmtQueue.push(stmt);
+    while (!stmtQueue.empty()) {
+      StmtNo currStmt = stmtQueue.front();
+      stmtQueue.pop();
+      for (StmtNo adjacentStmt :
+           isForward ? pkb->getRight(RelationshipType::NEXT, currStmt)
+                     : pkb->getLeft(RelationshipType::NEXT, currStmt)) {
+        if (!visitedStmts.insert(adjacentStmt).second) {
+          continue;
+        }
+        bool isAssign = pkb->isStmt(DesignEntity::ASSIGN, adjacentStmt);
+        // containers modify what their nested stmts do, which are walked
+        // themselves
+        bool isKill = (isAssign ||
+                       pkb->isStmt(DesignEntity::READ, adjacentStmt) ||
+                       pkb->isStmt(DesignEntity::CALL, adjacentStmt)) &&
+                      pkb->isRs(RelationshipType::MODIFIES_S, adjacentStmt,
+                                varIdx);
+        if (isForward && isAssign &&
+            pkb->isRs(RelationshipType::USES_S, adjacentStmt, varIdx)) {
+          results.insert(adjacentStmt);
+          addAffectsRelationship(rsType, nullptr, stmt, adjacentStmt);
+        } else if (!isForward && isAssign && isKill) {
+          results.insert(adjacentStmt);
+          addAffectsRelationship(rsType, nullptr, adjacentStmt, stmt);
+        }
+        if (targetStmt != -1 && results.count(targetStmt) > 0) {
+          return results;
+        }
+        if (!isKill) {
+          stmtQueue.push(adjacentStmt);
+        }
+      }
+    }
+  }
+  if (targetStmt == -1) {
+    if (isForward) {
+      slicedAffectsStmts.insert(stmt);
+    } else {
+      slicedAffectsInvStmts.insert(stmt);
     }
   }
-  return hasFoundAffectsT;
+  return results;
+}
+
+bool AffectsOnDemandEvaluator::evaluateBoolAffectsT(const query::Param& left,
+                                                    const query::Param& right) {
+  if (left.type == ParamType::WILDCARD || right.type == ParamType::WILDCARD) {
+    return evaluateBoolAffects(RelationshipType::AFFECTS, left, right);
+  }
+
+  // literals only
+  StmtNo leftStmt = stoi(left.value);
+  StmtNo rightStmt = stoi(right.value);
+  if (isCompleteAffectsCache[RelationshipType::AFFECTS_T]) {
+    return isAffects(RelationshipType::AFFECTS_T, leftStmt, rightStmt);
+  }
+  if (evaluateBoolAffects(RelationshipType::AFFECTS, left, right)) {
+    return true;
+  }
+  return searchAffectsT(leftStmt, true, rightStmt).count(rightStmt) > 0;
 }
 
 // Affects(a, 2), (1, a)
 unordered_set<StmtNo> AffectsOnDemandEvaluator::evaluateStmtAffectsT(
     const query::Param& left, const query::Param& right) {
-  if (isCompleteAffectsTCache) {
-    if (left.type == ParamType::INTEGER_LITERAL) {
-      return tableOfAffects[RelationshipType::AFFECTS_T].at(stoi(left.value));
-    } else {
-      return tableOfAffectsInv[RelationshipType::AFFECTS_T].at(
-          stoi(right.value));
+  if (left.type == ParamType::INTEGER_LITERAL) {
+    StmtNo leftStmt = stoi(left.value);
+    if (isCompleteAffectsCache[RelationshipType::AFFECTS_T]) {
+      return getAffects(RelationshipType::AFFECTS_T, leftStmt);
     }
+    return searchAffectsT(leftStmt, true, -1);
   }
-  unordered_set<StmtNo> visited;
-  return evaluateStmtAffectsTHelper(left, right, &visited);
+  StmtNo rightStmt = stoi(right.value);
+  if (isCompleteAffectsCache[RelationshipType::AFFECTS_T]) {
+    return getAffectsInv(RelationshipType::AFFECTS_T, rightStmt);
+  }
+  return searchAffectsT(rightStmt, false, -1);
 }
 
-unordered_set<StmtNo> AffectsOnDemandEvaluator::evaluateStmtAffectsTHelper(
-    const query::Param& left, const query::Param& right,
-    unordered_set<StmtNo>* visited) {
-  unordered_set<StmtNo> result;
-  unordered_set<StmtNo> firstLayer =
-      evaluateStmtAffects(RelationshipType::AFFECTS, left, right);
-  for (StmtNo affected : firstLayer) {
-    if (visited->count(affected) > 0) {
-      continue;
-    }
-    result.insert(affected);
-    visited->insert(affected);
-    Param newParam = {ParamType::INTEGER_LITERAL, to_string(affected)};
-    if (left.type == ParamType::INTEGER_LITERAL) {
-      if (stoi(left.value) == affected) {
+unordered_set<StmtNo> AffectsOnDemandEvaluator::searchAffectsT(
+    StmtNo startStmt, bool isForward, StmtNo targetStmt) {
+  // breadth first over Affects, one layer at a time from the Affects cache
+  unordered_set<StmtNo> reachedStmts;
+  queue<StmtNo> stmtQueue;
+  stmtQueue.push(startStmt);
+  Param synonym = {ParamType::SYNONYM, "a"};
+  while (!stmtQueue.empty()) {
+    Param stmt = {ParamType::INTEGER_LITERAL, to_string(stmtQueue.front())};
+    stmtQueue.pop();
+    unordered_set<StmtNo> nextStmts =
+        isForward
+            ? evaluateStmtAffects(RelationshipType::AFFECTS, stmt, synonym)
+            : evaluateStmtAffects(RelationshipType::AFFECTS, synonym, stmt);
+    for (StmtNo nextStmt : nextStmts) {
+      if (!reachedStmts.insert(nextStmt).second) {
         continue;
       }
-      result.merge(evaluateStmtAffectsTHelper(newParam, right, visited));
-    } else {
-      if (stoi(right.value) == affected) {
-        continue;
+      if (nextStmt == targetStmt) {
+        return reachedStmts;
       }
-      result.merge(evaluateStmtAffectsTHelper(left, newParam, visited));
+      stmtQueue.push(nextStmt);
     }
   }
-  return result;
+  return reachedStmts;
 }
 
 ClauseIncomingResults AffectsOnDemandEvaluator::evaluatePairAffectsT(
@@ -342,73 +476,350 @@ ClauseIncomingResults AffectsOnDemandEvaluator::evaluatePairAffectsT(
   }
 
   // Affects(a1, a2)
-  if (isCompleteAffectsTCache) {
+  if (isCompleteAffectsCache[RelationshipType::AFFECTS_T]) {
     return affectsStmtPairs[RelationshipType::AFFECTS_T];
   }
 
-  populateAffectsTCache(left, right);
-  ClauseIncomingResults result;
-  for (auto it : tableOfAffects[RelationshipType::AFFECTS_T]) {
-    StmtNo curr = it.first;
-    for (StmtNo affectedT : it.second) {
-      vector<StmtNo> currPair{curr, affectedT};
-      result.insert(currPair);
+  populateAffectsTCache(RelationshipType::AFFECTS_T);
+  return affectsStmtPairs[RelationshipType::AFFECTS_T];
+}
+
+bool AffectsOnDemandEvaluator::evaluateBoolAffectsBipT(const Param& left,
+                                                       const Param& right) {
+  if (left.type == ParamType::WILDCARD || right.type == ParamType::WILDCARD) {
+    return evaluateBoolAffects(RelationshipType::AFFECTS_BIP, left, right);
+  }
+  populateAffectsTCache(RelationshipType::AFFECTS_BIP_T);
+  return isAffects(RelationshipType::AFFECTS_BIP_T, stoi(left.value),
+                   stoi(right.value));
+}
+
+unordered_set<StmtNo> AffectsOnDemandEvaluator::evaluateStmtAffectsBipT(
+    const Param& left, const Param& right) {
+  populateAffectsTCache(RelationshipType::AFFECTS_BIP_T);
+  if (left.type == ParamType::INTEGER_LITERAL) {
+    return getAffects(RelationshipType::AFFECTS_BIP_T, stoi(left.value));
+  }
+  return getAffectsInv(RelationshipType::AFFECTS_BIP_T, stoi(right.value));
+}
+
+ClauseIncomingResults AffectsOnDemandEvaluator::evaluatePairAffectsBipT(
+    const Param& left, const Param& right) {
+  if (left.type == ParamType::WILDCARD || right.type == ParamType::WILDCARD) {
+    return evaluateSynonymWildcard(RelationshipType::AFFECTS_BIP, left, right);
+  }
+  populateAffectsTCache(RelationshipType::AFFECTS_BIP_T);
+  return affectsStmtPairs[RelationshipType::AFFECTS_BIP_T];
+}
+
+void AffectsOnDemandEvaluator::populateAffectsTCache(RelationshipType rsType) {
+  if (isCompleteAffectsCache[rsType]) {
+    return;
+  }
+  RelationshipType affectsRsType = rsType == RelationshipType::AFFECTS_T
+                                       ? RelationshipType::AFFECTS
+                                       : RelationshipType::AFFECTS_BIP;
+  if (!isCompleteAffectsCache[affectsRsType]) {
+    extractAllAffects(affectsRsType);
+  }
+
+  // statements of the Affects graph, numbered densely
+  const unordered_map<StmtNo, unordered_set<StmtNo>>& affectsGraph =
+      tableOfAffects[affectsRsType];
+  vector<StmtNo> stmts;
+  unordered_map<StmtNo, int> stmtToNode;
+  for (const auto& stmtAndAffected : affectsGraph) {
+    for (StmtNo stmt : stmtAndAffected.second) {
+      if (stmtToNode.insert({stmt, stmts.size()}).second) {
+        stmts.push_back(stmt);
+      }
+    }
+    if (stmtToNode.insert({stmtAndAffected.first, stmts.size()}).second) {
+      stmts.push_back(stmtAndAffected.first);
+    }
+  }
+  vector<vector<int>> successors(stmts.size());
+  for (const auto& stmtAndAffected : affectsGraph) {
+    vector<int>& nodeSuccessors = successors[stmtToNode[stmtAndAffected.first]];
+    for (StmtNo affected : stmtAndAffected.second) {
+      nodeSuccessors.push_back(stmtToNode[affected]);
+    }
+  }
+
+  // statements on a cycle reach each other, so reachability is propagated
+  // between strongly connected components, each completed before any
+  // component reaching it
+  vector<vector<int>> components = getStronglyConnectedComponents(successors);
+  int numWords = (stmts.size() + 63) / 64;
+  vector<int> nodeToComponent(stmts.size());
+  for (int c = 0; c < components.size(); c++) {
+    for (int node : components[c]) {
+      nodeToComponent[node] = c;
+    }
+  }
+  vector<vector<unsigned long long>> reachable(
+      components.size(), vector<unsigned long long>(numWords, 0));
+  for (int c = 0; c < components.size(); c++) {
+    for (int node : components[c]) {
+      for (int successor : successors[node]) {
+        int successorComponent = nodeToComponent[successor];
+        reachable[c][successor / 64] |= 1ULL << (successor % 64);
+        if (successorComponent != c) {
+          for (int w = 0; w < numWords; w++) {
+            reachable[c][w] |= reachable[successorComponent][w];
+          }
+        }
+      }
+    }
+    // any member of a cycle reaches every other member and itself
+    if (components[c].size() > 1) {
+      for (int node : components[c]) {
+        reachable[c][node / 64] |= 1ULL << (node % 64);
+      }
+    }
+  }
+
+  // both directions are read off the same bitsets
+  unordered_map<StmtNo, unordered_set<StmtNo>>& tableOfAffectsT =
+      tableOfAffects[rsType];
+  unordered_map<StmtNo, unordered_set<StmtNo>>& tableOfAffectsTInv =
+      tableOfAffectsInv[rsType];
+  ClauseIncomingResults& affectsTStmtPairs = affectsStmtPairs[rsType];
+  for (int node = 0; node < stmts.size(); node++) {
+    const vector<unsigned long long>& words =
+        reachable[nodeToComponent[node]];
+    for (int w = 0; w < numWords; w++) {
+      unsigned long long word = words[w];
+      while (word != 0) {
+        int reachedNode = w * 64 + __builtin_ctzll(word);
+        word &= word - 1;
+        tableOfAffectsT[stmts[node]].insert(stmts[reachedNode]);
+        tableOfAffectsTInv[stmts[reachedNode]].insert(stmts[node]);
+        affectsTStmtPairs.insert({stmts[node], stmts[reachedNode]});
+      }
+    }
+  }
+  isCompleteAffectsCache[rsType] = true;
+}
+
+vector<vector<int>> AffectsOnDemandEvaluator::getStronglyConnectedComponents(
+    const vector<vector<int>>& successors) {
+  // Tarjan's algorithm with an explicit stack of (node, next successor), so
+  // long chains of Affects cannot overflow the call stack. components are
+  // found in reverse topological order.
+  int numNodes = successors.size();
+  vector<int> indices(numNodes, -1);
+  vector<int> lowLinks(numNodes, 0);
+  vector<bool> isOnStack(numNodes, false);
+  vector<int> componentStack;
+  vector<pair<int, int>> callStack;
+  vector<vector<int>> components;
+  int nextIndex = 0;
+
+  for (int root = 0; root < numNodes; root++) {
+    if (indices[root] != -1) {
+      continue;
+    }
+    callStack.push_back({root, 0});
+    while (!callStack.empty()) {
+      int node = callStack.back().first;
+      int& successorIndex = callStack.back().second;
+      if (successorIndex == 0) {
+        indices[node] = lowLinks[node] = nextIndex++;
+        componentStack.push_back(node);
+        isOnStack[node] = true;
+      }
+
+      if (successorIndex < successors[node].size()) {
+        int successor = successors[node][successorIndex++];
+        if (indices[successor] == -1) {
+          callStack.push_back({successor, 0});
+        } else if (isOnStack[successor]) {
+          lowLinks[node] = min(lowLinks[node], indices[successor]);
+        }
+        continue;
+      }
+
+      if (lowLinks[node] == indices[node]) {
+        vector<int> component;
+        int member;
+        do {
+          member = componentStack.back();
+          componentStack.pop_back();
+          isOnStack[member] = false;
+          component.push_back(member);
+        } while (member != node);
+        components.push_back(component);
+      }
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        int parent = callStack.back().first;
+        lowLinks[parent] = min(lowLinks[parent], lowLinks[node]);
+      }
     }
   }
-  affectsStmtPairs[RelationshipType::AFFECTS_T] = result;
-  return result;
+  return components;
 }
 
-void AffectsOnDemandEvaluator::populateAffectsTCache(const Param& left,
-                                                     const Param& right) {
-  if (!isCompleteAffectsCache) {
-    // ensure affects cache is populated first
-    evaluatePairAffects(RelationshipType::AFFECTS, left, right);
+vector<StmtNo> AffectsOnDemandEvaluator::getFirstStmtsOfProcsHolding(
+    StmtNo stmt) {
+  ProcIdx procIdx = pkb->getProcOfStmt(stmt);
+  if (procIdx != -1) {
+    return {pkb->getFirstStmtOfProc(procIdx)};
+  }
+  // without procedures of stmts, any proc starting no later than the stmt
+  vector<StmtNo> results;
+  for (StmtNo firstStmt : pkb->getFirstStmtOfAllProcs()) {
+    if (firstStmt <= stmt) {
+      results.push_back(firstStmt);
+    }
   }
-  populateAffectsTTable(&tableOfAffects[RelationshipType::AFFECTS_T],
-                        &tableOfAffects[RelationshipType::AFFECTS]);
-  populateAffectsTTable(&tableOfAffectsInv[RelationshipType::AFFECTS_T],
-                        &tableOfAffectsInv[RelationshipType::AFFECTS]);
-  isCompleteAffectsTCache = true;
+  return results;
 }
 
-void AffectsOnDemandEvaluator::populateAffectsTTable(
-    unordered_map<StmtNo, unordered_set<StmtNo>>* target,
-    unordered_map<StmtNo, unordered_set<StmtNo>>* base) {
-  for (auto it : *base) {
-    StmtNo currStmt = it.first;
-    unordered_set<StmtNo> affectedStmts = it.second;
-    unordered_set<StmtNo> visitedForCurr;
-    for (StmtNo affectedStmt : affectedStmts) {
-      populateAffectsTTableHelper(currStmt, affectedStmt, &visitedForCurr,
-                                  base);
+/* Affects Extraction Method ---------------------------------------------- */
+void AffectsOnDemandEvaluator::extractAllAffects(RelationshipType rsType) {
+  if (isCompleteAffectsCache[rsType]) {
+    return;
+  }
+  if (rsType == RelationshipType::AFFECTS_BIP) {
+    extractAllAffectsBip();
+    isCompleteAffectsCache[rsType] = true;
+    return;
+  }
+  if (isIndexedAffects(rsType)) {
+    for (StmtNo a1 : pkb->getAllStmts(DesignEntity::ASSIGN)) {
+      for (StmtNo a2 : pkb->getAffects(a1, true)) {
+        addAffectsRelationship(rsType, nullptr, a1, a2);
+      }
     }
-    target->insert({currStmt, visitedForCurr});
+    isCompleteAffectsCache[rsType] = true;
+    return;
+  }
+  vector<StmtNo> firstStmtOfAllProcs = pkb->getFirstStmtOfAllProcs();
+  int numWorkers = scheduler->getNumWorkers();
+  if (numWorkers == 1 || firstStmtOfAllProcs.size() <= 1) {
+    for (auto firstStmt : firstStmtOfAllProcs) {
+      LastModifiedTable LMT = {};
+      extractAffects(rsType, firstStmt, -1, -1, &LMT, {});
+    }
+    isCompleteAffectsCache[rsType] = true;
+    return;
+  }
+
+  // procedures are extracted in parallel, each worker into tables of its own
+  // that are merged into the caches once all are done
+  vector<AffectsOnDemandEvaluator> workerEvaluators(
+      numWorkers, AffectsOnDemandEvaluator(pkb, scheduler));
+  scheduler->run(firstStmtOfAllProcs.size(), [&](int task, int worker) {
+    LastModifiedTable LMT = {};
+    workerEvaluators[worker].extractAffects(rsType, firstStmtOfAllProcs[task],
+                                            -1, -1, &LMT, {});
+  });
+  for (const AffectsOnDemandEvaluator& workerEvaluator : workerEvaluators) {
+    mergeAffects(rsType, workerEvaluator);
+  }
+  isCompleteAffectsCache[rsType] = true;
+}
+
+void AffectsOnDemandEvaluator::mergeAffects(
+    RelationshipType rsType, const AffectsOnDemandEvaluator& other) {
+  allVisitedStmts.insert(other.allVisitedStmts.begin(),
+                         other.allVisitedStmts.end());
+  for (const vector<int>& pair : other.affectsStmtPairs.at(rsType)) {
+    addAffectsRelationship(rsType, nullptr, pair.front(), pair.back());
   }
 }
 
-void AffectsOnDemandEvaluator::populateAffectsTTableHelper(
-    StmtNo orig, StmtNo affected, unordered_set<StmtNo>* visited,
-    unordered_map<StmtNo, unordered_set<StmtNo>>* base) {
-  if (visited->count(affected) > 0) {
+void AffectsOnDemandEvaluator::extractAllAffectsBip() {
+  // a call is stepped over by applying the summary of its callee, so every
+  // procedure body is walked exactly once however many paths reach it
+  vector<ProcIdx> topoSortedProcs = pkb->getTopoSortedProcs();
+  for (auto it = topoSortedProcs.rbegin(); it != topoSortedProcs.rend(); it++) {
+    getProcedureSummary(*it);
+  }
+}
+
+const ProcedureSummary& AffectsOnDemandEvaluator::getProcedureSummary(
+    ProcIdx procIdx) {
+  auto summaryIt = procSummaries.find(procIdx);
+  if (summaryIt != procSummaries.end()) {
+    return summaryIt->second;
+  }
+
+  // every variable the procedure touches holds its entry value at first
+  LastModifiedTable LMT = {};
+  for (RelationshipType rs :
+       {RelationshipType::MODIFIES_P, RelationshipType::USES_P}) {
+    for (VarIdx varIdx : pkb->getRight(rs, procIdx)) {
+      LMT[varIdx] = {getEntryDef(varIdx)};
+    }
+  }
+  ProcedureSummary summary;
+  ProcedureSummary* callerSummary = summaryInProgress;
+  summaryInProgress = &summary;
+  StmtNo firstStmt = pkb->getFirstStmtOfProc(procIdx);
+  if (firstStmt != -1) {
+    extractAffects(RelationshipType::AFFECTS_BIP, firstStmt, -1, -1, &LMT, {});
+  }
+  summaryInProgress = callerSummary;
+
+  for (const auto& varAndStmts : LMT) {
+    VarIdx varIdx = varAndStmts.first;
+    if (varAndStmts.second.count(getEntryDef(varIdx)) == 0) {
+      summary.killedVars.insert(varIdx);
+    }
+    for (StmtNo stmt : varAndStmts.second) {
+      if (pkb->isStmt(DesignEntity::ASSIGN, stmt)) {
+        summary.exitDefs[varIdx].insert(stmt);
+      }
+    }
+  }
+  return procSummaries.insert({procIdx, summary}).first->second;
+}
+
+void AffectsOnDemandEvaluator::applyProcedureSummary(StmtNo callStmt,
+                                                     LastModifiedTable* LMT) {
+  ProcIdx calleeIdx = pkb->getNameAttribute(DesignEntity::CALL, callStmt);
+  if (calleeIdx == -1) {
+    updateLastModifiedVariables(callStmt, LMT);
     return;
   }
-  visited->insert(affected);
-  if (orig != affected) {
-    unordered_set<StmtNo> nextLayer;
-    if (base->find(affected) != base->end()) {
-      nextLayer = base->at(affected);
-      for (StmtNo nextLayerAffects : nextLayer) {
-        if (affected != nextLayerAffects) {
-          populateAffectsTTableHelper(orig, nextLayerAffects, visited, base);
+  const ProcedureSummary& callee = getProcedureSummary(calleeIdx);
+
+  // definitions reaching the call affect the uses reached from callee entry
+  for (const auto& varAndUses : callee.entryUses) {
+    auto defsIt = LMT->find(varAndUses.first);
+    if (defsIt == LMT->end()) {
+      continue;
+    }
+    for (StmtNo def : defsIt->second) {
+      for (StmtNo use : varAndUses.second) {
+        if (isEntryDef(def)) {
+          summaryInProgress->entryUses[varAndUses.first].insert(use);
+        } else if (pkb->isStmt(DesignEntity::ASSIGN, def)) {
+          addAffectsRelationship(RelationshipType::AFFECTS_BIP, LMT, def, use);
         }
       }
     }
   }
+
+  for (VarIdx killedVar : callee.killedVars) {
+    (*LMT)[killedVar] = {callStmt};
+  }
+  for (const auto& varAndDefs : callee.exitDefs) {
+    (*LMT)[varAndDefs.first].insert(varAndDefs.second.begin(),
+                                    varAndDefs.second.end());
+  }
 }
 
-/* Affects Extraction Method ---------------------------------------------- */
-// affects & affects bip?
+StmtNo AffectsOnDemandEvaluator::getEntryDef(VarIdx varIdx) {
+  // below -1, which already marks the end of a walk
+  return -2 - varIdx;
+}
+
+bool AffectsOnDemandEvaluator::isEntryDef(StmtNo stmt) { return stmt < -1; }
+
 void AffectsOnDemandEvaluator::extractAffects(RelationshipType rsType,
                                               StmtNo startStmt,
                                               StmtNo endStmt,
@@ -429,8 +840,11 @@ void AffectsOnDemandEvaluator::extractAffects(RelationshipType rsType,
     }
     allVisitedStmts.insert(currStmt);
 
-    if (pkb->isStmt(DesignEntity::READ, currStmt) ||
+    if (rsType == RelationshipType::AFFECTS_BIP &&
         pkb->isStmt(DesignEntity::CALL, currStmt)) {
+      applyProcedureSummary(currStmt, LMT);
+    } else if (pkb->isStmt(DesignEntity::READ, currStmt) ||
+               pkb->isStmt(DesignEntity::CALL, currStmt)) {
       updateLastModifiedVariables(currStmt, LMT);
     }
 
@@ -484,6 +898,8 @@ void AffectsOnDemandEvaluator::processAssignStmt(RelationshipType rsType,
       for (StmtNo LMTStmt : LMTStmts) {
         if (pkb->isStmt(DesignEntity::ASSIGN, LMTStmt)) {
           addAffectsRelationship(rsType, LMT, LMTStmt, currStmt);
+        } else if (isEntryDef(LMTStmt) && summaryInProgress != nullptr) {
+          summaryInProgress->entryUses[usedVar].insert(currStmt);
         }
       }
     }
@@ -602,10 +1018,10 @@ LastModifiedTable AffectsOnDemandEvaluator::mergeLMT(
 
 RelationshipType AffectsOnDemandEvaluator::getCFGRsType(
     RelationshipType rsType) {
-  if (rsType == RelationshipType::AFFECTS) {
+  // AffectsBip walks one procedure at a time too, stepping over calls
+  if (rsType == RelationshipType::AFFECTS ||
+      rsType == RelationshipType::AFFECTS_BIP) {
     return RelationshipType::NEXT;
-  } else if (rsType == RelationshipType::AFFECTS_BIP) {
-    return RelationshipType::NEXT_BIP;
   } else {
     DMOprintErrMsgAndExit(
         "[AffectsOnDemandEvaluator][getCFGRsType] Invalid rsType");
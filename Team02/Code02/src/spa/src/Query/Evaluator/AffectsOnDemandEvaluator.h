@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Common/Common.h>
+#include <Common/WorkStealingScheduler.h>
 #include <PKB/PKB.h>
 #include <Query/Common.h>
 
@@ -18,9 +19,22 @@ enum class BoolParamCombo {
   WILDCARD_LITERAL
 };
 
+// how a call to a procedure changes the definitions reaching the call
+struct ProcedureSummary {
+  // assignments in the procedure or its callees that reach its exit
+  LastModifiedTable exitDefs;
+  // variables modified on every path through the procedure
+  std::unordered_set<VarIdx> killedVars;
+  // assignments using each variable before any path modifies it
+  LastModifiedTable entryUses;
+};
+
 class AffectsOnDemandEvaluator {
  public:
-  explicit AffectsOnDemandEvaluator(PKB*);
+  // all pairs are extracted by one task per procedure
+  explicit AffectsOnDemandEvaluator(
+      PKB*, WorkStealingScheduler* scheduler =
+                &WorkStealingScheduler::getSharedScheduler());
 
   bool isAffects(RelationshipType rsType, StmtNo a1, StmtNo a2);
   std::unordered_set<StmtNo> getAffects(RelationshipType rsType, StmtNo a1);
@@ -38,24 +52,42 @@ class AffectsOnDemandEvaluator {
   query::ClauseIncomingResults evaluatePairAffects(RelationshipType rsType,
                                                    const query::Param& left,
                                                    const query::Param& right);
+  // caches Affects and its inverse of every statement given, by one pass over
+  // each procedure holding any of them
+  void cacheAffectsOfStmts(const std::unordered_set<StmtNo>& stmts);
 
   bool evaluateBoolAffectsT(const query::Param& left,
                             const query::Param& right);
   std::unordered_set<StmtNo> evaluateStmtAffectsT(const query::Param& left,
                                                    const query::Param& right);
-  std::unordered_set<StmtNo> evaluateStmtAffectsTHelper(
-      const query::Param& left, const query::Param& right,
-      std::unordered_set<StmtNo>* visited);
   query::ClauseIncomingResults evaluatePairAffectsT(const query::Param& left,
                                                     const query::Param& right);
 
+  // read off the closure of all AffectsBip pairs
+  bool evaluateBoolAffectsBipT(const query::Param& left,
+                               const query::Param& right);
+  std::unordered_set<StmtNo> evaluateStmtAffectsBipT(
+      const query::Param& left, const query::Param& right);
+  query::ClauseIncomingResults evaluatePairAffectsBipT(
+      const query::Param& left, const query::Param& right);
+
  private:
   PKB* pkb;
+  WorkStealingScheduler* scheduler;
+
+  // Affects is read off the def-use index of the pkb when it keeps one
+  bool isIndexedAffects(RelationshipType rsType);
 
   /* Affects Results Cache ------------------------------------------ */
-  bool isCompleteAffectsCache = false;  // true when Affects(s1, _) or (_, s2)
-                                        // or (s1, s2) have been computed before
-  bool isCompleteAffectsTCache = false;
+  // true when all pairs of the relationship have been computed before
+  std::unordered_map<RelationshipType, bool> isCompleteAffectsCache;
+  // statements whose procedure has been walked whole for Affects
+  std::unordered_set<StmtNo> completeAffectsStmts;
+  // statements whose Affects, or inverse, were found by a sliced search
+  std::unordered_set<StmtNo> slicedAffectsStmts;
+  std::unordered_set<StmtNo> slicedAffectsInvStmts;
+  bool isCompleteAffectsOfStmt(RelationshipType rsType, StmtNo stmt,
+                               bool isForward);
   std::unordered_set<StmtNo> allVisitedStmts = {};
   std::unordered_map<RelationshipType, std::unordered_set<StmtNo>>
       affectsStmts = {{RelationshipType::AFFECTS, {}}};
@@ -63,23 +95,45 @@ class AffectsOnDemandEvaluator {
       affectsInvStmts = {{RelationshipType::AFFECTS, {}}};
   TablesRs tableOfAffects = {{RelationshipType::AFFECTS, {}},
                              {RelationshipType::AFFECTS_T, {}},
-                             {RelationshipType::AFFECTS_BIP, {}}};
+                             {RelationshipType::AFFECTS_BIP, {}},
+                             {RelationshipType::AFFECTS_BIP_T, {}}};
   TablesRs tableOfAffectsInv = {{RelationshipType::AFFECTS, {}},
                                 {RelationshipType::AFFECTS_T, {}},
-                                {RelationshipType::AFFECTS_BIP, {}}};
+                                {RelationshipType::AFFECTS_BIP, {}},
+                                {RelationshipType::AFFECTS_BIP_T, {}}};
   std::unordered_map<RelationshipType, query::ClauseIncomingResults>
       affectsLeftStmtPairs = {{RelationshipType::AFFECTS, {}},
                               {RelationshipType::AFFECTS_T, {}},
-                              {RelationshipType::AFFECTS_BIP, {}}};
+                              {RelationshipType::AFFECTS_BIP, {}},
+                              {RelationshipType::AFFECTS_BIP_T, {}}};
   std::unordered_map<RelationshipType, query::ClauseIncomingResults>
       affectsRightStmtPairs = {{RelationshipType::AFFECTS, {}},
                                {RelationshipType::AFFECTS_T, {}},
-                               {RelationshipType::AFFECTS_BIP, {}}};
+                               {RelationshipType::AFFECTS_BIP, {}},
+                               {RelationshipType::AFFECTS_BIP_T, {}}};
   std::unordered_map<RelationshipType, query::ClauseIncomingResults>
       affectsStmtPairs = {{RelationshipType::AFFECTS, {}},
                           {RelationshipType::AFFECTS_T, {}},
-                          {RelationshipType::AFFECTS_BIP, {}}};
+                          {RelationshipType::AFFECTS_BIP, {}},
+                          {RelationshipType::AFFECTS_BIP_T, {}}};
+
+  /* AffectsBip Procedure Summaries ----------------------------------------- */
+  std::unordered_map<ProcIdx, ProcedureSummary> procSummaries;
+  // the procedure being walked, collecting the uses its entry reaches
+  ProcedureSummary* summaryInProgress = nullptr;
   /* Extraction Methods ----------------------------------------------------- */
+  // first stmt of the proc holding stmt, or of every proc it may be in
+  std::vector<StmtNo> getFirstStmtsOfProcsHolding(StmtNo stmt);
+  void extractAllAffects(RelationshipType rsType);
+  void mergeAffects(RelationshipType rsType,
+                    const AffectsOnDemandEvaluator& other);
+  // every procedure is walked once, after all of its callees
+  void extractAllAffectsBip();
+  const ProcedureSummary& getProcedureSummary(ProcIdx procIdx);
+  void applyProcedureSummary(StmtNo callStmt, LastModifiedTable* LMT);
+  // stands for the value of a variable on entry to the procedure
+  static StmtNo getEntryDef(VarIdx varIdx);
+  static bool isEntryDef(StmtNo stmt);
   void extractAffects(RelationshipType rsType, StmtNo startStmt,
                       StmtNo endStmt, StmtNo stmtAfterIfOrWhile,
                       LastModifiedTable* LMT, BoolParamCombo paramCombo);
@@ -103,14 +157,19 @@ class AffectsOnDemandEvaluator {
   LastModifiedTable mergeLMT(LastModifiedTable* firstLMT,
                              LastModifiedTable* secondLMT);
   RelationshipType getCFGRsType(RelationshipType rsType);
-  bool evalBoolLitAffectsT(const query::Param& left, const query::Param& right,
-                           std::unordered_set<StmtNo>* visited);
-  void populateAffectsTCache(const query::Param& left,
-                             const query::Param& right);
-  void populateAffectsTTable(
-      std::unordered_map<StmtNo, std::unordered_set<StmtNo>>* target,
-      std::unordered_map<StmtNo, std::unordered_set<StmtNo>>* base);
-  void populateAffectsTTableHelper(
-      StmtNo orig, StmtNo affected, std::unordered_set<StmtNo>* visited,
-      std::unordered_map<StmtNo, std::unordered_set<StmtNo>>* base);
+  // true if the dominator trees of the pkb show a kill of the variable a1
+  // modifies on every path from a1 to a2
+  bool isKilledOnEveryPath(StmtNo a1, StmtNo a2);
+  // Affects of stmt, or its inverse if not isForward, by a walk over only the
+  // variables involved. stops once targetStmt is found, and the result is
+  // complete and cached only if targetStmt is -1.
+  std::unordered_set<StmtNo> searchSlicedAffects(StmtNo stmt, bool isForward,
+                                                 StmtNo targetStmt);
+  // statements reached over one or more Affects, stopping at targetStmt
+  std::unordered_set<StmtNo> searchAffectsT(StmtNo startStmt, bool isForward,
+                                            StmtNo targetStmt);
+  // rsType is AFFECTS_T or AFFECTS_BIP_T
+  void populateAffectsTCache(RelationshipType rsType);
+  static std::vector<std::vector<int>> getStronglyConnectedComponents(
+      const std::vector<std::vector<int>>& successors);
 };
@@ -0,0 +1,216 @@
+#include "LeapfrogTriejoin.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace query;
+using namespace leapfrog;
+
+/* Trie Iterator ---------------------------------------------------------- */
+TrieIterator::TrieIterator(const vector<vector<int>>* tuples) {
+  this->tuples = tuples;
+}
+
+void TrieIterator::open() {
+  int begin = 0;
+  int end = tuples->size();
+  if (depth >= 0) {
+    // the children of the current key are the tuples sharing its prefix
+    begin = positions.back();
+    int column = depth;
+    int currentKey = key();
+    end = upper_bound(tuples->begin() + begin, tuples->begin() + ends.back(),
+                      currentKey,
+                      [column](int value, const vector<int>& tuple) {
+                        return value < tuple[column];
+                      }) -
+          tuples->begin();
+  }
+  depth++;
+  positions.push_back(begin);
+  ends.push_back(end);
+}
+
+void TrieIterator::up() {
+  depth--;
+  positions.pop_back();
+  ends.pop_back();
+}
+
+void TrieIterator::next() {
+  int column = depth;
+  int currentKey = key();
+  positions.back() =
+      upper_bound(tuples->begin() + positions.back(),
+                  tuples->begin() + ends.back(), currentKey,
+                  [column](int value, const vector<int>& tuple) {
+                    return value < tuple[column];
+                  }) -
+      tuples->begin();
+}
+
+void TrieIterator::seek(int key) {
+  int column = depth;
+  positions.back() =
+      lower_bound(tuples->begin() + positions.back(),
+                  tuples->begin() + ends.back(), key,
+                  [column](const vector<int>& tuple, int value) {
+                    return tuple[column] < value;
+                  }) -
+      tuples->begin();
+}
+
+int TrieIterator::key() { return (*tuples)[positions.back()][depth]; }
+
+bool TrieIterator::atEnd() { return positions.back() == ends.back(); }
+
+/* Leapfrog Triejoin ------------------------------------------------------ */
+LeapfrogTriejoin::LeapfrogTriejoin(vector<JoinRelation> relations) {
+  orderSynonyms(relations);
+  unordered_map<SynName, int> synonymToLevel;
+  for (int i = 0; i < synonymOrder.size(); i++) {
+    synonymToLevel[synonymOrder[i]] = i;
+  }
+
+  iteratorsAtLevel.resize(synonymOrder.size());
+  for (int i = 0; i < relations.size(); i++) {
+    JoinRelation& relation = relations[i];
+    vector<int> columnOrder(relation.synonyms.size());
+    for (int column = 0; column < columnOrder.size(); column++) {
+      columnOrder[column] = column;
+    }
+    sort(columnOrder.begin(), columnOrder.end(),
+         [&relation, &synonymToLevel](int columnA, int columnB) {
+           return synonymToLevel[relation.synonyms[columnA]] <
+                  synonymToLevel[relation.synonyms[columnB]];
+         });
+
+    vector<vector<int>> tuples;
+    tuples.reserve(relation.tuples.size());
+    for (const vector<int>& tuple : relation.tuples) {
+      vector<int> orderedTuple;
+      for (int column : columnOrder) {
+        orderedTuple.push_back(tuple[column]);
+      }
+      tuples.push_back(orderedTuple);
+    }
+    sort(tuples.begin(), tuples.end());
+    tuples.erase(unique(tuples.begin(), tuples.end()), tuples.end());
+    sortedTuples.push_back(tuples);
+
+    for (int column : columnOrder) {
+      iteratorsAtLevel[synonymToLevel[relation.synonyms[column]]].push_back(i);
+    }
+  }
+
+  // created after all tuples are in place as iterators point into them
+  for (const vector<vector<int>>& tuples : sortedTuples) {
+    iterators.emplace_back(&tuples);
+  }
+}
+
+vector<IntermediateQueryResult> LeapfrogTriejoin::join(
+    bool isStopAtFirstResult) {
+  this->isStopAtFirstResult = isStopAtFirstResult;
+  isStopped = false;
+  results.clear();
+  IntermediateQueryResult partialResult;
+  joinAtLevel(0, &partialResult);
+  return results;
+}
+
+void LeapfrogTriejoin::orderSynonyms(const vector<JoinRelation>& relations) {
+  // synonyms used by more relations are bound first, and every later synonym
+  // shares a relation with an earlier one where possible, so that each level
+  // is narrowed by the values already chosen
+  unordered_map<SynName, int> synonymToNumRelations;
+  unordered_map<SynName, unordered_set<SynName>> synonymToNeighbours;
+  for (const JoinRelation& relation : relations) {
+    for (const SynName& synonym : relation.synonyms) {
+      synonymToNumRelations[synonym]++;
+      for (const SynName& other : relation.synonyms) {
+        if (other != synonym) {
+          synonymToNeighbours[synonym].insert(other);
+        }
+      }
+    }
+  }
+
+  unordered_set<SynName> orderedSynonyms;
+  unordered_set<SynName> connectedSynonyms;
+  while (orderedSynonyms.size() < synonymToNumRelations.size()) {
+    const SynName* bestSynonym = nullptr;
+    bool isBestConnected = false;
+    for (const auto& synonymAndNum : synonymToNumRelations) {
+      const SynName& synonym = synonymAndNum.first;
+      if (orderedSynonyms.count(synonym) > 0) {
+        continue;
+      }
+      bool isConnected = connectedSynonyms.count(synonym) > 0;
+      if (bestSynonym == nullptr || isConnected > isBestConnected ||
+          (isConnected == isBestConnected &&
+           (synonymAndNum.second > synonymToNumRelations[*bestSynonym] ||
+            (synonymAndNum.second == synonymToNumRelations[*bestSynonym] &&
+             synonym < *bestSynonym)))) {
+        bestSynonym = &synonym;
+        isBestConnected = isConnected;
+      }
+    }
+    synonymOrder.push_back(*bestSynonym);
+    orderedSynonyms.insert(*bestSynonym);
+    for (const SynName& neighbour : synonymToNeighbours[*bestSynonym]) {
+      connectedSynonyms.insert(neighbour);
+    }
+  }
+}
+
+void LeapfrogTriejoin::joinAtLevel(int level,
+                                   IntermediateQueryResult* partialResult) {
+  if (level == synonymOrder.size()) {
+    results.push_back(*partialResult);
+    isStopped = isStopAtFirstResult;
+    return;
+  }
+
+  vector<TrieIterator*> levelIterators;
+  bool isAnyEmpty = false;
+  for (int i : iteratorsAtLevel[level]) {
+    iterators[i].open();
+    levelIterators.push_back(&iterators[i]);
+    isAnyEmpty = isAnyEmpty || iterators[i].atEnd();
+  }
+
+  if (!isAnyEmpty) {
+    // leapfrog: the iterator with the smallest key seeks to the largest key
+    // until all iterators agree on a key
+    sort(levelIterators.begin(), levelIterators.end(),
+         [](TrieIterator* a, TrieIterator* b) { return a->key() < b->key(); });
+    int numIterators = levelIterators.size();
+    int maxKey = levelIterators.back()->key();
+    int index = 0;
+    while (!isStopped) {
+      TrieIterator* iterator = levelIterators[index];
+      if (iterator->key() == maxKey) {
+        (*partialResult)[synonymOrder[level]] = maxKey;
+        joinAtLevel(level + 1, partialResult);
+        iterator->next();
+      } else {
+        iterator->seek(maxKey);
+      }
+      if (iterator->atEnd()) {
+        break;
+      }
+      maxKey = iterator->key();
+      index = (index + 1) % numIterators;
+    }
+  }
+
+  for (int i : iteratorsAtLevel[level]) {
+    iterators[i].up();
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Query/Common.h>
+
+#include <string>
+#include <vector>
+
+namespace leapfrog {
+// results of a single clause over the synonyms it uses
+struct JoinRelation {
+  std::vector<query::SynName> synonyms;
+  std::vector<std::vector<int>> tuples;
+};
+
+// iterates one level at a time over tuples sorted lexicographically, where
+// the values at a level are those sharing the prefix chosen at upper levels
+class TrieIterator {
+ public:
+  explicit TrieIterator(const std::vector<std::vector<int>>* tuples);
+
+  void open();
+  void up();
+  void next();
+  void seek(int key);
+  int key();
+  bool atEnd();
+
+ private:
+  const std::vector<std::vector<int>>* tuples;
+  int depth = -1;
+  std::vector<int> positions;
+  std::vector<int> ends;
+};
+}  // namespace leapfrog
+
+// Worst case optimal multi-way join of clause results. Every synonym is bound
+// in turn by intersecting the sorted values of all relations that use it, so
+// cycles of synonyms never materialise pairwise results larger than the
+// output.
+class LeapfrogTriejoin {
+ public:
+  explicit LeapfrogTriejoin(std::vector<leapfrog::JoinRelation> relations);
+
+  std::vector<query::IntermediateQueryResult> join(bool isStopAtFirstResult);
+
+ private:
+  std::vector<query::SynName> synonymOrder;
+  // tuples of each relation with columns following synonymOrder
+  std::vector<std::vector<std::vector<int>>> sortedTuples;
+  std::vector<leapfrog::TrieIterator> iterators;
+  // iterators of the relations using each synonym, by position in the order
+  std::vector<std::vector<int>> iteratorsAtLevel;
+
+  std::vector<query::IntermediateQueryResult> results;
+  bool isStopAtFirstResult = false;
+  bool isStopped = false;
+
+  void orderSynonyms(const std::vector<leapfrog::JoinRelation>& relations);
+  void joinAtLevel(int level, query::IntermediateQueryResult* partialResult);
+};
@@ -7,13 +7,18 @@
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 using namespace std;
 using namespace query;
 
-NextOnDemandEvaluator::NextOnDemandEvaluator(PKB* pkb) {
+const unordered_set<StmtNo> NO_SUMMARISED_STMTS = {};
+
+NextOnDemandEvaluator::NextOnDemandEvaluator(PKB* pkb,
+                                             WorkStealingScheduler* scheduler) {
   this->pkb = pkb;
+  this->scheduler = scheduler;
   stmtToStmtsCache.insert(
       {{RelationshipType::NEXT_T, {}}, {RelationshipType::NEXT_BIP_T, {}}});
   invStmtToStmtsCache.insert(
@@ -35,9 +40,22 @@ bool NextOnDemandEvaluator::evaluateBoolNextTNextBipT(RelationshipType rsType,
         isStmtInInvStmtsCache(rsType, rightStmtNum)) {
       // if result cached
       return isRelationship(rsType, leftStmtNum, rightStmtNum);
-    } else {
+    }
+    if (rsType == RelationshipType::NEXT_BIP_T) {
       return getIsNextTNextBipT(rsType, leftStmtNum, rightStmtNum);
     }
+    if (isInDifferentProcs(leftStmtNum, rightStmtNum)) {
+      return false;
+    }
+    switch (pkb->getNextTOracle()) {
+      case NextTOracle::STMT_RANGES:
+        return pkb->isStructuralNextT(leftStmtNum, rightStmtNum);
+      case NextTOracle::REACHABILITY_INDEX:
+        return pkb->isNextT(leftStmtNum, rightStmtNum);
+      case NextTOracle::SEARCH:
+        break;
+    }
+    return getIsNextTNextBipT(rsType, leftStmtNum, rightStmtNum);
   }
 
   RelationshipType nonTransitiveRsType = getNonTransitiveRsType(rsType);
@@ -56,67 +74,130 @@ bool NextOnDemandEvaluator::evaluateBoolNextTNextBipT(RelationshipType rsType,
 }
 
 unordered_set<int> NextOnDemandEvaluator::evaluateNextTNextBipT(
-    RelationshipType rsType, const Param& left, const Param& right) {
+    RelationshipType rsType, const Param& left, const Param& right,
+    const IntervalSet* synonymDomain) {
   ParamType leftType = left.type;
-  ParamType rightType = right.type;
+  bool isStructural =
+      rsType == RelationshipType::NEXT_T && pkb->hasStmtRanges();
 
   // Integer + Synonym - e.g. NextT(1, s)
   if (leftType == ParamType::INTEGER_LITERAL) {
     int leftStmtNum = stoi(left.value);
-    unordered_set<int> results;
-    if (isStmtInStmtsCache(rsType, leftStmtNum)) {
-      // if results cached
-      results = getStmts(rsType, leftStmtNum);
-    } else {
-      results = getNextTNextBipTStmts(rsType, leftStmtNum);
-      addToStmtsCache(rsType, leftStmtNum, results);
+    if (!isStmtInStmtsCache(rsType, leftStmtNum)) {
+      addToStmtsCache(
+          rsType, leftStmtNum,
+          isStructural
+              ? pkb->getStructuralNextTStmts(leftStmtNum, true)
+              : IntervalSet(getNextTNextBipTStmts(rsType, leftStmtNum)));
     }
-    return results;
+    const IntervalSet& results = getStmts(rsType, leftStmtNum);
+    return synonymDomain == nullptr
+               ? results.toSet()
+               : results.intersectWith(*synonymDomain).toSet();
   }
 
   // Synonym + Integer - e.g. NextT(s, 2)
   int rightStmtNum = stoi(right.value);
-  unordered_set<int> results;
-  if (isStmtInInvStmtsCache(rsType, rightStmtNum)) {
-    // if results cached
-    results = getInvStmts(rsType, rightStmtNum);
-  } else {
-    results = getInvNextTNextBipTStmts(rsType, rightStmtNum);
-    addToInvStmtsCache(rsType, rightStmtNum, results);
+  if (!isStmtInInvStmtsCache(rsType, rightStmtNum)) {
+    addToInvStmtsCache(
+        rsType, rightStmtNum,
+        isStructural
+            ? pkb->getStructuralNextTStmts(rightStmtNum, false)
+            : IntervalSet(getInvNextTNextBipTStmts(rsType, rightStmtNum)));
   }
-  return results;
+  const IntervalSet& results = getInvStmts(rsType, rightStmtNum);
+  return synonymDomain == nullptr
+             ? results.toSet()
+             : results.intersectWith(*synonymDomain).toSet();
 }
 
 ClauseIncomingResults NextOnDemandEvaluator::evaluatePairNextTNextBipT(
-    RelationshipType rsType, const Param& left, const Param& right) {
+    RelationshipType rsType, const Param& left, const Param& right,
+    const IntervalSet* leftDomain, const IntervalSet* rightDomain) {
   ClauseIncomingResults results = {};
-  unordered_set<int> allStmts = pkb->getAllStmts(DesignEntity::STATEMENT);
+  // only the rows of candidates of the left synonym are needed
+  vector<int> sourceStmts;
+  for (StmtNo stmtNum : pkb->getAllStmts(DesignEntity::STATEMENT)) {
+    if (leftDomain == nullptr || leftDomain->contains(stmtNum)) {
+      sourceStmts.push_back(stmtNum);
+    }
+  }
 
-  for (auto stmtNum : allStmts) {
-    unordered_set<int> nextTNextBipTStmts;
+  // traversals from different statements only read the pkb and summaries
+  // completed beforehand, so they run in parallel and are added to the cache
+  // afterwards
+  if (rsType == RelationshipType::NEXT_BIP_T) {
+    computeProcedureSummaries();
+  }
+  // rows read off statement ranges need no traversal at all
+  bool isStructural =
+      rsType == RelationshipType::NEXT_T && pkb->hasStmtRanges();
+  vector<int> uncachedStmts;
+  for (auto stmtNum : sourceStmts) {
     if (isStmtInStmtsCache(rsType, stmtNum)) {
-      // if results cached
-      nextTNextBipTStmts = getStmts(rsType, stmtNum);
+      continue;
+    }
+    if (isStructural) {
+      addToStmtsCache(rsType, stmtNum,
+                      pkb->getStructuralNextTStmts(stmtNum, true));
     } else {
-      nextTNextBipTStmts = getNextTNextBipTStmts(rsType, stmtNum);
-      addToStmtsCache(rsType, stmtNum, nextTNextBipTStmts);
+      uncachedStmts.push_back(stmtNum);
     }
+  }
+  vector<unordered_set<int>> uncachedResults(uncachedStmts.size());
+  scheduler->run(uncachedStmts.size(), [&](int task, int) {
+    uncachedResults[task] = getNextTNextBipTStmts(rsType, uncachedStmts[task]);
+  });
+  for (int i = 0; i < uncachedStmts.size(); i++) {
+    addToStmtsCache(rsType, uncachedStmts[i], IntervalSet(uncachedResults[i]));
+  }
 
-    for (auto nextTStmt : nextTNextBipTStmts) {
-      if (left.type == ParamType::WILDCARD) {
-        results.insert({nextTStmt});
-      } else if (right.type == ParamType::WILDCARD) {
+  // rows of a wildcard are merged as intervals and read out once, stopping
+  // as soon as they cover every candidate
+  IntervalSet reachedStmts;
+  for (auto stmtNum : sourceStmts) {
+    const IntervalSet& row = getStmts(rsType, stmtNum);
+    IntervalSet narrowedRow;
+    if (rightDomain != nullptr) {
+      narrowedRow = row.intersectWith(*rightDomain);
+    }
+    const IntervalSet& nextTNextBipTStmts =
+        rightDomain == nullptr ? row : narrowedRow;
+    if (right.type == ParamType::WILDCARD) {
+      if (!nextTNextBipTStmts.empty()) {
         results.insert({stmtNum});
-      } else {
+      }
+      continue;
+    }
+    if (left.type == ParamType::WILDCARD) {
+      reachedStmts = reachedStmts.unionWith(nextTNextBipTStmts);
+      if (rightDomain != nullptr &&
+          rightDomain->differenceWith(reachedStmts).empty()) {
+        break;
+      }
+      continue;
+    }
+    for (const auto& [start, end] : nextTNextBipTStmts.getIntervals()) {
+      for (int nextTStmt = start; nextTStmt <= end; nextTStmt++) {
         results.insert({stmtNum, nextTStmt});
       }
     }
   }
+  for (const auto& [start, end] : reachedStmts.getIntervals()) {
+    for (int nextTStmt = start; nextTStmt <= end; nextTStmt++) {
+      results.insert({nextTStmt});
+    }
+  }
   return results;
 }
 
 bool NextOnDemandEvaluator::getIsNextTNextBipT(RelationshipType rsType,
                                                int startStmt, int endStmt) {
+  if (rsType == RelationshipType::NEXT_BIP_T) {
+    addToStmtsCache(rsType, startStmt,
+                    IntervalSet(getNextBipTStmts(startStmt, true)));
+    return isRelationship(rsType, startStmt, endStmt);
+  }
   queue<int> stmtQueue = {};
   unordered_map<int, unordered_set<int>> visited = {};
   RelationshipType nonTransitiveRsType = getNonTransitiveRsType(rsType);
@@ -162,6 +243,9 @@ bool NextOnDemandEvaluator::getIsNextTNextBipT(RelationshipType rsType,
 
 unordered_set<int> NextOnDemandEvaluator::getNextTNextBipTStmts(
     RelationshipType rsType, int startStmt) {
+  if (rsType == RelationshipType::NEXT_BIP_T) {
+    return getNextBipTStmts(startStmt, true);
+  }
   unordered_set<int> results = {};
   queue<int> stmtQueue = {};
   unordered_map<int, unordered_set<int>> visited = {};
@@ -208,6 +292,9 @@ unordered_set<int> NextOnDemandEvaluator::getNextTNextBipTStmts(
 
 unordered_set<int> NextOnDemandEvaluator::getInvNextTNextBipTStmts(
     RelationshipType rsType, int endStmt) {
+  if (rsType == RelationshipType::NEXT_BIP_T) {
+    return getNextBipTStmts(endStmt, false);
+  }
   unordered_set<int> results = {};
   queue<int> stmtQueue = {};
   unordered_map<int, unordered_set<int>> visited = {};
@@ -252,6 +339,169 @@ unordered_set<int> NextOnDemandEvaluator::getInvNextTNextBipTStmts(
   return results;
 }
 
+/* NextBip* Procedure Summaries ----------------------------------------- */
+void NextOnDemandEvaluator::computeProcedureSummaries() {
+  if (isSummarised) {
+    return;
+  }
+  for (ProcIdx procIdx : pkb->getAllElementsAt(TableType::PROC_TABLE)) {
+    getProcBody(procIdx);
+    getReturnReachedStmts(procIdx);
+    getEntryReachingStmts(procIdx);
+  }
+  isSummarised = true;
+}
+
+const unordered_set<StmtNo>& NextOnDemandEvaluator::getProcBody(
+    ProcIdx procIdx) {
+  if (procIdx == -1) {
+    return NO_SUMMARISED_STMTS;
+  }
+  auto bodyIt = procBodies.find(procIdx);
+  if (bodyIt != procBodies.end()) {
+    return bodyIt->second;
+  }
+  if (isSummarised) {
+    return NO_SUMMARISED_STMTS;
+  }
+  unordered_set<StmtNo> body;
+  auto [firstStmt, lastStmt] = pkb->getProcRange(procIdx);
+  if (firstStmt != -1) {
+    // statements of a procedure are numbered consecutively
+    for (StmtNo stmt = firstStmt; stmt <= lastStmt; stmt++) {
+      body.insert(stmt);
+      if (pkb->isStmt(DesignEntity::CALL, stmt)) {
+        const unordered_set<StmtNo>& calleeBody =
+            getProcBody(pkb->getNameAttribute(DesignEntity::CALL, stmt));
+        body.insert(calleeBody.begin(), calleeBody.end());
+      }
+    }
+    return procBodies.insert({procIdx, body}).first->second;
+  }
+  // every statement of a procedure is reached from its first
+  firstStmt = pkb->getFirstStmtOfProc(procIdx);
+  if (firstStmt != -1) {
+    body = getNextTWithinProc(firstStmt, true);
+    body.insert(firstStmt);
+    if (pkb->isStmt(DesignEntity::CALL, firstStmt)) {
+      const unordered_set<StmtNo>& calleeBody =
+          getProcBody(pkb->getNameAttribute(DesignEntity::CALL, firstStmt));
+      body.insert(calleeBody.begin(), calleeBody.end());
+    }
+  }
+  return procBodies.insert({procIdx, body}).first->second;
+}
+
+const unordered_set<StmtNo>& NextOnDemandEvaluator::getReturnReachedStmts(
+    ProcIdx procIdx) {
+  if (procIdx == -1) {
+    return NO_SUMMARISED_STMTS;
+  }
+  auto reachedIt = returnReachedStmts.find(procIdx);
+  if (reachedIt != returnReachedStmts.end()) {
+    return reachedIt->second;
+  }
+  if (isSummarised) {
+    return NO_SUMMARISED_STMTS;
+  }
+  unordered_set<StmtNo> reached;
+  for (StmtNo callStmt : pkb->getLeft(RelationshipType::CALLS_S, procIdx)) {
+    reached.merge(getNextTWithinProc(callStmt, true));
+    ProcIdx callerIdx = pkb->getProcOfStmt(callStmt);
+    if (callerIdx != -1) {
+      const unordered_set<StmtNo>& callerReached =
+          getReturnReachedStmts(callerIdx);
+      reached.insert(callerReached.begin(), callerReached.end());
+    }
+  }
+  return returnReachedStmts.insert({procIdx, reached}).first->second;
+}
+
+const unordered_set<StmtNo>& NextOnDemandEvaluator::getEntryReachingStmts(
+    ProcIdx procIdx) {
+  if (procIdx == -1) {
+    return NO_SUMMARISED_STMTS;
+  }
+  auto reachingIt = entryReachingStmts.find(procIdx);
+  if (reachingIt != entryReachingStmts.end()) {
+    return reachingIt->second;
+  }
+  if (isSummarised) {
+    return NO_SUMMARISED_STMTS;
+  }
+  unordered_set<StmtNo> reaching;
+  for (StmtNo callStmt : pkb->getLeft(RelationshipType::CALLS_S, procIdx)) {
+    reaching.insert(callStmt);
+    reaching.merge(getNextTWithinProc(callStmt, false));
+    ProcIdx callerIdx = pkb->getProcOfStmt(callStmt);
+    if (callerIdx != -1) {
+      const unordered_set<StmtNo>& callerReaching =
+          getEntryReachingStmts(callerIdx);
+      reaching.insert(callerReaching.begin(), callerReaching.end());
+    }
+  }
+  return entryReachingStmts.insert({procIdx, reaching}).first->second;
+}
+
+unordered_set<StmtNo> NextOnDemandEvaluator::getNextTWithinProc(
+    StmtNo stmt, bool isForward) {
+  unordered_set<StmtNo> results;
+  vector<StmtNo> passedCalls;
+  queue<StmtNo> stmtQueue;
+  stmtQueue.push(stmt);
+  while (!stmtQueue.empty()) {
+    StmtNo currStmt = stmtQueue.front();
+    stmtQueue.pop();
+    for (StmtNo nextStmt :
+         isForward ? pkb->getRight(RelationshipType::NEXT, currStmt)
+                   : pkb->getLeft(RelationshipType::NEXT, currStmt)) {
+      if (!results.insert(nextStmt).second) {
+        continue;
+      }
+      stmtQueue.push(nextStmt);
+      if (pkb->isStmt(DesignEntity::CALL, nextStmt)) {
+        passedCalls.push_back(nextStmt);
+      }
+    }
+  }
+
+  // a call reached either way runs its callee in full, which then returns
+  // to the same call
+  for (StmtNo callStmt : passedCalls) {
+    const unordered_set<StmtNo>& body =
+        getProcBody(pkb->getNameAttribute(DesignEntity::CALL, callStmt));
+    results.insert(body.begin(), body.end());
+  }
+  return results;
+}
+
+unordered_set<StmtNo> NextOnDemandEvaluator::getNextBipTStmts(StmtNo stmt,
+                                                              bool isForward) {
+  unordered_set<StmtNo> results = getNextTWithinProc(stmt, isForward);
+  if (isForward && pkb->isStmt(DesignEntity::CALL, stmt)) {
+    const unordered_set<StmtNo>& body =
+        getProcBody(pkb->getNameAttribute(DesignEntity::CALL, stmt));
+    results.insert(body.begin(), body.end());
+  }
+
+  // the procedure's entry reaches every statement of it and each statement
+  // reaches its exit, so paths may continue through any of its callers
+  ProcIdx procIdx = pkb->getProcOfStmt(stmt);
+  if (procIdx != -1) {
+    const unordered_set<StmtNo>& callerStmts =
+        isForward ? getReturnReachedStmts(procIdx)
+                  : getEntryReachingStmts(procIdx);
+    results.insert(callerStmts.begin(), callerStmts.end());
+  }
+  return results;
+}
+
+bool NextOnDemandEvaluator::isInDifferentProcs(StmtNo stmt1, StmtNo stmt2) {
+  ProcIdx procIdx1 = pkb->getProcOfStmt(stmt1);
+  ProcIdx procIdx2 = pkb->getProcOfStmt(stmt2);
+  return procIdx1 != -1 && procIdx2 != -1 && procIdx1 != procIdx2;
+}
+
 RelationshipType NextOnDemandEvaluator::getNonTransitiveRsType(
     RelationshipType rsType) {
   if (rsType == RelationshipType::NEXT_T) {
@@ -279,31 +529,37 @@ bool NextOnDemandEvaluator::isStmtInInvStmtsCache(RelationshipType rsType,
 
 bool NextOnDemandEvaluator::isRelationship(RelationshipType rsType, StmtNo left,
                                            StmtNo right) {
-  return stmtToStmtsCache[rsType][left].find(right) !=
-             stmtToStmtsCache[rsType][left].end() ||
-         invStmtToStmtsCache[rsType][right].find(left) !=
-             stmtToStmtsCache[rsType][right].end();
+  // looked up without inserting, as an entry marks a complete result
+  const auto& stmtsCache = stmtToStmtsCache[rsType];
+  auto stmtsIt = stmtsCache.find(left);
+  if (stmtsIt != stmtsCache.end()) {
+    return stmtsIt->second.contains(right);
+  }
+  const auto& invStmtsCache = invStmtToStmtsCache[rsType];
+  auto invStmtsIt = invStmtsCache.find(right);
+  return invStmtsIt != invStmtsCache.end() &&
+         invStmtsIt->second.contains(left);
 }
 
-SetOfInts& NextOnDemandEvaluator::getStmts(RelationshipType rsType,
-                                           StmtNo stmt) {
+const IntervalSet& NextOnDemandEvaluator::getStmts(RelationshipType rsType,
+                                                   StmtNo stmt) {
   return stmtToStmtsCache[rsType][stmt];
 }
 
-SetOfInts& NextOnDemandEvaluator::getInvStmts(RelationshipType rsType,
-                                              StmtNo stmt) {
+const IntervalSet& NextOnDemandEvaluator::getInvStmts(
+    RelationshipType rsType, StmtNo stmt) {
   return invStmtToStmtsCache[rsType][stmt];
 }
 
 /* Cache setter methods --------------------------------------- */
 void NextOnDemandEvaluator::addToStmtsCache(RelationshipType rsType,
                                             StmtNo leftStmt,
-                                            SetOfInts rightStmts) {
-  stmtToStmtsCache[rsType].insert({leftStmt, rightStmts});
+                                            IntervalSet rightStmts) {
+  stmtToStmtsCache[rsType].insert({leftStmt, move(rightStmts)});
 }
 
 void NextOnDemandEvaluator::addToInvStmtsCache(RelationshipType rsType,
                                                StmtNo rightStmt,
-                                               SetOfInts leftStmts) {
-  invStmtToStmtsCache[rsType].insert({rightStmt, leftStmts});
+                                               IntervalSet leftStmts) {
+  invStmtToStmtsCache[rsType].insert({rightStmt, move(leftStmts)});
 }
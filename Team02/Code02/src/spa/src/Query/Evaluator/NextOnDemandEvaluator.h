@@ -1,47 +1,89 @@
 #pragma once
 
 #include <Common/Common.h>
+#include <Common/IntervalSet.h>
+#include <Common/WorkStealingScheduler.h>
 #include <PKB/PKB.h>
 #include <Query/Common.h>
 
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+typedef std::unordered_map<RelationshipType,
+                           std::unordered_map<StmtNo, IntervalSet>>
+    IntervalTablesRs;
+
 class NextOnDemandEvaluator {
  public:
-  explicit NextOnDemandEvaluator(PKB* pkb);
+  // all pairs are computed by one task per source statement
+  explicit NextOnDemandEvaluator(
+      PKB* pkb, WorkStealingScheduler* scheduler =
+                    &WorkStealingScheduler::getSharedScheduler());
 
   bool evaluateBoolNextTNextBipT(RelationshipType rsType,
                                  const query::Param& left,
                                  const query::Param& right);
-  std::unordered_set<int> evaluateNextTNextBipT(RelationshipType rsType,
-                                                const query::Param& left,
-                                                const query::Param& right);
+  // rows are met with the candidate values of a synonym given as
+  // intervals, before any is materialised
+  std::unordered_set<int> evaluateNextTNextBipT(
+      RelationshipType rsType, const query::Param& left,
+      const query::Param& right, const IntervalSet* synonymDomain = nullptr);
   query::ClauseIncomingResults evaluatePairNextTNextBipT(
       RelationshipType rsType, const query::Param& left,
-      const query::Param& right);
+      const query::Param& right, const IntervalSet* leftDomain = nullptr,
+      const IntervalSet* rightDomain = nullptr);
 
  private:
   PKB* pkb;
+  WorkStealingScheduler* scheduler;
 
-  TablesRs stmtToStmtsCache;
-  TablesRs invStmtToStmtsCache;
+  // rows are kept as intervals, being mostly the rest of a procedure and the
+  // loops around a statement
+  IntervalTablesRs stmtToStmtsCache;
+  IntervalTablesRs invStmtToStmtsCache;
 
   bool isStmtInStmtsCache(RelationshipType rsType, StmtNo leftStmt);
   bool isStmtInInvStmtsCache(RelationshipType rsType, StmtNo leftStmt);
   bool isRelationship(RelationshipType rsType, StmtNo left, StmtNo right);
-  SetOfInts& getStmts(RelationshipType rsType, StmtNo stmt);
-  SetOfInts& getInvStmts(RelationshipType rsType, StmtNo stmt);
+  const IntervalSet& getStmts(RelationshipType rsType, StmtNo stmt);
+  const IntervalSet& getInvStmts(RelationshipType rsType, StmtNo stmt);
 
   void addToStmtsCache(RelationshipType rsType, StmtNo leftStmt,
-                       SetOfInts rightStmts);
+                       IntervalSet rightStmts);
   void addToInvStmtsCache(RelationshipType rsType, StmtNo leftStmt,
-                          SetOfInts rightStmts);
+                          IntervalSet rightStmts);
 
   RelationshipType getNonTransitiveRsType(RelationshipType rsType);
+  // Next* never crosses procedures, unlike NextBip*
+  bool isInDifferentProcs(StmtNo stmt1, StmtNo stmt2);
   bool getIsNextTNextBipT(RelationshipType rsType, int startStmt, int endStmt);
   std::unordered_set<int> getNextTNextBipTStmts(RelationshipType rsType,
                                                 int startStmt);
   std::unordered_set<int> getInvNextTNextBipTStmts(RelationshipType rsType,
                                                    int endStmt);
+
+  /* NextBip* Procedure Summaries ----------------------------------------- */
+  // NextBip* only follows paths returning to the call they entered from, so
+  // it is built from Next within each procedure and these sets per procedure
+  // rather than from the NextBip edges of every call site
+
+  // statements run by a call to the procedure, its callees included
+  std::unordered_map<ProcIdx, std::unordered_set<StmtNo>> procBodies;
+  // statements reached once the procedure returns to any of its callers
+  std::unordered_map<ProcIdx, std::unordered_set<StmtNo>> returnReachedStmts;
+  // statements reaching the entry of the procedure from any of its callers
+  std::unordered_map<ProcIdx, std::unordered_set<StmtNo>> entryReachingStmts;
+
+  // set once every procedure is summarised, after which traversals run in
+  // parallel and only look summaries up
+  bool isSummarised = false;
+
+  void computeProcedureSummaries();
+  const std::unordered_set<StmtNo>& getProcBody(ProcIdx procIdx);
+  const std::unordered_set<StmtNo>& getReturnReachedStmts(ProcIdx procIdx);
+  const std::unordered_set<StmtNo>& getEntryReachingStmts(ProcIdx procIdx);
+  // Next* within the procedure, with the bodies of the calls passed through
+  std::unordered_set<StmtNo> getNextTWithinProc(StmtNo stmt, bool isForward);
+  std::unordered_set<StmtNo> getNextBipTStmts(StmtNo stmt, bool isForward);
 };
@@ -3,7 +3,11 @@
 #include <../../autotester/src/AbstractWrapper.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -16,28 +20,114 @@
 using namespace std;
 using namespace query;
 
-QueryEvaluator::QueryEvaluator(PKB* pkb, QueryOptimizer* optimizer)
-    : nextOnDemandEvaluator(pkb),
-      affectsOnDemandEvaluator(pkb),
+// below this many bound values, Affects is cheaper walked from each of them
+const int MIN_BATCHED_AFFECTS_STMTS = 4;
+const unordered_set<VarIdx> NO_PATTERN_VARS = {};
+
+QueryEvaluator::QueryEvaluator(PKB* pkb, QueryOptimizer* optimizer,
+                               ThreadPool* threadPool)
+    : onDemandEvaluators(make_shared<OnDemandEvaluators>(pkb)),
       withEvaluator(pkb) {
   this->pkb = pkb;
   this->optimizer = optimizer;
+  this->threadPool = threadPool;
+  isAnyGroupFalse = nullptr;
   areAllClausesTrue = true;
-  finalQueryResults = {};
+  resultFactors = {};
   groupQueryResults = {};
   queryResultsSynonyms = {};
+  numClauseIncomingResults = 0;
+  numGroupClauses = 0;
+  isCheckingExistenceOnly = false;
+  isCollectingClauseResults = false;
 }
 
 FinalQueryResults QueryEvaluator::evaluateQuery(SynonymMap synonymMap,
                                                 SelectClause select) {
+  return expandFactorisedResults(
+      select, evaluateQueryFactorised(synonymMap, select));
+}
+
+FactorisedQueryResults QueryEvaluator::evaluateQueryFactorised(
+    SynonymMap synonymMap, SelectClause select) {
   this->synonymMap = synonymMap;
-  finalQueryResults.clear();
+  resultFactors.clear();
+  clauseExplanations.clear();
+
+  if (optimizer->GetNumRemainingGroups() >= 2 &&
+      threadPool->getNumThreads() > 1) {
+    evaluateGroupsInParallel(select);
+  } else {
+    evaluateGroups(select);
+  }
+  if (!areAllClausesTrue) {
+    return {false, {}};
+  }
+  return getFactorisedResults(select);
+}
+
+void QueryEvaluator::evaluateGroupsInParallel(const SelectClause& select) {
+  // groups share no synonyms, so each is evaluated by an evaluator of its own
+  // with its own results table. the on demand caches are shared between them.
+  pkb->prepareForConcurrentReads();
+  vector<QueryOptimizer> groupOptimizers = optimizer->SplitRemainingGroups();
+  atomic<bool> isAnyGroupFalse(false);
+  vector<unique_ptr<QueryEvaluator>> groupEvaluators;
+  vector<future<void>> groupFutures;
+  for (QueryOptimizer& groupOptimizer : groupOptimizers) {
+    groupEvaluators.push_back(
+        make_unique<QueryEvaluator>(pkb, &groupOptimizer, threadPool));
+    QueryEvaluator* groupEvaluator = groupEvaluators.back().get();
+    groupEvaluator->synonymMap = synonymMap;
+    groupEvaluator->isAnyGroupFalse = &isAnyGroupFalse;
+    groupEvaluator->onDemandEvaluators = onDemandEvaluators;
+    groupFutures.push_back(threadPool->submit(
+        [groupEvaluator, &select] { groupEvaluator->evaluateGroups(select); }));
+  }
+  threadPool->wait(&groupFutures);
+
+  // merged in the order the optimizer sorted the groups
+  for (const unique_ptr<QueryEvaluator>& groupEvaluator : groupEvaluators) {
+    areAllClausesTrue = areAllClausesTrue && groupEvaluator->areAllClausesTrue;
+    clauseExplanations.insert(clauseExplanations.end(),
+                              groupEvaluator->clauseExplanations.begin(),
+                              groupEvaluator->clauseExplanations.end());
+    for (ResultFactor& factor : groupEvaluator->resultFactors) {
+      resultFactors.push_back(move(factor));
+    }
+    queryResultsSynonyms.insert(groupEvaluator->queryResultsSynonyms.begin(),
+                                groupEvaluator->queryResultsSynonyms.end());
+  }
+}
 
+void QueryEvaluator::evaluateGroups(const SelectClause& select) {
   while (true) {
     optional<GroupDetails> optGroupDetails = optimizer->GetNextGroupDetails();
     if (!optGroupDetails.has_value()) {
       break;
     }
+    vector<ConditionClause> groupClauses =
+        optimizer->GetRemainingClausesOfGroup();
+    initializeGroupDomains(groupClauses);
+    numGroupClauses = groupClauses.size();
+    // a boolean group stops at the first assignment satisfying all clauses
+    isCheckingExistenceOnly = optGroupDetails.value().isBooleanGroup;
+    if (isCheckingExistenceOnly && groupClauses.size() > 1) {
+      evaluateBooleanGroup();
+      if (!areAllClausesTrue) {
+        if (isAnyGroupFalse != nullptr) {
+          *isAnyGroupFalse = true;
+        }
+        return;
+      }
+      if (AbstractWrapper::GlobalStop ||
+          (isAnyGroupFalse != nullptr && *isAnyGroupFalse)) {
+        return;
+      }
+      continue;
+    }
+    isCollectingClauseResults = optGroupDetails.value().isCyclic;
+    collectedRelations.clear();
 
     while (true) {
       SynonymCountsTable synonymCounts = getSynonymCounts();
@@ -48,6 +138,8 @@ FinalQueryResults QueryEvaluator::evaluateQuery(SynonymMap synonymMap,
       }
 
       ConditionClause clause = optClause.value();
+      unsigned long estimatedSize = optimizer->GetEstimatedSizeOfClause(clause);
+      numClauseIncomingResults = 0;
       if (clause.conditionClauseType == ConditionClauseType::SUCH_THAT) {
         evaluateSuchThatClause(clause.suchThatClause);
       } else if (clause.conditionClauseType == ConditionClauseType::PATTERN) {
@@ -55,46 +147,138 @@ FinalQueryResults QueryEvaluator::evaluateQuery(SynonymMap synonymMap,
       } else {
         evaluateWithClause(clause.withClause);
       }
+      explainClause(clause, estimatedSize);
 
       if (!areAllClausesTrue) {
         clauseSynonymValuesTable.clear();
-        // early termination as soon as any clause is false
-        // if select bool, false
-        if (select.selectType == SelectType::BOOLEAN) {
-          return {{FALSE_SELECT_BOOL_RESULT}};
-        } else {
-          return {};
+        isCollectingClauseResults = false;
+        // early termination as soon as any clause is false, which also
+        // cancels the groups evaluated alongside this one
+        if (isAnyGroupFalse != nullptr) {
+          *isAnyGroupFalse = true;
         }
+        return;
+      }
+
+      narrowDomainsByClauseResults();
+      if (!isCollectingClauseResults) {
+        projectAwaySynonyms(optimizer->GetDeadSynonyms(clause));
       }
 
       if (AbstractWrapper::GlobalStop) {
-        // check if TLE after each clause evaluation
-        // return whatever results we can
-        return getSelectSynonymFinalResults(select);
+        // check if TLE after each clause evaluation, return whatever results
+        // we can. collected results are not joined yet, so a group still
+        // collecting leaves its synonyms to take all their values.
+        if (!isCollectingClauseResults &&
+            !optGroupDetails.value().isBooleanGroup) {
+          addGroupResultsAsFactor(optGroupDetails.value().selectedSynonyms);
+        }
+        isCollectingClauseResults = false;
+        clauseSynonymValuesTable.clear();
+        dropSynonymsWithoutFactor();
+        return;
+      }
+      if (isAnyGroupFalse != nullptr && *isAnyGroupFalse) {
+        // another group is false. the cancelled group is merged back with no
+        // factor, so it must not leave its synonyms behind either.
+        isCollectingClauseResults = false;
+        clauseSynonymValuesTable.clear();
+        dropSynonymsWithoutFactor();
+        return;
       }
       clauseSynonymValuesTable.clear();
     }
 
     GroupDetails groupDetails = optGroupDetails.value();
+    if (isCollectingClauseResults) {
+      isCollectingClauseResults = false;
+      joinCollectedResults(groupDetails.isBooleanGroup);
+      if (!areAllClausesTrue) {
+        if (isAnyGroupFalse != nullptr) {
+          *isAnyGroupFalse = true;
+        }
+        return;
+      }
+    }
     if (groupDetails.isBooleanGroup) {
       groupQueryResults.clear();
       continue;
     }
-    // after each grp, keep only IntermediateQueryResult with the select syns
-    filterGroupResultsBySelectSynonyms(groupDetails.selectedSynonyms);
-    mergeGroupResultsIntoFinalResults();
+    // after each grp, keep only the distinct values of the select syns. groups
+    // share no synonyms, so their results are never crossed with each other
+    addGroupResultsAsFactor(groupDetails.selectedSynonyms);
     // clean up group data
     filterQuerySynonymsBySelectSynonyms(select.selectSynonyms);
     groupQueryResults.clear();
   }
+}
+
+FinalQueryResults QueryEvaluator::expandFactorisedResults(
+    const SelectClause& select, const FactorisedQueryResults& results) {
+  if (select.selectType == SelectType::BOOLEAN) {
+    return {{results.isTrue ? TRUE_SELECT_BOOL_RESULT
+                            : FALSE_SELECT_BOOL_RESULT}};
+  }
+  FinalQueryResults finalResults = {};
+  if (!results.isTrue) {
+    return finalResults;
+  }
+
+  // factor and column of each select synonym
+  vector<pair<int, int>> positions;
+  for (const Synonym& synonym : select.selectSynonyms) {
+    for (int f = 0; f < results.factors.size(); f++) {
+      const vector<SynName>& synonyms = results.factors[f].synonyms;
+      auto it = find(synonyms.begin(), synonyms.end(), synonym.name);
+      if (it != synonyms.end()) {
+        positions.push_back({f, it - synonyms.begin()});
+        break;
+      }
+    }
+  }
+  // a synonym in no factor has no values to expand
+  if (positions.size() != select.selectSynonyms.size()) {
+    return finalResults;
+  }
+  for (const ResultFactor& factor : results.factors) {
+    if (factor.rows.empty()) {
+      return finalResults;
+    }
+  }
+
+  // enumerate the cross product of the factors like an odometer
+  vector<int> rowIndices(results.factors.size(), 0);
+  while (true) {
+    vector<int> tuple;
+    tuple.reserve(positions.size());
+    for (const auto& position : positions) {
+      tuple.push_back(results.factors[position.first]
+                          .rows[rowIndices[position.first]][position.second]);
+    }
+    finalResults.insert(tuple);
 
-  return getSelectSynonymFinalResults(select);
+    int f = rowIndices.size() - 1;
+    while (f >= 0 && ++rowIndices[f] == results.factors[f].rows.size()) {
+      rowIndices[f] = 0;
+      f--;
+    }
+    if (f < 0) {
+      break;
+    }
+  }
+  return finalResults;
 }
 
 /* Evaluate Such That Clauses -------------------------------------------- */
 void QueryEvaluator::evaluateSuchThatClause(SuchThatClause clause) {
   auto relationshipType = clause.relationshipType;
 
+  // the only clause of a boolean group needs a single pair, not all of them
+  if (isCheckingExistenceOnly && numGroupClauses == 1) {
+    areAllClausesTrue = hasAnySuchThatResult(clause);
+    return;
+  }
+
   switch (clause.relationshipType) {
     case RelationshipType::FOLLOWS:
     case RelationshipType::FOLLOWS_T:
@@ -114,6 +298,7 @@ void QueryEvaluator::evaluateSuchThatClause(SuchThatClause clause) {
     case RelationshipType::AFFECTS:
     case RelationshipType::AFFECTS_T:
     case RelationshipType::AFFECTS_BIP:
+    case RelationshipType::AFFECTS_BIP_T:
       return evaluateSuchThatOnDemandClause(clause);
     default:
       DMOprintErrMsgAndExit(
@@ -206,6 +391,9 @@ void QueryEvaluator::evaluateSuchThatOnDemandClause(SuchThatClause clause) {
   // convert clauses with synonyms to bool clauses if possible
   // by taking INTEGER/NAME_LITERAL results from previous clauses
   auto newParams = getResolvedParamsForOnDemandRs(left, right);
+  if (relationshipType == RelationshipType::AFFECTS) {
+    cacheResolvedAffectsStmts(left, right);
+  }
   if (!newParams.empty()) {
     // if there is any results that can be reused from previous clauses
     for (auto newParam : newParams) {
@@ -260,17 +448,23 @@ void QueryEvaluator::evaluateSuchThatOnDemandClause(SuchThatClause clause) {
 
 bool QueryEvaluator::callOnDemandEvaluatorBool(
     RelationshipType relationshipType, const Param& left, const Param& right) {
+  lock_guard<mutex> lock(getOnDemandMutex(relationshipType));
+  NextOnDemandEvaluator& nextEvaluator = onDemandEvaluators->nextEvaluator;
+  AffectsOnDemandEvaluator& affectsEvaluator =
+      onDemandEvaluators->affectsEvaluator;
   switch (relationshipType) {
     case RelationshipType::NEXT_T:
     case RelationshipType::NEXT_BIP_T:
-      return nextOnDemandEvaluator.evaluateBoolNextTNextBipT(relationshipType,
-                                                             left, right);
+      return nextEvaluator.evaluateBoolNextTNextBipT(relationshipType, left,
+                                                     right);
     case RelationshipType::AFFECTS:
     case RelationshipType::AFFECTS_BIP:
-      return affectsOnDemandEvaluator.evaluateBoolAffects(relationshipType,
-                                                          left, right);
+      return affectsEvaluator.evaluateBoolAffects(relationshipType, left,
+                                                  right);
     case RelationshipType::AFFECTS_T:
-      return affectsOnDemandEvaluator.evaluateBoolAffectsT(left, right);
+      return affectsEvaluator.evaluateBoolAffectsT(left, right);
+    case RelationshipType::AFFECTS_BIP_T:
+      return affectsEvaluator.evaluateBoolAffectsBipT(left, right);
     default:
       return false;
   }
@@ -278,20 +472,28 @@ bool QueryEvaluator::callOnDemandEvaluatorBool(
 
 ClauseIncomingResults QueryEvaluator::callOnDemandEvaluatorRef(
     RelationshipType relationshipType, const Param& left, const Param& right) {
+  lock_guard<mutex> lock(getOnDemandMutex(relationshipType));
+  NextOnDemandEvaluator& nextEvaluator = onDemandEvaluators->nextEvaluator;
+  AffectsOnDemandEvaluator& affectsEvaluator =
+      onDemandEvaluators->affectsEvaluator;
   unordered_set<StmtNo> refResults = {};
   switch (relationshipType) {
     case RelationshipType::NEXT_T:
     case RelationshipType::NEXT_BIP_T:
-      refResults = nextOnDemandEvaluator.evaluateNextTNextBipT(relationshipType,
-                                                               left, right);
+      refResults = nextEvaluator.evaluateNextTNextBipT(
+          relationshipType, left, right,
+          getDomainIntervals(left.type == ParamType::SYNONYM ? left : right));
       break;
     case RelationshipType::AFFECTS:
     case RelationshipType::AFFECTS_BIP:
-      refResults = affectsOnDemandEvaluator.evaluateStmtAffects(
-          relationshipType, left, right);
+      refResults =
+          affectsEvaluator.evaluateStmtAffects(relationshipType, left, right);
       break;
     case RelationshipType::AFFECTS_T:
-      refResults = affectsOnDemandEvaluator.evaluateStmtAffectsT(left, right);
+      refResults = affectsEvaluator.evaluateStmtAffectsT(left, right);
+      break;
+    case RelationshipType::AFFECTS_BIP_T:
+      refResults = affectsEvaluator.evaluateStmtAffectsBipT(left, right);
       break;
     default:
       return {};
@@ -301,22 +503,459 @@ ClauseIncomingResults QueryEvaluator::callOnDemandEvaluatorRef(
 
 ClauseIncomingResults QueryEvaluator::callOnDemandEvaluatorPair(
     RelationshipType relationshipType, const Param& left, const Param& right) {
+  lock_guard<mutex> lock(getOnDemandMutex(relationshipType));
+  NextOnDemandEvaluator& nextEvaluator = onDemandEvaluators->nextEvaluator;
+  AffectsOnDemandEvaluator& affectsEvaluator =
+      onDemandEvaluators->affectsEvaluator;
   switch (relationshipType) {
     case RelationshipType::NEXT_T:
     case RelationshipType::NEXT_BIP_T:
-      return nextOnDemandEvaluator.evaluatePairNextTNextBipT(relationshipType,
-                                                             left, right);
+      return nextEvaluator.evaluatePairNextTNextBipT(
+          relationshipType, left, right, getDomainIntervals(left),
+          getDomainIntervals(right));
     case RelationshipType::AFFECTS:
     case RelationshipType::AFFECTS_BIP:
-      return affectsOnDemandEvaluator.evaluatePairAffects(relationshipType,
-                                                          left, right);
+      return affectsEvaluator.evaluatePairAffects(relationshipType, left,
+                                                  right);
     case RelationshipType::AFFECTS_T:
-      return affectsOnDemandEvaluator.evaluatePairAffectsT(left, right);
+      return affectsEvaluator.evaluatePairAffectsT(left, right);
+    case RelationshipType::AFFECTS_BIP_T:
+      return affectsEvaluator.evaluatePairAffectsBipT(left, right);
     default:
       return {};
   }
 }
 
+mutex& QueryEvaluator::getOnDemandMutex(RelationshipType relationshipType) {
+  return relationshipType == RelationshipType::NEXT_T ||
+                 relationshipType == RelationshipType::NEXT_BIP_T
+             ? onDemandEvaluators->nextMutex
+             : onDemandEvaluators->affectsMutex;
+}
+
+/* Existence Checks For Boolean Groups ---------------------------------- */
+bool QueryEvaluator::hasAnySuchThatResult(const SuchThatClause& clause) {
+  RelationshipType rsType = clause.relationshipType;
+  const Param& left = clause.leftParam;
+  const Param& right = clause.rightParam;
+  bool isLeftSynonym = left.type == ParamType::SYNONYM;
+  bool isRightSynonym = right.type == ParamType::SYNONYM;
+  bool isSameSynonym = isLeftSynonym && isRightSynonym &&
+                       left.value == right.value;
+  bool isLeftLiteral = isLiteralParam(left);
+  bool isRightLiteral = isLiteralParam(right);
+
+  if (!isOnDemandRs(rsType) && (isLeftLiteral || isRightLiteral)) {
+    // pairs of a literal are looked up directly
+    int leftValue =
+        isLeftLiteral ? getLiteralValue(rsType, left, ParamPosition::LEFT) : -1;
+    int rightValue = isRightLiteral
+                         ? getLiteralValue(rsType, right, ParamPosition::RIGHT)
+                         : -1;
+    if (isLeftLiteral && isRightLiteral) {
+      return pkb->isRs(rsType, leftValue, rightValue);
+    }
+    const Param& other = isLeftLiteral ? right : left;
+    for (int value : isLeftLiteral ? pkb->getRight(rsType, leftValue)
+                                   : pkb->getLeft(rsType, rightValue)) {
+      if (other.type != ParamType::SYNONYM || isInDomain(other.value, value)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (!isOnDemandRs(rsType)) {
+    // stored pairs are scanned until one lies in both domains
+    for (const vector<int>& pair :
+         pkb->getMappings(rsType, ParamPosition::BOTH)) {
+      if ((!isLeftSynonym || isInDomain(left.value, pair.front())) &&
+          (!isRightSynonym || isInDomain(right.value, pair.back())) &&
+          (!isSameSynonym || pair.front() == pair.back())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // a synonym that can take any value of the relationship is a wildcard, so
+  // the evaluators can stop at the first pair they find
+  Param wildcard = {ParamType::WILDCARD, "_"};
+  Param newLeft =
+      !isSameSynonym && isWildcardEquivalent(rsType, left) ? wildcard : left;
+  Param newRight =
+      !isSameSynonym && isWildcardEquivalent(rsType, right) ? wildcard : right;
+  if (newLeft.type != ParamType::SYNONYM &&
+      newRight.type != ParamType::SYNONYM) {
+    return callOnDemandEvaluatorBool(rsType, newLeft, newRight);
+  }
+  if (isLeftLiteral || isRightLiteral) {
+    // the row of the literal is scanned for a value in the other's domain
+    const Param& other = isLeftLiteral ? newRight : newLeft;
+    for (const vector<int>& result :
+         callOnDemandEvaluatorRef(rsType, newLeft, newRight)) {
+      if (isInDomain(other.value, result.front())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // otherwise try the values of a restricted synonym one at a time
+  bool isLeftRestricted = newLeft.type == ParamType::SYNONYM;
+  const SynName& synonym = isLeftRestricted ? newLeft.value : newRight.value;
+  for (int value : getDomainValues(synonym)) {
+    Param literal = {ParamType::INTEGER_LITERAL, to_string(value)};
+    Param boundLeft = isLeftRestricted ? literal : newLeft;
+    Param boundRight =
+        isSameSynonym ? literal : isLeftRestricted ? newRight : literal;
+    if (boundLeft.type != ParamType::SYNONYM &&
+        boundRight.type != ParamType::SYNONYM) {
+      if (callOnDemandEvaluatorBool(rsType, boundLeft, boundRight)) {
+        return true;
+      }
+      continue;
+    }
+    const Param& other = isLeftRestricted ? boundRight : boundLeft;
+    for (const vector<int>& result :
+         callOnDemandEvaluatorRef(rsType, boundLeft, boundRight)) {
+      if (isInDomain(other.value, result.front())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool QueryEvaluator::isWildcardEquivalent(RelationshipType rsType,
+                                          const Param& param) {
+  if (param.type != ParamType::SYNONYM) {
+    return param.type == ParamType::WILDCARD;
+  }
+  DesignEntity entity = synonymMap.at(param.value);
+  if (entity == DesignEntity::STATEMENT || entity == DesignEntity::PROG_LINE) {
+    return true;
+  }
+  // only assignments affect each other
+  return entity == DesignEntity::ASSIGN &&
+         (rsType == RelationshipType::AFFECTS ||
+          rsType == RelationshipType::AFFECTS_T ||
+          rsType == RelationshipType::AFFECTS_BIP ||
+          rsType == RelationshipType::AFFECTS_BIP_T);
+}
+
+bool QueryEvaluator::isOnDemandRs(RelationshipType rsType) {
+  return rsType == RelationshipType::NEXT_T ||
+         rsType == RelationshipType::NEXT_BIP_T ||
+         rsType == RelationshipType::AFFECTS ||
+         rsType == RelationshipType::AFFECTS_T ||
+         rsType == RelationshipType::AFFECTS_BIP ||
+         rsType == RelationshipType::AFFECTS_BIP_T;
+}
+
+bool QueryEvaluator::isLiteralParam(const Param& param) {
+  return param.type == ParamType::INTEGER_LITERAL ||
+         param.type == ParamType::NAME_LITERAL;
+}
+
+int QueryEvaluator::getLiteralValue(RelationshipType rsType,
+                                    const Param& param,
+                                    ParamPosition position) {
+  if (param.type == ParamType::INTEGER_LITERAL) {
+    return stoi(param.value);
+  }
+  return position == ParamPosition::LEFT
+             ? convertLeftNameLiteralToInt(rsType, param.value)
+             : convertRightNameLiteralToInt(rsType, param.value);
+}
+
+bool QueryEvaluator::hasAnyPatternResult(
+    const PatternClause& clause, const IntermediateQueryResult& binding) {
+  RelationshipType rsType = getRsTypeForPatternClause(clause);
+  const SynName& synonym = clause.matchSynonym.name;
+  const Param& varParam = clause.leftParam;
+  bool isWithExpr = isPatternWithExpr(clause);
+  auto isPattern = [&](StmtNo stmt, VarIdx varIdx) {
+    return isWithExpr ? pkb->isPatternRs(rsType, stmt, varIdx,
+                                         clause.patternExpr.expr)
+                      : pkb->isPatternRs(rsType, stmt, varIdx);
+  };
+
+  optional<VarIdx> boundVar;
+  if (varParam.type == ParamType::NAME_LITERAL) {
+    boundVar = convertLeftNameLiteralToInt(rsType, varParam.value);
+  } else if (varParam.type == ParamType::SYNONYM &&
+             binding.count(varParam.value) > 0) {
+    boundVar = binding.at(varParam.value);
+  }
+  auto isVarAllowed = [&](VarIdx varIdx) {
+    return boundVar.has_value() ? varIdx == boundVar.value()
+                                : varParam.type != ParamType::SYNONYM ||
+                                      isInDomain(varParam.value, varIdx);
+  };
+  auto hasAnyVarOfStmt = [&](StmtNo stmt) {
+    for (VarIdx varIdx : getPatternVarsOfStmt(rsType, stmt)) {
+      if (isVarAllowed(varIdx) && isPattern(stmt, varIdx)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto bindingIt = binding.find(synonym);
+  if (bindingIt != binding.end()) {
+    return boundVar.has_value()
+               ? isPattern(bindingIt->second, boundVar.value())
+               : hasAnyVarOfStmt(bindingIt->second);
+  }
+  if (boundVar.has_value()) {
+    for (StmtNo stmt : pkb->getRight(rsType, boundVar.value())) {
+      if (isInDomain(synonym, stmt) && isPattern(stmt, boundVar.value())) {
+        return true;
+      }
+    }
+    return false;
+  }
+  for (StmtNo stmt : getDomainValues(synonym)) {
+    if (hasAnyVarOfStmt(stmt)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const unordered_set<VarIdx>& QueryEvaluator::getPatternVarsOfStmt(
+    RelationshipType rsType, StmtNo stmt) {
+  // patterns are only stored from each variable to its statements, so the
+  // other direction is built from the pairs on first use
+  auto varsIt = patternVarsOfStmts.find(rsType);
+  if (varsIt == patternVarsOfStmts.end()) {
+    unordered_map<StmtNo, unordered_set<VarIdx>>& varsOfStmts =
+        patternVarsOfStmts[rsType];
+    for (const vector<int>& pair :
+         pkb->getMappings(rsType, ParamPosition::BOTH)) {
+      varsOfStmts[pair[0]].insert(pair[1]);
+    }
+    varsIt = patternVarsOfStmts.find(rsType);
+  }
+  auto stmtIt = varsIt->second.find(stmt);
+  return stmtIt == varsIt->second.end() ? NO_PATTERN_VARS : stmtIt->second;
+}
+
+/* Depth First Search For Boolean Groups -------------------------------- */
+void QueryEvaluator::evaluateBooleanGroup() {
+  // clauses are taken in the planned order, which binds their synonyms
+  AssignmentSearch search;
+  vector<unsigned long> estimatedSizes;
+  while (true) {
+    SynonymCountsTable synonymCounts = getSynonymCounts();
+    optional<ConditionClause> optClause =
+        optimizer->GetNextClause(synonymCounts);
+    if (!optClause.has_value()) {
+      break;
+    }
+    estimatedSizes.push_back(
+        optimizer->GetEstimatedSizeOfClause(optClause.value()));
+    search.clauses.push_back(optClause.value());
+  }
+
+  unordered_map<SynName, int> depthOfSynonym;
+  vector<int> clausesWithoutSynonyms;
+  for (int c = 0; c < search.clauses.size(); c++) {
+    vector<SynName> synonyms =
+        QueryOptimizer::GetSynonymsOfClause(search.clauses[c]);
+    if (synonyms.empty()) {
+      clausesWithoutSynonyms.push_back(c);
+    }
+    for (const SynName& synonym : synonyms) {
+      if (depthOfSynonym.count(synonym) == 0) {
+        depthOfSynonym[synonym] = search.synonyms.size();
+        search.synonyms.push_back(synonym);
+        search.clausesOfSynonym.push_back({});
+      }
+      vector<int>& clausesOfSynonym =
+          search.clausesOfSynonym[depthOfSynonym[synonym]];
+      if (clausesOfSynonym.empty() || clausesOfSynonym.back() != c) {
+        clausesOfSynonym.push_back(c);
+      }
+    }
+  }
+
+  numClauseIncomingResults = 0;
+  areAllClausesTrue = true;
+  for (int c : clausesWithoutSynonyms) {
+    areAllClausesTrue = areAllClausesTrue &&
+                        isClauseSatisfiable(search.clauses[c], search.binding);
+  }
+  areAllClausesTrue = areAllClausesTrue && searchAssignment(&search, 0);
+  for (int c = 0; c < search.clauses.size(); c++) {
+    explainClause(search.clauses[c], estimatedSizes[c]);
+  }
+}
+
+bool QueryEvaluator::searchAssignment(AssignmentSearch* search, int depth) {
+  // a search cut short finds no clause false, as if it were not evaluated
+  if (depth == search->synonyms.size() || AbstractWrapper::GlobalStop ||
+      (isAnyGroupFalse != nullptr && *isAnyGroupFalse)) {
+    return true;
+  }
+  const SynName& synonym = search->synonyms[depth];
+  for (int value : getCandidateValues(*search, depth)) {
+    numClauseIncomingResults++;
+    search->binding[synonym] = value;
+    bool isConsistent = true;
+    for (int c : search->clausesOfSynonym[depth]) {
+      if (!isClauseSatisfiable(search->clauses[c], search->binding)) {
+        isConsistent = false;
+        break;
+      }
+    }
+    if (isConsistent && searchAssignment(search, depth + 1)) {
+      return true;
+    }
+  }
+  search->binding.erase(synonym);
+  return false;
+}
+
+vector<int> QueryEvaluator::getCandidateValues(const AssignmentSearch& search,
+                                               int depth) {
+  // values paired with what a clause has bound already, else the domain
+  const SynName& synonym = search.synonyms[depth];
+  for (int c : search.clausesOfSynonym[depth]) {
+    optional<unordered_set<int>> values =
+        getValuesPairedWithBound(search.clauses[c], synonym, search.binding);
+    if (!values.has_value()) {
+      continue;
+    }
+    vector<int> candidates;
+    for (int value : values.value()) {
+      if (isInDomain(synonym, value)) {
+        candidates.push_back(value);
+      }
+    }
+    return candidates;
+  }
+  unordered_set<int> domainValues = getDomainValues(synonym);
+  return vector<int>(domainValues.begin(), domainValues.end());
+}
+
+optional<unordered_set<int>> QueryEvaluator::getValuesPairedWithBound(
+    const ConditionClause& clause, const SynName& synonym,
+    const IntermediateQueryResult& binding) {
+  if (clause.conditionClauseType == ConditionClauseType::PATTERN) {
+    const PatternClause& patternClause = clause.patternClause;
+    RelationshipType rsType = getRsTypeForPatternClause(patternClause);
+    const Param& varParam = patternClause.leftParam;
+    bool isVarBound = varParam.type == ParamType::NAME_LITERAL ||
+                      (varParam.type == ParamType::SYNONYM &&
+                       binding.count(varParam.value) > 0);
+    if (patternClause.matchSynonym.name == synonym && isVarBound) {
+      VarIdx varIdx =
+          varParam.type == ParamType::NAME_LITERAL
+              ? convertLeftNameLiteralToInt(rsType, varParam.value)
+              : binding.at(varParam.value);
+      return pkb->getRight(rsType, varIdx);
+    }
+    auto stmtIt = binding.find(patternClause.matchSynonym.name);
+    if (varParam.type == ParamType::SYNONYM && varParam.value == synonym &&
+        stmtIt != binding.end()) {
+      return getPatternVarsOfStmt(rsType, stmtIt->second);
+    }
+    return nullopt;
+  }
+  if (clause.conditionClauseType == ConditionClauseType::WITH) {
+    // the attributes of the domain are hashed against the bound value's
+    const Param& left = clause.withClause.leftParam;
+    const Param& right = clause.withClause.rightParam;
+    bool isLeftOfSynonym = left.value == synonym;
+    const Param& other = isLeftOfSynonym ? right : left;
+    auto otherIt = binding.find(other.value);
+    if (isLiteralParam(other) || otherIt == binding.end() ||
+        left.value == right.value) {
+      return nullopt;
+    }
+    unordered_set<int> values;
+    unordered_set<int> domainValues = getDomainValues(synonym);
+    unordered_set<int> otherValues = {otherIt->second};
+    for (const vector<int>& pair : withEvaluator.joinAttributes(
+             left, right, synonymMap,
+             isLeftOfSynonym ? domainValues : otherValues,
+             isLeftOfSynonym ? otherValues : domainValues)) {
+      values.insert(isLeftOfSynonym ? pair[0] : pair[1]);
+    }
+    return values;
+  }
+
+  SuchThatClause boundClause =
+      bindSuchThatClause(clause.suchThatClause, binding);
+  RelationshipType rsType = boundClause.relationshipType;
+  const Param& left = boundClause.leftParam;
+  const Param& right = boundClause.rightParam;
+  bool isLeftOfSynonym =
+      left.type == ParamType::SYNONYM && left.value == synonym;
+  bool isRightOfSynonym =
+      right.type == ParamType::SYNONYM && right.value == synonym;
+  if (isLeftOfSynonym == isRightOfSynonym ||
+      !isLiteralParam(isLeftOfSynonym ? right : left)) {
+    return nullopt;
+  }
+  if (isOnDemandRs(rsType)) {
+    unordered_set<int> values;
+    for (const vector<int>& result :
+         callOnDemandEvaluatorRef(rsType, left, right)) {
+      values.insert(result.front());
+    }
+    return values;
+  }
+  if (isLeftOfSynonym) {
+    return pkb->getLeft(rsType,
+                        getLiteralValue(rsType, right, ParamPosition::RIGHT));
+  }
+  return pkb->getRight(rsType,
+                       getLiteralValue(rsType, left, ParamPosition::LEFT));
+}
+
+bool QueryEvaluator::isClauseSatisfiable(
+    const ConditionClause& clause, const IntermediateQueryResult& binding) {
+  switch (clause.conditionClauseType) {
+    case ConditionClauseType::SUCH_THAT:
+      return hasAnySuchThatResult(
+          bindSuchThatClause(clause.suchThatClause, binding));
+    case ConditionClauseType::PATTERN:
+      return hasAnyPatternResult(clause.patternClause, binding);
+    case ConditionClauseType::WITH: {
+      // compared once both sides are bound
+      for (const SynName& synonym :
+           QueryOptimizer::GetSynonymsOfClause(clause)) {
+        if (binding.count(synonym) == 0) {
+          return true;
+        }
+      }
+      const WithClause& withClause = clause.withClause;
+      return get<0>(withEvaluator.evaluateAttributes(
+          withClause.leftParam, withClause.rightParam, synonymMap, {binding}));
+    }
+  }
+  return false;
+}
+
+SuchThatClause QueryEvaluator::bindSuchThatClause(
+    const SuchThatClause& clause, const IntermediateQueryResult& binding) {
+  // bound synonyms become literals of their values, as previous clauses
+  // resolve them for on demand relationships
+  SuchThatClause boundClause = clause;
+  for (Param* param : {&boundClause.leftParam, &boundClause.rightParam}) {
+    if (param->type != ParamType::SYNONYM) {
+      continue;
+    }
+    auto bindingIt = binding.find(param->value);
+    if (bindingIt != binding.end()) {
+      *param = {ParamType::INTEGER_LITERAL, to_string(bindingIt->second)};
+    }
+  }
+  return boundClause;
+}
+
 /* Evaluate Pattern Clauses ---------------------------------------------- */
 void QueryEvaluator::evaluatePatternClause(PatternClause clause) {
   auto varParam = clause.leftParam;
@@ -410,9 +1049,10 @@ void QueryEvaluator::evaluateWithClause(WithClause clause) {
 
   bool isLeftParamSynonym = false;
   bool isRightParamSynonym = false;
+  unordered_set<int> leftValues = {};
+  unordered_set<int> rightValues = {};
   ClauseIncomingResults leftSynoynmValues = {};
   ClauseIncomingResults rightSynoynmValues = {};
-  ClauseIncomingResults leftAndRightSynonymValues = {};
 
   unordered_set<ParamType> synonymTypes = {
       ParamType::ATTRIBUTE_PROC_NAME, ParamType::ATTRIBUTE_VAR_NAME,
@@ -421,31 +1061,38 @@ void QueryEvaluator::evaluateWithClause(WithClause clause) {
 
   if (synonymTypes.find(left.type) != synonymTypes.end()) {
     isLeftParamSynonym = true;
-    unordered_set<StmtNo> allValues = getAllValuesOfSynonym(left.value);
-    for (auto value : allValues) {
+    leftValues = getDomainValues(left.value);
+    for (auto value : leftValues) {
       leftSynoynmValues.insert({value});
     }
   }
 
   if (synonymTypes.find(right.type) != synonymTypes.end()) {
     isRightParamSynonym = true;
-    unordered_set<StmtNo> allValues = getAllValuesOfSynonym(right.value);
-    for (auto value : allValues) {
+    rightValues = getDomainValues(right.value);
+    for (auto value : rightValues) {
       rightSynoynmValues.insert({value});
     }
   }
-  if (isLeftParamSynonym && isRightParamSynonym) {
-    for (auto leftStmt : leftSynoynmValues) {
-      for (auto rightStmt : rightSynoynmValues) {
-        leftAndRightSynonymValues.insert({leftStmt[0], rightStmt[0]});
+
+  // two unbound synonyms are joined on their attributes instead of adding
+  // every pair of values and filtering them afterwards
+  auto getLeftAndRightSynonymValues = [&]() {
+    if (left.value == right.value) {
+      ClauseIncomingResults sameSynonymValues;
+      for (int value : leftValues) {
+        sameSynonymValues.insert({value, value});
       }
+      return sameSynonymValues;
     }
-  }
+    return withEvaluator.joinAttributes(left, right, synonymMap, leftValues,
+                                        rightValues);
+  };
 
   if (groupQueryResults.empty()) {
     // initialize results with all possible left and/or right synonym values
     if (isLeftParamSynonym && isRightParamSynonym) {
-      initializeQueryResults(leftAndRightSynonymValues,
+      initializeQueryResults(getLeftAndRightSynonymValues(),
                              {ParamType::SYNONYM, left.value},
                              {ParamType::SYNONYM, right.value});
     } else if (isLeftParamSynonym) {
@@ -466,7 +1113,7 @@ void QueryEvaluator::evaluateWithClause(WithClause clause) {
         !isRightSynInQueryResults) {
       queryResultsSynonyms.insert(left.value);
       queryResultsSynonyms.insert(right.value);
-      crossProduct(leftAndRightSynonymValues, {left.value, right.value});
+      crossProduct(getLeftAndRightSynonymValues(), {left.value, right.value});
     } else if (isLeftParamSynonym && !isLeftSynInQueryResults) {
       queryResultsSynonyms.insert(left.value);
       crossProduct(leftSynoynmValues, {left.value});
@@ -497,6 +1144,7 @@ void QueryEvaluator::evaluateWithClause(WithClause clause) {
 void QueryEvaluator::filterAndAddIncomingResults(
     ClauseIncomingResults incomingResults, const Param& left,
     const Param& right) {
+  numClauseIncomingResults += incomingResults.size();
   if (incomingResults.empty()) {
     areAllClausesTrue = false;
     return;
@@ -509,6 +1157,10 @@ void QueryEvaluator::filterAndAddIncomingResults(
     return;
   }
 
+  if (isCollectingClauseResults) {
+    return collectIncomingResults(filteredIncomingResults, left, right);
+  }
+
   clauseSynonymValuesTable.clear();
   if (groupQueryResults.empty()) {
     initializeQueryResults(filteredIncomingResults, left, right);
@@ -517,6 +1169,46 @@ void QueryEvaluator::filterAndAddIncomingResults(
   }
 }
 
+void QueryEvaluator::collectIncomingResults(
+    const ClauseIncomingResults& incomingResults, const Param& left,
+    const Param& right) {
+  leapfrog::JoinRelation relation;
+  bool isLeftSynonym = left.type == ParamType::SYNONYM;
+  bool isRightSynonym = right.type == ParamType::SYNONYM;
+  if (isLeftSynonym && isRightSynonym && left.value != right.value) {
+    relation.synonyms = {left.value, right.value};
+    for (const vector<int>& incomingResult : incomingResults) {
+      relation.tuples.push_back({incomingResult.front(), incomingResult.back()});
+      clauseSynonymValuesTable[left.value].insert(incomingResult.front());
+      clauseSynonymValuesTable[right.value].insert(incomingResult.back());
+    }
+  } else {
+    const string& synonym = isLeftSynonym ? left.value : right.value;
+    relation.synonyms = {synonym};
+    for (const vector<int>& incomingResult : incomingResults) {
+      int value = isLeftSynonym ? incomingResult.front() : incomingResult.back();
+      relation.tuples.push_back({value});
+      clauseSynonymValuesTable[synonym].insert(value);
+    }
+  }
+  // later clauses of the group are still narrowed by these values
+  collectedRelations.push_back(relation);
+}
+
+void QueryEvaluator::joinCollectedResults(bool isBooleanGroup) {
+  LeapfrogTriejoin triejoin(collectedRelations);
+  collectedRelations.clear();
+  // a boolean group only needs to know if any result exists
+  groupQueryResults = triejoin.join(isBooleanGroup);
+  if (groupQueryResults.empty()) {
+    areAllClausesTrue = false;
+    return;
+  }
+  for (const auto& synonymAndValue : groupQueryResults.front()) {
+    queryResultsSynonyms.insert(synonymAndValue.first);
+  }
+}
+
 void QueryEvaluator::initializeQueryResults(
     ClauseIncomingResults incomingResults, const Param& left,
     const Param& right) {
@@ -567,11 +1259,8 @@ ClauseIncomingResults QueryEvaluator::filterIncomingResults(
     }
 
     for (vector<int> incomingResult : filteredResults) {
-      bool isLeftSynCorrectDesignEntity = checkIsCorrectDesignEntity(
-          incomingResult.front(), synonymMap[left.value]);
-      bool isRightSynCorrectDesignEntity = checkIsCorrectDesignEntity(
-          incomingResult.back(), synonymMap[right.value]);
-      if (isLeftSynCorrectDesignEntity && isRightSynCorrectDesignEntity) {
+      if (isInDomain(left.value, incomingResult.front()) &&
+          isInDomain(right.value, incomingResult.back())) {
         finalResults.insert(incomingResult);
       }
     }
@@ -580,9 +1269,7 @@ ClauseIncomingResults QueryEvaluator::filterIncomingResults(
 
   if (left.type == ParamType::SYNONYM) {
     for (vector<int> incomingResult : incomingResults) {
-      bool isLeftSynCorrectDesignEntity = checkIsCorrectDesignEntity(
-          incomingResult.front(), synonymMap[left.value]);
-      if (isLeftSynCorrectDesignEntity) {
+      if (isInDomain(left.value, incomingResult.front())) {
         finalResults.insert(incomingResult);
       }
     }
@@ -591,9 +1278,7 @@ ClauseIncomingResults QueryEvaluator::filterIncomingResults(
 
   // right.type == ParamType::SYNONYM
   for (vector<int> incomingResult : incomingResults) {
-    bool isRightSynCorrectDesignEntity = checkIsCorrectDesignEntity(
-        incomingResult.back(), synonymMap[right.value]);
-    if (isRightSynCorrectDesignEntity) {
+    if (isInDomain(right.value, incomingResult.back())) {
       finalResults.insert(incomingResult);
     }
   }
@@ -777,6 +1462,10 @@ void QueryEvaluator::crossProduct(ClauseIncomingResults incomingResults,
 }
 
 /* Query Optimization Related Methods --------------------------------------- */
+vector<ClauseExplanation> QueryEvaluator::getClauseExplanations() {
+  return clauseExplanations;
+}
+
 SynonymCountsTable QueryEvaluator::getSynonymCounts() {
   SynonymCountsTable synonymCounts = {};
   for (auto synonymToValues : clauseSynonymValuesTable) {
@@ -797,38 +1486,82 @@ void QueryEvaluator::insertClauseSynonymValue(
   }
 }
 
-void QueryEvaluator::filterGroupResultsBySelectSynonyms(
+void QueryEvaluator::addGroupResultsAsFactor(
     const vector<Synonym>& selectedSynonyms) {
-  vector<IntermediateQueryResult> filteredQueryResults = {};
-  for (auto queryResult : groupQueryResults) {
-    IntermediateQueryResult newResult = {};
-    for (auto synonym : selectedSynonyms) {
-      string synonymName = synonym.name;
-      if (queryResult.find(synonymName) != queryResult.end()) {
-        newResult.insert({synonymName, queryResult.at(synonymName)});
-      }
+  ResultFactor factor;
+  for (const Synonym& synonym : selectedSynonyms) {
+    if (queryResultsSynonyms.count(synonym.name) > 0 &&
+        find(factor.synonyms.begin(), factor.synonyms.end(), synonym.name) ==
+            factor.synonyms.end()) {
+      factor.synonyms.push_back(synonym.name);
+    }
+  }
+  if (factor.synonyms.empty()) {
+    return;
+  }
+
+  unordered_set<vector<int>, VectorHash> distinctRows;
+  for (const IntermediateQueryResult& queryResult : groupQueryResults) {
+    vector<int> row;
+    row.reserve(factor.synonyms.size());
+    for (const SynName& synonym : factor.synonyms) {
+      row.push_back(queryResult.at(synonym));
     }
-    filteredQueryResults.push_back(newResult);
+    distinctRows.insert(move(row));
   }
-  groupQueryResults = filteredQueryResults;
+  factor.rows.assign(distinctRows.begin(), distinctRows.end());
+  resultFactors.push_back(move(factor));
 }
 
-void QueryEvaluator::mergeGroupResultsIntoFinalResults() {
-  if (finalQueryResults.empty()) {
-    finalQueryResults = groupQueryResults;
+void QueryEvaluator::projectAwaySynonyms(const vector<SynName>& synonyms) {
+  vector<SynName> deadSynonyms;
+  for (const SynName& synonym : synonyms) {
+    if (queryResultsSynonyms.erase(synonym) > 0) {
+      deadSynonyms.push_back(synonym);
+    }
+  }
+  if (deadSynonyms.empty() || groupQueryResults.empty()) {
     return;
   }
 
-  vector<IntermediateQueryResult> newFinalQueryResults = {};
-  for (auto finalRes : finalQueryResults) {
-    for (auto intermediateRes : groupQueryResults) {
-      IntermediateQueryResult finalCopy = finalRes;
-      IntermediateQueryResult intermediateCopy = intermediateRes;
-      finalCopy.merge(intermediateCopy);
-      newFinalQueryResults.push_back(finalCopy);
+  // rows that only differed in the dropped columns are now duplicates. the
+  // synonyms of earlier groups are not in the rows of this group
+  vector<SynName> liveSynonyms;
+  for (const auto& synonymAndValue : groupQueryResults.front()) {
+    if (find(deadSynonyms.begin(), deadSynonyms.end(),
+             synonymAndValue.first) == deadSynonyms.end()) {
+      liveSynonyms.push_back(synonymAndValue.first);
+    }
+  }
+  unordered_set<vector<int>, VectorHash> seenRows;
+  vector<IntermediateQueryResult> newQueryResults;
+  for (IntermediateQueryResult& queryResult : groupQueryResults) {
+    vector<int> row;
+    row.reserve(liveSynonyms.size());
+    for (const SynName& synonym : liveSynonyms) {
+      row.push_back(queryResult.at(synonym));
+    }
+    if (!seenRows.insert(move(row)).second) {
+      continue;
+    }
+    for (const SynName& synonym : deadSynonyms) {
+      queryResult.erase(synonym);
+    }
+    newQueryResults.push_back(move(queryResult));
+  }
+  groupQueryResults = move(newQueryResults);
+}
+
+void QueryEvaluator::dropSynonymsWithoutFactor() {
+  unordered_set<string> synonymsInFactors = {};
+  for (const ResultFactor& factor : resultFactors) {
+    for (const SynName& synonym : factor.synonyms) {
+      if (queryResultsSynonyms.count(synonym) > 0) {
+        synonymsInFactors.insert(synonym);
+      }
     }
   }
-  finalQueryResults = newFinalQueryResults;
+  queryResultsSynonyms = synonymsInFactors;
 }
 
 void QueryEvaluator::filterQuerySynonymsBySelectSynonyms(
@@ -842,6 +1575,254 @@ void QueryEvaluator::filterQuerySynonymsBySelectSynonyms(
   queryResultsSynonyms = filteredSynonyms;
 }
 
+void QueryEvaluator::explainClause(const ConditionClause& clause,
+                                   unsigned long estimatedSize) {
+  clauseExplanations.push_back({clause, estimatedSize,
+                                numClauseIncomingResults,
+                                groupQueryResults.size()});
+  if (!DEBUG_MODE) {
+    return;
+  }
+  string description;
+  switch (clause.conditionClauseType) {
+    case ConditionClauseType::SUCH_THAT:
+      description =
+          "such that rs " +
+          to_string(static_cast<int>(clause.suchThatClause.relationshipType)) +
+          " (" + clause.suchThatClause.leftParam.value + ", " +
+          clause.suchThatClause.rightParam.value + ")";
+      break;
+    case ConditionClauseType::PATTERN:
+      description = "pattern " + clause.patternClause.matchSynonym.name + " (" +
+                    clause.patternClause.leftParam.value + ", " +
+                    clause.patternClause.patternExpr.expr + ")";
+      break;
+    case ConditionClauseType::WITH:
+      description = "with " + clause.withClause.leftParam.value + " = " +
+                    clause.withClause.rightParam.value;
+      break;
+  }
+  DMOprintInfoMsg("[QueryEvaluator][EXPLAIN] " + description + ": estimated " +
+                  to_string(estimatedSize) + ", produced " +
+                  to_string(numClauseIncomingResults) + ", rows " +
+                  to_string(groupQueryResults.size()));
+}
+
+/* Semi-Join Reduction of Synonym Domains -------------------------------- */
+void QueryEvaluator::initializeGroupDomains(
+    const vector<ConditionClause>& groupClauses) {
+  synonymDomains.clear();
+  domainIntervals.clear();
+
+  // narrow each synonym by its projection in every clause of the group, so
+  // values that cannot satisfy a later clause are never materialised
+  for (const ConditionClause& clause : groupClauses) {
+    if (clause.conditionClauseType == ConditionClauseType::SUCH_THAT) {
+      narrowDomainsBySuchThatClause(clause.suchThatClause);
+    } else if (clause.conditionClauseType == ConditionClauseType::PATTERN) {
+      narrowDomainsByPatternClause(clause.patternClause);
+    }
+  }
+}
+
+void QueryEvaluator::narrowDomainsBySuchThatClause(
+    const SuchThatClause& clause) {
+  RelationshipType rsType = clause.relationshipType;
+  const Param& left = clause.leftParam;
+  const Param& right = clause.rightParam;
+
+  switch (rsType) {
+    // transitive closures have the same projections as their base rs
+    case RelationshipType::NEXT_T:
+      rsType = RelationshipType::NEXT;
+      break;
+    case RelationshipType::NEXT_BIP_T:
+      rsType = RelationshipType::NEXT_BIP;
+      break;
+    case RelationshipType::AFFECTS:
+    case RelationshipType::AFFECTS_T:
+    case RelationshipType::AFFECTS_BIP:
+    case RelationshipType::AFFECTS_BIP_T:
+      if (left.type == ParamType::SYNONYM) {
+        narrowDomain(left.value, pkb->getAllStmts(DesignEntity::ASSIGN));
+      }
+      if (right.type == ParamType::SYNONYM) {
+        narrowDomain(right.value, pkb->getAllStmts(DesignEntity::ASSIGN));
+      }
+      return;
+    default:
+      break;
+  }
+
+  // integer literals too long for a StmtNo are left for evaluation to handle
+  auto isStmtLiteral = [](const Param& param) {
+    return param.type == ParamType::INTEGER_LITERAL && param.value.size() < 10;
+  };
+  bool isTransitiveClosure = rsType != clause.relationshipType;
+
+  if (left.type == ParamType::SYNONYM) {
+    if (isStmtLiteral(right) && !isTransitiveClosure) {
+      narrowDomain(left.value, pkb->getLeft(rsType, stoi(right.value)));
+    } else if (right.type == ParamType::NAME_LITERAL) {
+      narrowDomain(left.value,
+                   pkb->getLeft(rsType, convertRightNameLiteralToInt(
+                                            rsType, right.value)));
+    } else {
+      narrowDomain(left.value, pkb->getMappings(rsType, ParamPosition::LEFT));
+    }
+  }
+
+  if (right.type == ParamType::SYNONYM) {
+    if (isStmtLiteral(left) && !isTransitiveClosure) {
+      narrowDomain(right.value, pkb->getRight(rsType, stoi(left.value)));
+    } else if (left.type == ParamType::NAME_LITERAL) {
+      narrowDomain(right.value,
+                   pkb->getRight(rsType, convertLeftNameLiteralToInt(
+                                             rsType, left.value)));
+    } else {
+      narrowDomain(right.value,
+                   pkb->getMappings(rsType, ParamPosition::RIGHT));
+    }
+  }
+}
+
+void QueryEvaluator::narrowDomainsByPatternClause(
+    const PatternClause& clause) {
+  RelationshipType rsType = getRsTypeForPatternClause(clause);
+  const Param& varParam = clause.leftParam;
+  const string& synonymName = clause.matchSynonym.name;
+  const string& expr = clause.patternExpr.expr;
+  bool hasExpr = isPatternWithExpr(clause);
+
+  if (varParam.type == ParamType::NAME_LITERAL) {
+    int varValue = convertLeftNameLiteralToInt(rsType, varParam.value);
+    narrowDomain(synonymName,
+                 hasExpr ? pkb->getStmtsForVarAndExpr(rsType, varValue, expr)
+                         : pkb->getStmtsForVar(rsType, varValue));
+    return;
+  }
+
+  if (!hasExpr) {
+    narrowDomain(synonymName, pkb->getMappings(rsType, ParamPosition::LEFT));
+    if (varParam.type == ParamType::SYNONYM) {
+      narrowDomain(varParam.value,
+                   pkb->getMappings(rsType, ParamPosition::RIGHT));
+    }
+    return;
+  }
+
+  SetOfStmts varValues = pkb->getVarsForExpr(rsType, expr);
+  SetOfStmts synValues;
+  for (int varValue : varValues) {
+    SetOfStmts stmts = pkb->getStmtsForVarAndExpr(rsType, varValue, expr);
+    synValues.insert(stmts.begin(), stmts.end());
+  }
+  narrowDomain(synonymName, synValues);
+  if (varParam.type == ParamType::SYNONYM) {
+    narrowDomain(varParam.value, varValues);
+  }
+}
+
+void QueryEvaluator::narrowDomainsByClauseResults() {
+  for (const auto& synonymToValues : clauseSynonymValuesTable) {
+    narrowDomain(synonymToValues.first, synonymToValues.second);
+  }
+}
+
+void QueryEvaluator::narrowDomain(const SynName& synonym,
+                                  const unordered_set<int>& values) {
+  if (synonymMap.find(synonym) == synonymMap.end()) {
+    return;
+  }
+  CandidateDomain& domain = getDomain(synonym);
+  CandidateDomain narrowedDomain(domain.size(), false);
+  for (int value : values) {
+    if (value >= 0 && value < domain.size() && domain[value]) {
+      narrowedDomain[value] = true;
+    }
+  }
+  domain = move(narrowedDomain);
+  domainIntervals.erase(synonym);
+}
+
+void QueryEvaluator::narrowDomain(const SynName& synonym,
+                                  const SetOfStmtLists& valueLists) {
+  if (synonymMap.find(synonym) == synonymMap.end()) {
+    return;
+  }
+  CandidateDomain& domain = getDomain(synonym);
+  CandidateDomain narrowedDomain(domain.size(), false);
+  for (const auto& valueList : valueLists) {
+    int value = valueList.front();
+    if (value >= 0 && value < domain.size() && domain[value]) {
+      narrowedDomain[value] = true;
+    }
+  }
+  domain = move(narrowedDomain);
+  domainIntervals.erase(synonym);
+}
+
+CandidateDomain& QueryEvaluator::getDomain(const SynName& synonym) {
+  auto it = synonymDomains.find(synonym);
+  if (it != synonymDomains.end()) {
+    return it->second;
+  }
+
+  // a synonym starts with every value of its design entity
+  unordered_set<int> allValues = getAllValuesOfSynonym(synonym);
+  int maxValue = -1;
+  for (int value : allValues) {
+    maxValue = max(maxValue, value);
+  }
+  CandidateDomain domain(maxValue + 1, false);
+  for (int value : allValues) {
+    if (value >= 0) {
+      domain[value] = true;
+    }
+  }
+  return synonymDomains[synonym] = move(domain);
+}
+
+bool QueryEvaluator::isInDomain(const SynName& synonym, int value) {
+  // undeclared synonyms have no design entity to restrict them
+  if (synonymMap.find(synonym) == synonymMap.end()) {
+    return true;
+  }
+  const CandidateDomain& domain = getDomain(synonym);
+  return value >= 0 && value < domain.size() && domain[value];
+}
+
+unordered_set<int> QueryEvaluator::getDomainValues(const SynName& synonym) {
+  const CandidateDomain& domain = getDomain(synonym);
+  unordered_set<int> values;
+  for (int value = 0; value < domain.size(); value++) {
+    if (domain[value]) {
+      values.insert(value);
+    }
+  }
+  return values;
+}
+
+const IntervalSet* QueryEvaluator::getDomainIntervals(const Param& param) {
+  if (param.type != ParamType::SYNONYM ||
+      synonymMap.find(param.value) == synonymMap.end()) {
+    return nullptr;
+  }
+  auto intervalsIt = domainIntervals.find(param.value);
+  if (intervalsIt != domainIntervals.end()) {
+    return &intervalsIt->second;
+  }
+  // values are inserted in increasing order, so each is appended
+  const CandidateDomain& domain = getDomain(param.value);
+  IntervalSet& intervals = domainIntervals[param.value];
+  for (int value = 0; value < domain.size(); value++) {
+    if (domain[value]) {
+      intervals.insert(value);
+    }
+  }
+  return &intervals;
+}
+
 /* Helpers to Evaluate Based on Previous Clauses ----------------------- */
 ClauseIncomingResults QueryEvaluator::resolveBothParamsFromResultTable(
     SuchThatClause clause) {
@@ -884,11 +1865,19 @@ unordered_set<int> QueryEvaluator::resolveLeftParam(SuchThatClause clause) {
         break;
       }
 
-      // get from pkb, fall through to WILDCARD case
+      // otherwise get from pkb, skipping values outside the synonym's domain
+      for (const auto& valueList :
+           pkb->getMappings(rsType, ParamPosition::LEFT)) {
+        if (isInDomain(left.value, valueList.front())) {
+          leftValues.insert(valueList.front());
+        }
+      }
+      break;
 
     case ParamType::WILDCARD:
       // get results of left param for rs type
-      for (auto valueList : pkb->getMappings(rsType, ParamPosition::LEFT)) {
+      for (const auto& valueList :
+           pkb->getMappings(rsType, ParamPosition::LEFT)) {
         leftValues.insert(valueList.front());
       }
       break;
@@ -953,7 +1942,9 @@ ClauseIncomingResults QueryEvaluator::resolveRightParamFromLeftValues(
       } else {
         for (int leftValue : leftValues) {
           for (int rightValue : pkb->getRight(rsType, leftValue)) {
-            leftRightValuePairs.insert({leftValue, rightValue});
+            if (isInDomain(right.value, rightValue)) {
+              leftRightValuePairs.insert({leftValue, rightValue});
+            }
           }
         }
       }
@@ -1010,10 +2001,18 @@ unordered_set<int> QueryEvaluator::resolveVarParam(PatternClause clause) {
         }
       } else {
         // if pattern if/while or assign with no expr, get variables
-        for (auto valueList : pkb->getMappings(rsType, ParamPosition::RIGHT)) {
+        for (const auto& valueList :
+             pkb->getMappings(rsType, ParamPosition::RIGHT)) {
           varValues.insert(valueList.front());
         }
       }
+
+      if (varParam.type == ParamType::SYNONYM) {
+        // keep only variables within the synonym's domain
+        for (auto it = varValues.begin(); it != varValues.end();) {
+          it = isInDomain(varParam.value, *it) ? next(it) : varValues.erase(it);
+        }
+      }
       break;
 
     default:
@@ -1061,7 +2060,9 @@ ClauseIncomingResults QueryEvaluator::resolveSynonymParamFromVarValues(
                            ? pkb->getStmtsForVarAndExpr(rsType, varValue, expr)
                            : pkb->getStmtsForVar(rsType, varValue);
       for (int synValue : synValues) {
-        leftRightValuePairs.insert({synValue, varValue});
+        if (isInDomain(synonym.name, synValue)) {
+          leftRightValuePairs.insert({synValue, varValue});
+        }
       }
     }
   }
@@ -1166,6 +2167,30 @@ void QueryEvaluator::resolveRightParamForOnDemandRs(
   }
 }
 
+unordered_set<StmtNo> QueryEvaluator::getBoundStmts(const Param& param) {
+  unordered_set<StmtNo> boundStmts;
+  if (param.type != ParamType::SYNONYM ||
+      queryResultsSynonyms.count(param.value) == 0) {
+    return boundStmts;
+  }
+  for (const IntermediateQueryResult& queryResult : groupQueryResults) {
+    boundStmts.insert(queryResult.at(param.value));
+  }
+  return boundStmts;
+}
+
+void QueryEvaluator::cacheResolvedAffectsStmts(const Param& left,
+                                               const Param& right) {
+  // one pass per procedure gives Affects in both directions, so the values
+  // bound by previous clauses on either side are batched together
+  unordered_set<StmtNo> boundStmts = getBoundStmts(left);
+  boundStmts.merge(getBoundStmts(right));
+  if (boundStmts.size() >= MIN_BATCHED_AFFECTS_STMTS) {
+    lock_guard<mutex> lock(onDemandEvaluators->affectsMutex);
+    onDemandEvaluators->affectsEvaluator.cacheAffectsOfStmts(boundStmts);
+  }
+}
+
 /* Miscellaneous Functions ---------------------------------------------- */
 ClauseIncomingResults QueryEvaluator::formatRefResults(
     unordered_set<int> results) {
@@ -1209,55 +2234,22 @@ unordered_set<int> QueryEvaluator::getAllValuesOfSynonym(string synonymName) {
   }
 }
 
-FinalQueryResults QueryEvaluator::getSelectSynonymFinalResults(
-    SelectClause select) {
-  FinalQueryResults finalResults = {};
-
-  if (select.selectType == SelectType::BOOLEAN) {
-    return {{TRUE_SELECT_BOOL_RESULT}};
-  }
-
+FactorisedQueryResults QueryEvaluator::getFactorisedResults(
+    const SelectClause& select) {
   if (select.selectType == SelectType::SYNONYMS) {
-    for (auto synonym : select.selectSynonyms) {
-      if (queryResultsSynonyms.find(synonym.name) ==
-          queryResultsSynonyms.end()) {
-        unordered_set<int> allValues = getAllValuesOfSynonym(synonym.name);
-        for (int value : allValues) {
-          groupQueryResults.push_back({{synonym.name, value}});
-        }
-        mergeGroupResultsIntoFinalResults();
-        groupQueryResults.clear();
+    // select synonyms used by no clause take all their values
+    unordered_set<SynName> addedSynonyms;
+    for (const Synonym& synonym : select.selectSynonyms) {
+      if (queryResultsSynonyms.count(synonym.name) > 0 ||
+          !addedSynonyms.insert(synonym.name).second) {
+        continue;
       }
-    }
-
-    for (auto result : finalQueryResults) {
-      vector<int> currTupleResult = {};
-      for (auto synonym : select.selectSynonyms) {
-        currTupleResult.push_back(result[synonym.name]);
+      ResultFactor factor = {{synonym.name}, {}};
+      for (int value : getAllValuesOfSynonym(synonym.name)) {
+        factor.rows.push_back({value});
       }
-      finalResults.insert(currTupleResult);
+      resultFactors.push_back(move(factor));
     }
   }
-
-  return finalResults;
-}
-
-bool QueryEvaluator::checkIsCorrectDesignEntity(int result,
-                                                DesignEntity designEntity) {
-  switch (designEntity) {
-    case DesignEntity::READ:
-      return pkb->isStmt(DesignEntity::READ, result);
-    case DesignEntity::PRINT:
-      return pkb->isStmt(DesignEntity::PRINT, result);
-    case DesignEntity::CALL:
-      return pkb->isStmt(DesignEntity::CALL, result);
-    case DesignEntity::WHILE:
-      return pkb->isStmt(DesignEntity::WHILE, result);
-    case DesignEntity::IF:
-      return pkb->isStmt(DesignEntity::IF, result);
-    case DesignEntity::ASSIGN:
-      return pkb->isStmt(DesignEntity::ASSIGN, result);
-    default:
-      return true;
-  }
+  return {true, resultFactors};
 }
@@ -1,13 +1,20 @@
 #pragma once
 
 #include <Common/Common.h>
+#include <Common/IntervalSet.h>
+#include <Common/ThreadPool.h>
 #include <PKB/PKB.h>
 #include <Query/Common.h>
 #include <Query/Evaluator/AffectsOnDemandEvaluator.h>
+#include <Query/Evaluator/LeapfrogTriejoin.h>
 #include <Query/Evaluator/NextOnDemandEvaluator.h>
 #include <Query/Evaluator/WithEvaluator.h>
 #include <Query/Optimizer/QueryOptimizer.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -15,26 +22,77 @@
 #include <utility>
 #include <vector>
 
+// on demand evaluators of a query, shared by the evaluators of its groups so
+// that each reuses what the others cached. each lock guards one evaluator.
+struct OnDemandEvaluators {
+  explicit OnDemandEvaluators(PKB* pkb)
+      : nextEvaluator(pkb), affectsEvaluator(pkb) {}
+  NextOnDemandEvaluator nextEvaluator;
+  AffectsOnDemandEvaluator affectsEvaluator;
+  std::mutex nextMutex;
+  std::mutex affectsMutex;
+};
+
+// synonyms of a boolean group in the order they are bound, with the clauses
+// to check once each is bound
+struct AssignmentSearch {
+  std::vector<query::ConditionClause> clauses;
+  std::vector<query::SynName> synonyms;
+  std::vector<std::vector<int>> clausesOfSynonym;
+  query::IntermediateQueryResult binding;
+};
+
 class QueryEvaluator {
  public:
-  explicit QueryEvaluator(PKB* pkb, QueryOptimizer* optimizer);
+  // independent groups are evaluated concurrently on the given pool
+  explicit QueryEvaluator(
+      PKB* pkb, QueryOptimizer* optimizer,
+      ThreadPool* threadPool = &ThreadPool::getSharedPool());
   query::FinalQueryResults evaluateQuery(query::SynonymMap synonymMap,
                                          query::SelectClause select);
+  // results of independent groups are kept apart instead of crossed
+  query::FactorisedQueryResults evaluateQueryFactorised(
+      query::SynonymMap synonymMap, query::SelectClause select);
+  static query::FinalQueryResults expandFactorisedResults(
+      const query::SelectClause& select,
+      const query::FactorisedQueryResults& results);
   query::SynonymCountsTable getSynonymCounts();
+  // one entry per evaluated clause, in evaluation order
+  std::vector<query::ClauseExplanation> getClauseExplanations();
 
  private:
   query::SynonymMap synonymMap;
   PKB* pkb;
   QueryOptimizer* optimizer;
-  NextOnDemandEvaluator nextOnDemandEvaluator;
-  AffectsOnDemandEvaluator affectsOnDemandEvaluator;
+  ThreadPool* threadPool;
+  // set by any group found false while groups are evaluated concurrently
+  std::atomic<bool>* isAnyGroupFalse;
+  std::shared_ptr<OnDemandEvaluators> onDemandEvaluators;
   WithEvaluator withEvaluator;
 
   bool areAllClausesTrue;
-  std::vector<query::IntermediateQueryResult> finalQueryResults;
+  std::vector<query::ResultFactor> resultFactors;
   std::vector<query::IntermediateQueryResult> groupQueryResults;
   std::unordered_set<std::string> queryResultsSynonyms;
   query::SynonymValuesTable clauseSynonymValuesTable;
+  query::SynonymDomainsTable synonymDomains;
+  // the domains read as intervals, dropped whenever they are narrowed
+  std::unordered_map<query::SynName, IntervalSet> domainIntervals;
+  std::vector<query::ClauseExplanation> clauseExplanations;
+  size_t numClauseIncomingResults;
+  size_t numGroupClauses;
+  // boolean groups only look for one assignment satisfying all clauses
+  bool isCheckingExistenceOnly;
+  // clause results of cyclic groups are kept apart and joined at the end
+  bool isCollectingClauseResults;
+  std::vector<leapfrog::JoinRelation> collectedRelations;
+  // variables of each statement in the pattern relationships searched
+  std::unordered_map<RelationshipType,
+                     std::unordered_map<StmtNo, std::unordered_set<VarIdx>>>
+      patternVarsOfStmts;
+
+  void evaluateGroups(const query::SelectClause& select);
+  void evaluateGroupsInParallel(const query::SelectClause& select);
 
   // methods to build queryResults
   void filterAndAddIncomingResults(query::ClauseIncomingResults incomingResults,
@@ -43,6 +101,10 @@ class QueryEvaluator {
   query::ClauseIncomingResults filterIncomingResults(
       query::ClauseIncomingResults incomingResults, const query::Param& left,
       const query::Param& right);
+  void collectIncomingResults(const query::ClauseIncomingResults& incomingResults,
+                              const query::Param& left,
+                              const query::Param& right);
+  void joinCollectedResults(bool isBooleanGroup);
   void initializeQueryResults(query::ClauseIncomingResults incomingResults,
                               const query::Param& left,
                               const query::Param& right);
@@ -82,6 +144,32 @@ class QueryEvaluator {
   query::ClauseIncomingResults callOnDemandEvaluatorPair(
       RelationshipType relationshipType, const query::Param& left,
       const query::Param& right);
+  std::mutex& getOnDemandMutex(RelationshipType relationshipType);
+
+  // helpers for boolean groups
+  bool hasAnySuchThatResult(const query::SuchThatClause& clause);
+  bool isWildcardEquivalent(RelationshipType rsType, const query::Param& param);
+  static bool isOnDemandRs(RelationshipType rsType);
+  static bool isLiteralParam(const query::Param& param);
+  int getLiteralValue(RelationshipType rsType, const query::Param& param,
+                      ParamPosition position);
+  const std::unordered_set<VarIdx>& getPatternVarsOfStmt(
+      RelationshipType rsType, StmtNo stmt);
+  bool hasAnyPatternResult(const query::PatternClause& clause,
+                           const query::IntermediateQueryResult& binding);
+  // binds one synonym at a time, checking the clauses of each as it is bound
+  void evaluateBooleanGroup();
+  bool searchAssignment(AssignmentSearch* search, int depth);
+  std::vector<int> getCandidateValues(const AssignmentSearch& search,
+                                      int depth);
+  std::optional<std::unordered_set<int>> getValuesPairedWithBound(
+      const query::ConditionClause& clause, const query::SynName& synonym,
+      const query::IntermediateQueryResult& binding);
+  bool isClauseSatisfiable(const query::ConditionClause& clause,
+                           const query::IntermediateQueryResult& binding);
+  static query::SuchThatClause bindSuchThatClause(
+      const query::SuchThatClause& clause,
+      const query::IntermediateQueryResult& binding);
 
   void evaluatePatternClause(query::PatternClause clause);
   RelationshipType getRsTypeForPatternClause(query::PatternClause clause);
@@ -92,11 +180,32 @@ class QueryEvaluator {
   // helpers for query optimization
   void insertClauseSynonymValue(query::IntermediateQueryResult queryResult);
   void updateQuerySynonymCounts();
-  void filterGroupResultsBySelectSynonyms(
+  // drops columns no later clause of the group needs
+  void projectAwaySynonyms(const std::vector<query::SynName>& synonyms);
+  void addGroupResultsAsFactor(
       const std::vector<query::Synonym>& selectedSynonyms);
   void filterQuerySynonymsBySelectSynonyms(
       const std::vector<query::Synonym>& selectedSynonyms);
-  void mergeGroupResultsIntoFinalResults();
+  // synonyms of a group cut short take all their values instead
+  void dropSynonymsWithoutFactor();
+  void explainClause(const query::ConditionClause& clause,
+                     unsigned long estimatedSize);
+
+  // helpers for semi-join reduction of synonym domains within a group
+  void initializeGroupDomains(
+      const std::vector<query::ConditionClause>& groupClauses);
+  void narrowDomainsBySuchThatClause(const query::SuchThatClause& clause);
+  void narrowDomainsByPatternClause(const query::PatternClause& clause);
+  void narrowDomainsByClauseResults();
+  void narrowDomain(const query::SynName& synonym,
+                    const std::unordered_set<int>& values);
+  void narrowDomain(const query::SynName& synonym,
+                    const SetOfStmtLists& valueLists);
+  query::CandidateDomain& getDomain(const query::SynName& synonym);
+  bool isInDomain(const query::SynName& synonym, int value);
+  std::unordered_set<int> getDomainValues(const query::SynName& synonym);
+  // nullptr unless the param is a declared synonym
+  const IntervalSet* getDomainIntervals(const query::Param& param);
 
   // helpers for evaluating based on prev clauses - non on demand rs
   query::ClauseIncomingResults resolveBothParamsFromResultTable(
@@ -126,12 +235,15 @@ class QueryEvaluator {
       const query::Param& left, const query::Param& right,
       std::vector<std::tuple<query::Param, query::Param, ParamPosition>>&
           newParams);
+  // values of a synonym param in the results of previous clauses of the group
+  std::unordered_set<StmtNo> getBoundStmts(const query::Param& param);
+  void cacheResolvedAffectsStmts(const query::Param& left,
+                                 const query::Param& right);
 
   // miscellaneous helpers
   query::ClauseIncomingResults formatRefResults(
       std::unordered_set<int> results);
   std::unordered_set<int> getAllValuesOfSynonym(std::string synonymName);
-  query::FinalQueryResults getSelectSynonymFinalResults(
-      query::SelectClause selectClause);
-  bool checkIsCorrectDesignEntity(int stmtNum, DesignEntity designEntity);
+  query::FactorisedQueryResults getFactorisedResults(
+      const query::SelectClause& selectClause);
 };
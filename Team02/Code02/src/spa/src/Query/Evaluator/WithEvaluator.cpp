@@ -1,6 +1,7 @@
 #include "WithEvaluator.h"
 
 #include <iostream>
+#include <limits>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -15,6 +16,12 @@ using namespace query;
 
 WithEvaluator::WithEvaluator(PKB* pkb) { this->pkb = pkb; }
 
+// key of attributes that equal nothing, such as names missing from a table
+const long long NO_KEY = numeric_limits<long long>::min();
+// constants too large for a long long are keyed by their index in the
+// constant table from here, below every number that fits
+const long long OVERSIZED_NUMBER_KEYS = NO_KEY + 1;
+
 tuple<bool, vector<IntermediateQueryResult>, SynonymValuesTable>
 WithEvaluator::evaluateAttributes(
     const Param& left, const Param& right, const SynonymMap& synonymMap,
@@ -22,271 +29,186 @@ WithEvaluator::evaluateAttributes(
   this->newQueryResults = {};
   this->isClauseTrue = false;
   this->synonymMap = synonymMap;
-  this->currentQueryResults = currentQueryResults;
   this->clauseSynonymValuesTable = {};
+  setKeyDomain(left, right);
 
-  unordered_set<ParamType> nameParamTypes = {ParamType::ATTRIBUTE_PROC_NAME,
-                                             ParamType::ATTRIBUTE_VAR_NAME,
-                                             ParamType::NAME_LITERAL};
-  unordered_set<ParamType> integerParamTypes = {
-      ParamType::ATTRIBUTE_VALUE, ParamType::ATTRIBUTE_STMT_NUM,
-      ParamType::INTEGER_LITERAL, ParamType::SYNONYM};
-
-  if ((nameParamTypes.find(left.type) != nameParamTypes.end()) ||
-      (nameParamTypes.find(right.type) != nameParamTypes.end())) {
-    evaluateNameAttributes(left, right);
-  }
-  if ((integerParamTypes.find(left.type) != integerParamTypes.end()) ||
-      (integerParamTypes.find(right.type) != integerParamTypes.end())) {
-    evaluateIntegerAttributes(left, right);
-  }
-
-  bool areBothNameLiterals = left.type == ParamType::NAME_LITERAL &&
-                             right.type == ParamType::NAME_LITERAL;
-  bool areBothIntegerLiterals = left.type == ParamType::INTEGER_LITERAL &&
-                                right.type == ParamType::INTEGER_LITERAL;
-  if (!areBothNameLiterals && !areBothIntegerLiterals) {
-    isClauseTrue = isClauseTrue && !newQueryResults.empty();
+  if (isLiteral(left) && isLiteral(right)) {
+    // literals of any size are equal exactly when they are spelt the same
+    if (left.value == right.value) {
+      isClauseTrue = true;
+      newQueryResults = currentQueryResults;
+    }
+    return make_tuple(isClauseTrue, newQueryResults, clauseSynonymValuesTable);
+  }
+
+  // literals are resolved once instead of per result
+  long long leftLiteralKey = isLiteral(left) ? getLiteralKey(left) : NO_KEY;
+  long long rightLiteralKey = isLiteral(right) ? getLiteralKey(right) : NO_KEY;
+  for (const IntermediateQueryResult& results : currentQueryResults) {
+    long long leftKey =
+        isLiteral(left) ? leftLiteralKey : getKey(left, results.at(left.value));
+    long long rightKey = isLiteral(right)
+                             ? rightLiteralKey
+                             : getKey(right, results.at(right.value));
+    if (leftKey != NO_KEY && leftKey == rightKey) {
+      isClauseTrue = true;
+      addClauseResultAndUpdateCount(results);
+    }
   }
+  isClauseTrue = isClauseTrue && !newQueryResults.empty();
 
   return make_tuple(isClauseTrue, newQueryResults, clauseSynonymValuesTable);
 }
 
-// ATTRIBUTE_ProcName, ATTRIBUTE_VAR_NAME, NAME_LITERAL
-void WithEvaluator::evaluateNameAttributes(const Param& left,
-                                           const Param& right) {
-  ParamType leftType = left.type;
-  ParamType rightType = right.type;
-  string leftValue = left.value;
-  string rightValue = right.value;
-
-  /* Same Attribute Types ------------------------------------------- */
-  if (leftType == ParamType::ATTRIBUTE_PROC_NAME &&
-      rightType == ParamType::ATTRIBUTE_PROC_NAME) {
-    DesignEntity leftDesignEntity = synonymMap.at(leftValue);
-    DesignEntity rightDesignEntity = synonymMap.at(rightValue);
-    for (auto results : currentQueryResults) {
-      int leftProcIdx =
-          getIndexOfNameAttrOfSynonym(results.at(leftValue), leftDesignEntity);
-      int rightProcIdx = getIndexOfNameAttrOfSynonym(results.at(rightValue),
-                                                     rightDesignEntity);
+ClauseIncomingResults WithEvaluator::joinAttributes(
+    const Param& left, const Param& right, const SynonymMap& synonymMap,
+    const unordered_set<int>& leftValues,
+    const unordered_set<int>& rightValues) {
+  this->synonymMap = synonymMap;
+  setKeyDomain(left, right);
 
-      if (leftProcIdx == rightProcIdx) {
-        isClauseTrue = true;
-        addClauseResultAndUpdateCount(results);
-      }
+  unordered_map<long long, vector<int>> keyToRightValues;
+  for (int rightValue : rightValues) {
+    long long key = getKey(right, rightValue);
+    if (key != NO_KEY) {
+      keyToRightValues[key].push_back(rightValue);
     }
-    return;
   }
 
-  if (leftType == ParamType::ATTRIBUTE_VAR_NAME &&
-      rightType == ParamType::ATTRIBUTE_VAR_NAME) {
-    DesignEntity leftDesignEntity = synonymMap.at(leftValue);
-    DesignEntity rightDesignEntity = synonymMap.at(rightValue);
-    for (auto results : currentQueryResults) {
-      string leftVarName = getNameAttrOfSynonym(results.at(leftValue),
-                                                leftDesignEntity, leftType);
-      string rightVarName = getNameAttrOfSynonym(results.at(rightValue),
-                                                 rightDesignEntity, rightType);
-      if (leftVarName == rightVarName) {
-        isClauseTrue = true;
-        addClauseResultAndUpdateCount(results);
-      }
+  ClauseIncomingResults joinedValues;
+  for (int leftValue : leftValues) {
+    auto it = keyToRightValues.find(getKey(left, leftValue));
+    if (it == keyToRightValues.end()) {
+      continue;
     }
-    return;
-  }
-
-  if (leftType == ParamType::NAME_LITERAL &&
-      rightType == ParamType::NAME_LITERAL) {
-    if (leftValue == rightValue) {
-      isClauseTrue = true;
-      newQueryResults = currentQueryResults;
+    for (int rightValue : it->second) {
+      joinedValues.insert({leftValue, rightValue});
     }
-    return;
-  }
-
-  /* Different Attribute Types --------------------------------------- */
-  if ((leftType == ParamType::ATTRIBUTE_PROC_NAME &&
-       rightType == ParamType::ATTRIBUTE_VAR_NAME) ||
-      (leftType == ParamType::ATTRIBUTE_VAR_NAME &&
-       rightType == ParamType::ATTRIBUTE_PROC_NAME)) {
-    return evaluateProcNameAndVarName(leftValue, rightValue, leftType,
-                                      rightType);
-  }
-  if ((leftType == ParamType::ATTRIBUTE_PROC_NAME &&
-       rightType == ParamType::NAME_LITERAL) ||
-      (leftType == ParamType::ATTRIBUTE_VAR_NAME &&
-       rightType == ParamType::NAME_LITERAL)) {
-    return evaluateNameAttrAndNameLiteral(leftValue, rightValue, leftType);
-  }
-  if ((leftType == ParamType::NAME_LITERAL &&
-       rightType == ParamType::ATTRIBUTE_PROC_NAME) ||
-      (leftType == ParamType::NAME_LITERAL &&
-       rightType == ParamType::ATTRIBUTE_VAR_NAME)) {
-    return evaluateNameAttrAndNameLiteral(rightValue, leftValue, rightType);
   }
+  return joinedValues;
 }
 
-// ATTRIBUTE_VALUE, ATTRIBUTE_STMT_NUM, INTEGER_LITERAL
-void WithEvaluator::evaluateIntegerAttributes(const Param& left,
-                                              const Param& right) {
-  ParamType leftType = left.type;
-  ParamType rightType = right.type;
-  string leftValue = left.value;
-  string rightValue = right.value;
-
-  if (leftType == ParamType::INTEGER_LITERAL &&
-      rightType == ParamType::INTEGER_LITERAL) {
-    if (leftValue == rightValue) {
-      isClauseTrue = true;
-      newQueryResults = currentQueryResults;
-    }
-    return;
-  }
-
-  // same types - (syn, syn), (.value, .value). (.stmt#, .stmt#)
-  // diff types - (syn, .stmt#), (.stmt#, syn)
-  if (leftType == rightType ||
-      (leftType == ParamType::SYNONYM &&
-       rightType == ParamType::ATTRIBUTE_STMT_NUM) ||
-      (leftType == ParamType::ATTRIBUTE_STMT_NUM &&
-       rightType == ParamType::SYNONYM)) {
-    return evaluateIndexes(leftValue, rightValue);
+void WithEvaluator::setKeyDomain(const Param& left, const Param& right) {
+  procToVarNameKeys.clear();
+  constantToNumberKeys.clear();
+  // a procName compared with a varName is looked up as a variable name
+  if (left.type == ParamType::ATTRIBUTE_VAR_NAME ||
+      right.type == ParamType::ATTRIBUTE_VAR_NAME) {
+    keyDomain = KeyDomain::VAR_NAME;
+  } else if (left.type == ParamType::ATTRIBUTE_PROC_NAME ||
+             right.type == ParamType::ATTRIBUTE_PROC_NAME ||
+             left.type == ParamType::NAME_LITERAL) {
+    keyDomain = KeyDomain::PROC_NAME;
+  } else if (isConstant(left) && isConstant(right)) {
+    keyDomain = KeyDomain::CONST_INDEX;
+  } else {
+    keyDomain = KeyDomain::NUMBER;
   }
-
-  // any other combo of .value, .stmt#, int literal
-  return evaluateNumbers(leftValue, rightValue, leftType, rightType);
 }
 
-void WithEvaluator::addClauseResultAndUpdateCount(
-    const query::IntermediateQueryResult& queryResult) {
-  newQueryResults.push_back(queryResult);
-  for (auto synonymValuePair : queryResult) {
-    string synonym = synonymValuePair.first;
-    if (clauseSynonymValuesTable.find(synonym) ==
-        clauseSynonymValuesTable.end()) {
-      clauseSynonymValuesTable[synonym] = {};
-    }
-    clauseSynonymValuesTable[synonym].insert(synonymValuePair.second);
-  }
+bool WithEvaluator::isLiteral(const Param& param) {
+  return param.type == ParamType::NAME_LITERAL ||
+         param.type == ParamType::INTEGER_LITERAL;
 }
 
-// (.procName, .varName)
-void WithEvaluator::evaluateProcNameAndVarName(string firstSyn,
-                                               string secondSyn,
-                                               ParamType firstParamType,
-                                               ParamType secondParamType) {
-  DesignEntity designEntOfSynWithProcName = synonymMap.at(firstSyn);
-  DesignEntity designEntOfSynWithVarName = synonymMap.at(secondSyn);
-
-  for (auto results : currentQueryResults) {
-    int valueOfSynWithProcName = results.at(firstSyn);
-    string procName = getNameAttrOfSynonym(
-        valueOfSynWithProcName, designEntOfSynWithProcName, firstParamType);
-
-    int valueOfSynWithVarName = results.at(secondSyn);
-    string varName = getNameAttrOfSynonym(
-        valueOfSynWithVarName, designEntOfSynWithVarName, secondParamType);
-
-    if (procName == varName) {
-      isClauseTrue = true;
-      addClauseResultAndUpdateCount(results);
-    }
-  }
+bool WithEvaluator::isConstant(const Param& param) {
+  return param.type == ParamType::ATTRIBUTE_VALUE ||
+         (param.type == ParamType::SYNONYM &&
+          synonymMap.at(param.value) == DesignEntity::CONSTANT);
 }
 
-void WithEvaluator::evaluateNameAttrAndNameLiteral(string synWithNameAttr,
-                                                   string nameLiteral,
-                                                   ParamType paramTypeOfSyn) {
-  DesignEntity designEntOfSyn = synonymMap.at(synWithNameAttr);
-
-  for (auto results : currentQueryResults) {
-    int valueOfSynWithNameAttr = results.at(synWithNameAttr);
-    string nameOfSyn = getNameAttrOfSynonym(valueOfSynWithNameAttr,
-                                            designEntOfSyn, paramTypeOfSyn);
-
-    if (nameOfSyn == nameLiteral) {
-      isClauseTrue = true;
-      addClauseResultAndUpdateCount(results);
-    }
+long long WithEvaluator::getLiteralKey(const Param& param) {
+  switch (keyDomain) {
+    case KeyDomain::PROC_NAME:
+      return getNameKey(pkb->getIndexOf(TableType::PROC_TABLE, param.value),
+                        TableType::PROC_TABLE);
+    case KeyDomain::VAR_NAME:
+      return getNameKey(pkb->getIndexOf(TableType::VAR_TABLE, param.value),
+                        TableType::VAR_TABLE);
+    default:
+      return getNumberKey(param.value);
   }
 }
 
-void WithEvaluator::evaluateIndexes(string firstSyn, string secondSyn) {
-  for (auto results : currentQueryResults) {
-    int firstIndex = results.at(firstSyn);
-    int secondIndex = results.at(secondSyn);
-
-    if (firstIndex == secondIndex) {
-      isClauseTrue = true;
-      addClauseResultAndUpdateCount(results);
+long long WithEvaluator::getKey(const Param& param, int valueOfSynonym) {
+  DesignEntity designEntity = synonymMap.at(param.value);
+  switch (param.type) {
+    case ParamType::ATTRIBUTE_PROC_NAME: {
+      int procIdx = designEntity == DesignEntity::PROCEDURE
+                        ? valueOfSynonym
+                        : pkb->getNameAttribute(designEntity, valueOfSynonym);
+      return getNameKey(procIdx, TableType::PROC_TABLE);
     }
-  }
-}
-
-// (value, syn/stmt), (value, int lit), (syn/stmt, int lit)
-void WithEvaluator::evaluateNumbers(string firstValue, string secondValue,
-                                    ParamType firstParamType,
-                                    ParamType secondParamType) {
-  for (auto results : currentQueryResults) {
-    string firstNumber = getNumber(firstValue, firstParamType, results);
-    string secondNumber = getNumber(secondValue, secondParamType, results);
-
-    if (firstNumber == secondNumber) {
-      isClauseTrue = true;
-      addClauseResultAndUpdateCount(results);
+    case ParamType::ATTRIBUTE_VAR_NAME: {
+      int varIdx = designEntity == DesignEntity::VARIABLE
+                       ? valueOfSynonym
+                       : pkb->getNameAttribute(designEntity, valueOfSynonym);
+      return getNameKey(varIdx, TableType::VAR_TABLE);
     }
+    case ParamType::SYNONYM:
+      if (designEntity != DesignEntity::CONSTANT) {
+        return valueOfSynonym;
+      }
+      // a constant synonym on its own stands for its value
+      [[fallthrough]];
+    case ParamType::ATTRIBUTE_VALUE: {
+      if (keyDomain == KeyDomain::CONST_INDEX) {
+        return valueOfSynonym;
+      }
+      auto it = constantToNumberKeys.find(valueOfSynonym);
+      if (it == constantToNumberKeys.end()) {
+        long long key = getNumberKey(
+            pkb->getElementAt(TableType::CONST_TABLE, valueOfSynonym));
+        it = constantToNumberKeys.insert({valueOfSynonym, key}).first;
+      }
+      return it->second;
+    }
+    case ParamType::ATTRIBUTE_STMT_NUM:
+      return valueOfSynonym;
+    default:
+      DMOprintErrMsgAndExit(
+          "[WithEvaluator][getKey] invalid param type of synonym");
+      return NO_KEY;
   }
 }
 
-string WithEvaluator::getNumber(string value, ParamType paramType,
-                                const IntermediateQueryResult& results) {
-  if (paramType == ParamType::ATTRIBUTE_VALUE) {
-    return pkb->getElementAt(TableType::CONST_TABLE, results.at(value));
-  } else if (paramType == ParamType::SYNONYM ||
-             paramType == ParamType::ATTRIBUTE_STMT_NUM) {
-    return to_string(results.at(value));
-  } else {
-    return value;
+long long WithEvaluator::getNameKey(int nameIdx, TableType table) {
+  if (nameIdx < 0) {
+    return NO_KEY;
+  }
+  if (table == TableType::PROC_TABLE && keyDomain == KeyDomain::VAR_NAME) {
+    auto it = procToVarNameKeys.find(nameIdx);
+    if (it == procToVarNameKeys.end()) {
+      string procName = pkb->getElementAt(TableType::PROC_TABLE, nameIdx);
+      int varIdx = pkb->getIndexOf(TableType::VAR_TABLE, procName);
+      it = procToVarNameKeys.insert({nameIdx, varIdx < 0 ? NO_KEY : varIdx})
+               .first;
+    }
+    return it->second;
   }
+  return nameIdx;
 }
 
-int WithEvaluator::getIndexOfNameAttrOfSynonym(
-    int valueOfSynonym, DesignEntity designEntityOfSynonym) {
-  int idx;
-  switch (designEntityOfSynonym) {
-    case DesignEntity::PROCEDURE:
-      idx = valueOfSynonym;
-      break;
-    case DesignEntity::CALL:
-      idx = *(pkb->getRight(RelationshipType::CALLS_S, valueOfSynonym).begin());
-      break;
-    case DesignEntity::VARIABLE:
-      idx = valueOfSynonym;
-      break;
-    case DesignEntity::READ:
-      idx = *(pkb->getRight(RelationshipType::MODIFIES_S, valueOfSynonym))
-                 .begin();
-      break;
-    case DesignEntity::PRINT:
-      idx = *(pkb->getRight(RelationshipType::USES_S, valueOfSynonym)).begin();
-      break;
-    default:
-      DMOprintErrMsgAndExit(
-          "[WithEvaluator][getIndexOfProcName] invalid design entity of "
-          "synonym.procName or synonym.varName");
-      break;
+long long WithEvaluator::getNumberKey(const string& number) {
+  try {
+    return stoll(number);
+  } catch (const exception& e) {
+    // too large to be a statement number, so it can only equal a constant
+    // spelt the same
+    int constIdx = pkb->getIndexOf(TableType::CONST_TABLE, number);
+    return constIdx < 0 ? NO_KEY : OVERSIZED_NUMBER_KEYS + constIdx;
   }
-  return idx;
 }
 
-string WithEvaluator::getNameAttrOfSynonym(int valueOfSynonym,
-                                           DesignEntity designEntity,
-                                           ParamType paramType) {
-  int idx = getIndexOfNameAttrOfSynonym(valueOfSynonym, designEntity);
-  if (paramType == ParamType::ATTRIBUTE_PROC_NAME) {
-    return pkb->getElementAt(TableType::PROC_TABLE, idx);
-  } else {
-    return pkb->getElementAt(TableType::VAR_TABLE, idx);
+void WithEvaluator::addClauseResultAndUpdateCount(
+    const query::IntermediateQueryResult& queryResult) {
+  newQueryResults.push_back(queryResult);
+  for (auto synonymValuePair : queryResult) {
+    string synonym = synonymValuePair.first;
+    if (clauseSynonymValuesTable.find(synonym) ==
+        clauseSynonymValuesTable.end()) {
+      clauseSynonymValuesTable[synonym] = {};
+    }
+    clauseSynonymValuesTable[synonym].insert(synonymValuePair.second);
   }
 }
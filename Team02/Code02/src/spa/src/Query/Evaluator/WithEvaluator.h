@@ -7,6 +7,7 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -20,37 +21,36 @@ class WithEvaluator {
       const query::Param& left, const query::Param& right,
       const query::SynonymMap& synonymMap,
       const std::vector<query::IntermediateQueryResult>& currentQueryResults);
+  // (left value, right value) pairs of two unbound synonyms with equal
+  // attributes, found by hashing the attributes of the right values
+  query::ClauseIncomingResults joinAttributes(
+      const query::Param& left, const query::Param& right,
+      const query::SynonymMap& synonymMap,
+      const std::unordered_set<int>& leftValues,
+      const std::unordered_set<int>& rightValues);
 
  private:
+  // what attributes of a clause are compared as, names by their index in the
+  // table of the domain, numbers by value and two constants by their index
+  enum class KeyDomain { PROC_NAME, VAR_NAME, NUMBER, CONST_INDEX };
+
   PKB* pkb;
   std::vector<query::IntermediateQueryResult> newQueryResults;
   query::SynonymMap synonymMap;
-  std::vector<query::IntermediateQueryResult> currentQueryResults;
   bool isClauseTrue;
   query::SynonymValuesTable clauseSynonymValuesTable;
+  KeyDomain keyDomain;
+  // caches of keys that need a table lookup, filled per clause
+  std::unordered_map<int, long long> procToVarNameKeys;
+  std::unordered_map<int, long long> constantToNumberKeys;
 
-  void evaluateNameAttributes(const query::Param& left,
-                              const query::Param& right);
-  void evaluateIntegerAttributes(const query::Param& left,
-                                 const query::Param& right);
+  void setKeyDomain(const query::Param& left, const query::Param& right);
+  bool isLiteral(const query::Param& param);
+  bool isConstant(const query::Param& param);
+  long long getLiteralKey(const query::Param& param);
+  long long getKey(const query::Param& param, int valueOfSynonym);
+  long long getNameKey(int nameIdx, TableType table);
+  long long getNumberKey(const std::string& number);
   void addClauseResultAndUpdateCount(
       const query::IntermediateQueryResult& queryResult);
-
-  void evaluateProcNameAndVarName(std::string firstSyn, std::string secondSyn,
-                                  query::ParamType firstParamType,
-                                  query::ParamType secondParamType);
-  void evaluateNameAttrAndNameLiteral(std::string synWithProcName,
-                                      std::string nameLiteral,
-                                      query::ParamType paramTypeOfSyn);
-  void evaluateIndexes(std::string firstSyn, std::string secondSyn);
-  void evaluateNumbers(std::string firstValue, std::string secondValue,
-                       query::ParamType firstParamType,
-                       query::ParamType secondParamType);
-  std::string getNumber(std::string value, query::ParamType paramType,
-                        const query::IntermediateQueryResult& results);
-  int getIndexOfNameAttrOfSynonym(int valueOfSynonym,
-                                  DesignEntity designEntity);
-  std::string getNameAttrOfSynonym(int valueOfSynonym,
-                                   DesignEntity designEntityOfSynonym,
-                                   query::ParamType paramType);
 };
@@ -1,7 +1,9 @@
 #include "QueryOptimizer.h"
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -17,8 +19,16 @@ const unordered_set<RelationshipType> expensiveRelationships = {
     RelationshipType::AFFECTS,     RelationshipType::AFFECTS_T,
     RelationshipType::AFFECTS_BIP, RelationshipType::AFFECTS_BIP_T};
 
-QueryOptimizer::QueryOptimizer(PKB* pkb) {
+// fraction of the (stmt, var) pairs of a pattern kept by its expression
+const double EXACT_EXPR_SELECTIVITY = 0.1;
+const double SUB_EXPR_SELECTIVITY = 0.3;
+
+// the planner searches all 2^n subsets of a group
+const int MAX_SEARCHABLE_GROUP_SIZE = 20;
+
+QueryOptimizer::QueryOptimizer(PKB* pkb, int maxPlannedGroupSize) {
   this->pkb = pkb;
+  this->maxPlannedGroupSize = maxPlannedGroupSize;
   this->synonymCountTable = {};
 }
 
@@ -29,13 +39,59 @@ optional<query::ConditionClause> QueryOptimizer::GetNextClause(
     return nullopt;
   }
   Group& group = groupAndInfoPairs[0].first;
-  sortClausesAtGroupIndex(0);
+  if (!groupAndInfoPairs[0].second.hasPlannedOrder) {
+    sortClausesAtGroupIndex(0);
+  }
 
   ConditionClause clause = group[0];
   group.erase(group.begin());
   return {clause};
 }
 
+unsigned long QueryOptimizer::GetEstimatedSizeOfClause(
+    const query::ConditionClause& clause) {
+  return getSizeOfClause(clause, extractSynonymsUsed(clause));
+}
+
+vector<SynName> QueryOptimizer::GetSynonymsOfClause(
+    const ConditionClause& clause) {
+  return extractSynonymsUsed(clause);
+}
+
+vector<SynName> QueryOptimizer::GetDeadSynonyms(
+    const query::ConditionClause& clause) {
+  if (groupAndInfoPairs.empty()) {
+    return {};
+  }
+  unordered_set<SynName> liveSynonyms;
+  for (const Synonym& synonym :
+       groupAndInfoPairs[0].second.details.selectedSynonyms) {
+    liveSynonyms.insert(synonym.name);
+  }
+  for (const ConditionClause& remainingClause : groupAndInfoPairs[0].first) {
+    for (const SynName& synonym : extractSynonymsUsed(remainingClause)) {
+      liveSynonyms.insert(synonym);
+    }
+  }
+
+  vector<SynName> deadSynonyms;
+  for (const SynName& synonym : extractSynonymsUsed(clause)) {
+    if (liveSynonyms.count(synonym) == 0 &&
+        find(deadSynonyms.begin(), deadSynonyms.end(), synonym) ==
+            deadSynonyms.end()) {
+      deadSynonyms.push_back(synonym);
+    }
+  }
+  return deadSynonyms;
+}
+
+vector<query::ConditionClause> QueryOptimizer::GetRemainingClausesOfGroup() {
+  if (groupAndInfoPairs.empty()) {
+    return {};
+  }
+  return groupAndInfoPairs[0].first;
+}
+
 optional<query::GroupDetails> QueryOptimizer::GetNextGroupDetails() {
   if (groupAndInfoPairs.empty()) {
     return nullopt;
@@ -56,6 +112,31 @@ optional<query::GroupDetails> QueryOptimizer::GetNextGroupDetails() {
   return {groupAndInfoPairs[0].second.details};
 }
 
+int QueryOptimizer::GetNumRemainingGroups() {
+  if (groupAndInfoPairs.empty()) {
+    return 0;
+  }
+  return groupAndInfoPairs.size() - (isFirstGroup ? 0 : 1);
+}
+
+vector<QueryOptimizer> QueryOptimizer::SplitRemainingGroups() {
+  int firstRemaining = isFirstGroup ? 0 : 1;
+  vector<QueryOptimizer> groupOptimizers;
+  for (int i = firstRemaining; i < groupAndInfoPairs.size(); i++) {
+    QueryOptimizer groupOptimizer(pkb, maxPlannedGroupSize);
+    groupOptimizer.synonymMap = synonymMap;
+    groupOptimizer.clauseToClauseInfo = clauseToClauseInfo;
+    groupOptimizer.extrapolatedStatistics = extrapolatedStatistics;
+    groupOptimizer.groupAndInfoPairs.push_back(move(groupAndInfoPairs[i]));
+    groupOptimizers.push_back(move(groupOptimizer));
+  }
+  if (groupAndInfoPairs.size() > firstRemaining) {
+    groupAndInfoPairs.erase(groupAndInfoPairs.begin() + firstRemaining,
+                            groupAndInfoPairs.end());
+  }
+  return groupOptimizers;
+}
+
 void QueryOptimizer::PreprocessClauses(SynonymMap map,
                                        const SelectClause& selectClause) {
   synonymMap = std::move(map);
@@ -64,6 +145,13 @@ void QueryOptimizer::PreprocessClauses(SynonymMap map,
   groupAndInfoPairs =
       extractGroupInfo(selectClause.selectSynonyms, groupsOfClauses);
   sortGroups();
+
+  // the planner needs relation sizes measured on the pkb
+  if (pkb->hasStatistics()) {
+    for (int i = 0; i < groupAndInfoPairs.size(); i++) {
+      planClausesAtGroupIndex(i);
+    }
+  }
 }
 
 vector<Group> QueryOptimizer::groupClauses(vector<ConditionClause> clauses) {
@@ -191,7 +279,8 @@ vector<pair<Group, DetailedGrpInfo>> QueryOptimizer::extractGroupInfo(
     bool isLiteralGroup = groupSynonyms.empty();
     bool isBoolGroup = groupSelectSynonyms.empty();
     int totalNumClauses = group.size();
-    DetailedGrpInfo info = {{isBoolGroup, groupSelectSynonyms},
+    DetailedGrpInfo info = {{isBoolGroup, groupSelectSynonyms,
+                             isCyclicGroup(group)},
                             isLiteralGroup,
                             totalNumClauses,
                             numEfficientClauses,
@@ -250,10 +339,8 @@ void QueryOptimizer::sortClausesAtGroupIndex(int index) {
       return isExpensiveB;
     }
 
-    unsigned long estSizeA =
-        getSizeOfClause(clauseA.conditionClauseType, clauseInfoA.synonyms);
-    unsigned long estSizeB =
-        getSizeOfClause(clauseB.conditionClauseType, clauseInfoB.synonyms);
+    unsigned long estSizeA = getSizeOfClause(clauseA, clauseInfoA.synonyms);
+    unsigned long estSizeB = getSizeOfClause(clauseB, clauseInfoB.synonyms);
     if (estSizeA != estSizeB) {
       return estSizeB > estSizeA;
     }
@@ -271,7 +358,146 @@ void QueryOptimizer::sortClausesAtGroupIndex(int index) {
   sort(group.begin(), group.end(), clausesComparator);
 }
 
+void QueryOptimizer::planClausesAtGroupIndex(int index) {
+  // the greedy order already places expensive clauses last, only the clauses
+  // before them are reordered
+  sortClausesAtGroupIndex(index);
+  Group& group = groupAndInfoPairs[index].first;
+  int numCheapClauses = count_if(
+      group.begin(), group.end(), [this](const ConditionClause& clause) {
+        return clauseToClauseInfo[clause].difficulty !=
+               ClauseDifficulty::EXPENSIVE;
+      });
+  if (numCheapClauses < 3 ||
+      numCheapClauses > min(maxPlannedGroupSize, MAX_SEARCHABLE_GROUP_SIZE)) {
+    return;
+  }
+
+  unordered_map<SynName, int> synonymToId;
+  vector<double> synonymDomainSizes;
+  vector<double> clauseSizes;
+  vector<unsigned long long> clauseSynonymMasks;
+  for (int i = 0; i < numCheapClauses; i++) {
+    const vector<string>& synonyms = clauseToClauseInfo[group[i]].synonyms;
+    unsigned long long synonymMask = 0;
+    for (const string& synonym : synonyms) {
+      auto it = synonymToId.find(synonym);
+      if (it == synonymToId.end()) {
+        auto entityIt = synonymMap.find(synonym);
+        int domainSize = entityIt == synonymMap.end()
+                             ? 1
+                             : max(1, pkb->getNumEntity(entityIt->second));
+        it = synonymToId.insert({synonym, synonymDomainSizes.size()}).first;
+        synonymDomainSizes.push_back(domainSize);
+      }
+      synonymMask |= 1ULL << it->second;
+    }
+    clauseSynonymMasks.push_back(synonymMask);
+    // no synonyms are bound yet, so this is the size of the clause alone.
+    // empty clauses still get a small size so that they are evaluated first
+    clauseSizes.push_back(
+        max(0.5, static_cast<double>(getSizeOfClause(group[i], synonyms))));
+  }
+
+  vector<int> order =
+      searchJoinOrder(clauseSizes, clauseSynonymMasks, synonymDomainSizes);
+  Group plannedGroup;
+  for (int clauseId : order) {
+    plannedGroup.push_back(group[clauseId]);
+  }
+  plannedGroup.insert(plannedGroup.end(), group.begin() + numCheapClauses,
+                      group.end());
+  group = plannedGroup;
+  groupAndInfoPairs[index].second.hasPlannedOrder = true;
+}
+
+vector<int> QueryOptimizer::searchJoinOrder(
+    const vector<double>& clauseSizes,
+    const vector<unsigned long long>& clauseSynonymMasks,
+    const vector<double>& synonymDomainSizes) {
+  // Selinger style search over subsets of clauses. The estimated size of a
+  // subset does not depend on the order its clauses were joined in, so the
+  // cheapest order of a subset extends the cheapest order of a smaller one.
+  // The cost of an order is the sum of the sizes of its intermediate results.
+  int numClauses = clauseSizes.size();
+  int numSubsets = 1 << numClauses;
+  vector<double> subsetSizes(numSubsets, 1);
+  vector<unsigned long long> subsetSynonymMasks(numSubsets, 0);
+  vector<double> subsetCosts(numSubsets, numeric_limits<double>::infinity());
+  vector<int> subsetLastClause(numSubsets, -1);
+
+  for (int subset = 1; subset < numSubsets; subset++) {
+    int clauseId = __builtin_ctz(subset);
+    int smallerSubset = subset & (subset - 1);
+    unsigned long long sharedSynonyms =
+        subsetSynonymMasks[smallerSubset] & clauseSynonymMasks[clauseId];
+    double size = subsetSizes[smallerSubset] * clauseSizes[clauseId];
+    for (int synonymId = 0; synonymId < synonymDomainSizes.size();
+         synonymId++) {
+      if (sharedSynonyms & (1ULL << synonymId)) {
+        size /= synonymDomainSizes[synonymId];
+      }
+    }
+    subsetSizes[subset] = size;
+    subsetSynonymMasks[subset] =
+        subsetSynonymMasks[smallerSubset] | clauseSynonymMasks[clauseId];
+  }
+
+  subsetCosts[0] = 0;
+  for (int subset = 0; subset < numSubsets; subset++) {
+    if (subsetCosts[subset] == numeric_limits<double>::infinity()) {
+      continue;
+    }
+    // only extend by connected clauses unless a cross product is unavoidable
+    bool hasConnectedClause = false;
+    for (int clauseId = 0; clauseId < numClauses; clauseId++) {
+      if (!(subset & (1 << clauseId)) &&
+          (subsetSynonymMasks[subset] & clauseSynonymMasks[clauseId])) {
+        hasConnectedClause = true;
+        break;
+      }
+    }
+    for (int clauseId = 0; clauseId < numClauses; clauseId++) {
+      if ((subset & (1 << clauseId)) ||
+          (hasConnectedClause &&
+           !(subsetSynonymMasks[subset] & clauseSynonymMasks[clauseId]))) {
+        continue;
+      }
+      int largerSubset = subset | (1 << clauseId);
+      double cost = subsetCosts[subset] + subsetSizes[largerSubset];
+      if (cost < subsetCosts[largerSubset]) {
+        subsetCosts[largerSubset] = cost;
+        subsetLastClause[largerSubset] = clauseId;
+      }
+    }
+  }
+
+  vector<int> order;
+  for (int subset = numSubsets - 1; subset != 0;
+       subset &= ~(1 << subsetLastClause[subset])) {
+    order.push_back(subsetLastClause[subset]);
+  }
+  reverse(order.begin(), order.end());
+  return order;
+}
+
 unsigned long QueryOptimizer::getSizeOfClause(
+    const query::ConditionClause& clause,
+    const std::vector<std::string>& synonyms) {
+  // without statistics (pkb not built by the DE), assume every combination
+  // of the synonyms' values holds
+  if (!pkb->hasStatistics() ||
+      clause.conditionClauseType == ConditionClauseType::WITH) {
+    return getUniformSizeOfClause(clause.conditionClauseType, synonyms);
+  }
+  double estimate =
+      clause.conditionClauseType == ConditionClauseType::SUCH_THAT
+          ? estimateSuchThatClause(clause.suchThatClause)
+          : estimatePatternClause(clause.patternClause);
+  return static_cast<unsigned long>(ceil(estimate));
+}
+
+unsigned long QueryOptimizer::getUniformSizeOfClause(
     query::ConditionClauseType type, const std::vector<std::string>& synonyms) {
   vector<int> sizes = {};
   for (const string& s : synonyms) {
@@ -291,6 +517,237 @@ unsigned long QueryOptimizer::getSizeOfClause(
   return reduce(sizes.begin(), sizes.end(), 1, multiplies<>());
 }
 
+/* Cost Model ------------------------------------------------------------ */
+double QueryOptimizer::estimateSuchThatClause(const SuchThatClause& clause) {
+  RelationshipType rs = clause.relationshipType;
+  const RsStatistics& stats = getStatisticsOfRs(rs);
+  if (stats.numPairs == 0) {
+    return 0;
+  }
+
+  bool isLeftSynonym = clause.leftParam.type == ParamType::SYNONYM;
+  bool isRightSynonym = clause.rightParam.type == ParamType::SYNONYM;
+  const string& left = clause.leftParam.value;
+  const string& right = clause.rightParam.value;
+  if (!isLeftSynonym && !isRightSynonym) {
+    return 1;
+  }
+
+  if (isLeftSynonym && isRightSynonym) {
+    // assumes the entities of both synonyms are independent
+    return stats.numPairs *
+           getFractionOfPairs(stats, rs, ParamPosition::LEFT, left) *
+           getFractionOfPairs(stats, rs, ParamPosition::RIGHT, right) *
+           getBoundFactor(stats, rs, ParamPosition::LEFT, left) *
+           getBoundFactor(stats, rs, ParamPosition::RIGHT, right);
+  }
+
+  ParamPosition synonymPosition =
+      isLeftSynonym ? ParamPosition::LEFT : ParamPosition::RIGHT;
+  ParamPosition otherPosition =
+      isLeftSynonym ? ParamPosition::RIGHT : ParamPosition::LEFT;
+  const Param& synonymParam = isLeftSynonym ? clause.leftParam
+                                            : clause.rightParam;
+  const Param& otherParam = isLeftSynonym ? clause.rightParam
+                                          : clause.leftParam;
+  double numDistinct =
+      getNumDistinct(stats, rs, synonymPosition, synonymParam.value);
+  double boundFactor =
+      getBoundFactor(stats, rs, synonymPosition, synonymParam.value);
+  if (otherParam.type == ParamType::WILDCARD) {
+    return numDistinct * boundFactor;
+  }
+  // a literal is assumed to relate to as many values as a typical value
+  double numRelated =
+      getTypicalFanOut(stats, otherPosition) *
+      getFractionOfPairs(stats, rs, synonymPosition, synonymParam.value);
+  return min(numDistinct, numRelated) * boundFactor;
+}
+
+double QueryOptimizer::estimatePatternClause(const PatternClause& clause) {
+  RelationshipType rs;
+  switch (clause.matchSynonym.entity) {
+    case DesignEntity::IF:
+      rs = RelationshipType::PTT_IF;
+      break;
+    case DesignEntity::WHILE:
+      rs = RelationshipType::PTT_WHILE;
+      break;
+    default:
+      rs = RelationshipType::PTT_ASSIGN_FULL_EXPR;
+  }
+  // pattern tables map variables (left) to statements (right)
+  const RsStatistics& stats = pkb->getRsStatistics(rs);
+  const string& stmtSynonym = clause.matchSynonym.name;
+  double estimate;
+  switch (clause.leftParam.type) {
+    case ParamType::SYNONYM:
+      estimate =
+          stats.numPairs *
+          getBoundFactor(stats, rs, ParamPosition::LEFT,
+                         clause.leftParam.value) *
+          getBoundFactor(stats, rs, ParamPosition::RIGHT, stmtSynonym);
+      break;
+    case ParamType::NAME_LITERAL:
+      estimate = min<double>(stats.numDistinctRight,
+                             getTypicalFanOut(stats, ParamPosition::LEFT)) *
+                 getBoundFactor(stats, rs, ParamPosition::RIGHT, stmtSynonym);
+      break;
+    default:
+      estimate = stats.numDistinctRight *
+                 getBoundFactor(stats, rs, ParamPosition::RIGHT, stmtSynonym);
+  }
+
+  switch (clause.patternExpr.matchType) {
+    case MatchType::EXACT:
+      return estimate * EXACT_EXPR_SELECTIVITY;
+    case MatchType::SUB_EXPRESSION:
+      return estimate * SUB_EXPR_SELECTIVITY;
+    default:
+      return estimate;
+  }
+}
+
+const RsStatistics& QueryOptimizer::getStatisticsOfRs(RelationshipType rs) {
+  if (expensiveRelationships.find(rs) == expensiveRelationships.end()) {
+    return pkb->getRsStatistics(rs);
+  }
+  auto it = extrapolatedStatistics.find(rs);
+  if (it != extrapolatedStatistics.end()) {
+    return it->second;
+  }
+
+  // on demand relationships are not stored, so their sizes are extrapolated
+  long long numStmts = pkb->getNumEntity(DesignEntity::STATEMENT);
+  long long numProcs = max(1, pkb->getNumEntity(DesignEntity::PROCEDURE));
+  long long numDefUsePairs = pkb->getNumAssignDefUsePairs();
+  RsStatistics stats;
+  switch (rs) {
+    case RelationshipType::NEXT_T:
+      // within a procedure, roughly half the ordered pairs reach each other
+      stats = scaleStatistics(pkb->getRsStatistics(RelationshipType::NEXT),
+                              numStmts * numStmts / (2 * numProcs));
+      break;
+    case RelationshipType::NEXT_BIP_T:
+      stats = scaleStatistics(pkb->getRsStatistics(RelationshipType::NEXT_BIP),
+                              numStmts * numStmts / 2);
+      break;
+    case RelationshipType::AFFECTS:
+      stats = getStatisticsOfAffects(numDefUsePairs / numProcs);
+      break;
+    case RelationshipType::AFFECTS_T:
+      stats = getStatisticsOfAffects(2 * numDefUsePairs / numProcs);
+      break;
+    case RelationshipType::AFFECTS_BIP:
+      stats = getStatisticsOfAffects(numDefUsePairs);
+      break;
+    default:
+      stats = getStatisticsOfAffects(2 * numDefUsePairs);
+  }
+  return extrapolatedStatistics.insert({rs, stats}).first->second;
+}
+
+RsStatistics QueryOptimizer::getStatisticsOfAffects(long long numPairs) {
+  int numDistinct = static_cast<int>(
+      min<long long>(pkb->getNumEntity(DesignEntity::ASSIGN), numPairs));
+  RsStatistics stats;
+  stats.numPairs = numPairs;
+  stats.numDistinctLeft = numDistinct;
+  stats.numDistinctRight = numDistinct;
+  for (DesignEntity entity : {DesignEntity::ASSIGN, DesignEntity::STATEMENT,
+                              DesignEntity::PROG_LINE}) {
+    stats.numPairsByLeftEntity[entity] = numPairs;
+    stats.numPairsByRightEntity[entity] = numPairs;
+    stats.numDistinctLeftByEntity[entity] = numDistinct;
+    stats.numDistinctRightByEntity[entity] = numDistinct;
+  }
+  return stats;
+}
+
+RsStatistics QueryOptimizer::scaleStatistics(const RsStatistics& stats,
+                                             long long numPairs) {
+  if (stats.numPairs == 0) {
+    return stats;
+  }
+  double factor = static_cast<double>(numPairs) / stats.numPairs;
+  RsStatistics scaledStats = stats;
+  scaledStats.numPairs = numPairs;
+  for (auto* numPairsByEntity : {&scaledStats.numPairsByLeftEntity,
+                                 &scaledStats.numPairsByRightEntity}) {
+    for (auto& entityAndNumPairs : *numPairsByEntity) {
+      entityAndNumPairs.second =
+          static_cast<long long>(entityAndNumPairs.second * factor);
+    }
+  }
+  // the shape of the fan-outs is unknown, fall back to the mean
+  scaledStats.leftFanOutHistogram.clear();
+  scaledStats.rightFanOutHistogram.clear();
+  return scaledStats;
+}
+
+double QueryOptimizer::getTypicalFanOut(const RsStatistics& stats,
+                                        ParamPosition position) {
+  bool isLeft = position == ParamPosition::LEFT;
+  const vector<int>& histogram =
+      isLeft ? stats.leftFanOutHistogram : stats.rightFanOutHistogram;
+  if (!histogram.empty()) {
+    return StatisticsKB::getTypicalFanOut(histogram);
+  }
+  int numDistinct = isLeft ? stats.numDistinctLeft : stats.numDistinctRight;
+  return numDistinct == 0 ? 0 : static_cast<double>(stats.numPairs) / numDistinct;
+}
+
+double QueryOptimizer::getFractionOfPairs(const RsStatistics& stats,
+                                          RelationshipType rs,
+                                          ParamPosition position,
+                                          const SynName& synonym) {
+  auto synonymIt = synonymMap.find(synonym);
+  if (!StatisticsKB::isStmtPosition(rs, position) ||
+      synonymIt == synonymMap.end() || stats.numPairs == 0) {
+    return 1;
+  }
+  const auto& numPairsByEntity = position == ParamPosition::LEFT
+                                     ? stats.numPairsByLeftEntity
+                                     : stats.numPairsByRightEntity;
+  auto it = numPairsByEntity.find(synonymIt->second);
+  if (it == numPairsByEntity.end()) {
+    return 0;
+  }
+  return static_cast<double>(it->second) / stats.numPairs;
+}
+
+double QueryOptimizer::getNumDistinct(const RsStatistics& stats,
+                                      RelationshipType rs,
+                                      ParamPosition position,
+                                      const SynName& synonym) {
+  bool isLeft = position == ParamPosition::LEFT;
+  auto synonymIt = synonymMap.find(synonym);
+  if (!StatisticsKB::isStmtPosition(rs, position) ||
+      synonymIt == synonymMap.end()) {
+    return isLeft ? stats.numDistinctLeft : stats.numDistinctRight;
+  }
+  const auto& numDistinctByEntity = isLeft ? stats.numDistinctLeftByEntity
+                                           : stats.numDistinctRightByEntity;
+  auto it = numDistinctByEntity.find(synonymIt->second);
+  return it == numDistinctByEntity.end() ? 0 : it->second;
+}
+
+double QueryOptimizer::getBoundFactor(const RsStatistics& stats,
+                                      RelationshipType rs,
+                                      ParamPosition position,
+                                      const SynName& synonym) {
+  // a synonym already in the results only keeps the values found so far
+  if (synonymCountTable == nullptr ||
+      synonymCountTable->find(synonym) == synonymCountTable->end()) {
+    return 1;
+  }
+  double numDistinct = getNumDistinct(stats, rs, position, synonym);
+  if (numDistinct == 0) {
+    return 0;
+  }
+  return min(1.0, synonymCountTable->at(synonym) / numDistinct);
+}
+
 bool QueryOptimizer::hasCommonSynonyms(
     const std::vector<std::string>& clauseSynonyms) {
   return any_of(clauseSynonyms.begin(), clauseSynonyms.end(),
@@ -300,6 +757,26 @@ bool QueryOptimizer::hasCommonSynonyms(
                 });
 }
 
+bool QueryOptimizer::isCyclicGroup(const Group& group) {
+  // with clauses are evaluated on the results table and cannot take part
+  // in a multi-way join
+  set<pair<SynName, SynName>> edges;
+  unordered_set<SynName> synonyms;
+  for (const ConditionClause& clause : group) {
+    if (clause.conditionClauseType == ConditionClauseType::WITH) {
+      return false;
+    }
+    vector<SynName> clauseSynonyms = extractSynonymsUsed(clause);
+    synonyms.insert(clauseSynonyms.begin(), clauseSynonyms.end());
+    if (clauseSynonyms.size() == 2 && clauseSynonyms[0] != clauseSynonyms[1]) {
+      edges.insert(minmax(clauseSynonyms[0], clauseSynonyms[1]));
+    }
+  }
+  // a group is connected, so its synonym graph is a tree unless it has more
+  // distinct edges than a spanning tree
+  return !synonyms.empty() && edges.size() >= synonyms.size();
+}
+
 vector<SynName> QueryOptimizer::extractSynonymsUsed(
     const ConditionClause& clause) {
   unordered_set<ParamType> synonymTypes = {
@@ -56,6 +56,8 @@ struct DetailedGrpInfo {
   int numEfficientClauses;
   int numExpensiveClauses;
   int groupIndex;
+  // clauses were ordered once by the planner instead of greedily per clause
+  bool hasPlannedOrder = false;
 };
 
 enum ClauseDifficulty { EFFICIENT, EXPENSIVE, NORMAL };
@@ -73,16 +75,34 @@ typedef std::pair<Group, DetailedGrpInfo> GroupAndInfoPair;
 
 class QueryOptimizer {
  public:
-  explicit QueryOptimizer(PKB*);
+  explicit QueryOptimizer(
+      PKB*, int maxPlannedGroupSize = DEFAULT_MAX_PLANNED_GROUP_SIZE);
 
   void PreprocessClauses(query::SynonymMap, const query::SelectClause&);
 
   std::optional<query::GroupDetails> GetNextGroupDetails();
   std::optional<query::ConditionClause> GetNextClause(
       query::SynonymCountsTable&);
+  std::vector<query::ConditionClause> GetRemainingClausesOfGroup();
+  unsigned long GetEstimatedSizeOfClause(const query::ConditionClause&);
+  static std::vector<query::SynName> GetSynonymsOfClause(
+      const query::ConditionClause&);
+  // synonyms of the last returned clause that no remaining clause of its
+  // group uses and its group does not select
+  std::vector<query::SynName> GetDeadSynonyms(const query::ConditionClause&);
+
+  // groups not yet returned by GetNextGroupDetails
+  int GetNumRemainingGroups();
+  // moves each remaining group into an optimizer of its own, so that groups
+  // can be evaluated independently
+  std::vector<QueryOptimizer> SplitRemainingGroups();
+
+  // groups with more non expensive clauses than this are ordered greedily
+  inline static const int DEFAULT_MAX_PLANNED_GROUP_SIZE = 12;
 
  private:
   PKB* pkb;
+  int maxPlannedGroupSize;
 
   query::SynonymMap synonymMap;
   std::unordered_map<query::ConditionClause, optimizer::DetailedClauseInfo,
@@ -91,6 +111,8 @@ class QueryOptimizer {
   query::SynonymCountsTable* synonymCountTable;
   std::vector<optimizer::GroupAndInfoPair> groupAndInfoPairs;
   bool isFirstGroup = true;
+  // statistics of on demand relationships, extrapolated once per query
+  std::unordered_map<RelationshipType, RsStatistics> extrapolatedStatistics;
 
   std::vector<optimizer::Group> groupClauses(
       std::vector<query::ConditionClause>);
@@ -100,10 +122,32 @@ class QueryOptimizer {
 
   void sortGroups();
   void sortClausesAtGroupIndex(int);
+  void planClausesAtGroupIndex(int);
+  static std::vector<int> searchJoinOrder(
+      const std::vector<double>& clauseSizes,
+      const std::vector<unsigned long long>& clauseSynonymMasks,
+      const std::vector<double>& synonymDomainSizes);
 
   static std::vector<query::SynName> extractSynonymsUsed(
       const query::ConditionClause&);
-  unsigned long getSizeOfClause(query::ConditionClauseType,
+  static bool isCyclicGroup(const optimizer::Group&);
+  unsigned long getSizeOfClause(const query::ConditionClause&,
                                 const std::vector<std::string>&);
+  unsigned long getUniformSizeOfClause(query::ConditionClauseType,
+                                       const std::vector<std::string>&);
+
+  // cost model over the relationship statistics collected by the PKB
+  double estimateSuchThatClause(const query::SuchThatClause&);
+  double estimatePatternClause(const query::PatternClause&);
+  const RsStatistics& getStatisticsOfRs(RelationshipType);
+  RsStatistics getStatisticsOfAffects(long long numPairs);
+  static RsStatistics scaleStatistics(const RsStatistics&, long long numPairs);
+  static double getTypicalFanOut(const RsStatistics&, ParamPosition);
+  double getFractionOfPairs(const RsStatistics&, RelationshipType,
+                            ParamPosition, const query::SynName&);
+  double getNumDistinct(const RsStatistics&, RelationshipType, ParamPosition,
+                        const query::SynName&);
+  double getBoundFactor(const RsStatistics&, RelationshipType, ParamPosition,
+                        const query::SynName&);
   bool hasCommonSynonyms(const std::vector<std::string>&);
 };
@@ -32,6 +32,7 @@ const unordered_map<string, RelationshipType> keywordToAffectsType = {
     {"Affects", RelationshipType::AFFECTS},
     {"Affects*", RelationshipType::AFFECTS_T},
     {"AffectsBip", RelationshipType::AFFECTS_BIP},
+    {"AffectsBip*", RelationshipType::AFFECTS_BIP_T},
 };
 
 const unordered_map<string, DesignEntity> keywordToDesignEntity = {
@@ -53,6 +54,10 @@ const unordered_map<string, Attribute> keywordToAttribute = {
     {"value", Attribute::VALUE},
     {"stmt#", Attribute::STMT_NUM}};
 
+const unordered_set<string> clauseKeywords = {
+    "Select", "BOOLEAN", "such", "that", "pattern", "with",
+    "and",    "Uses",    "Modifies"};
+
 const set<DesignEntity> validStmtRefEntities = {
     DesignEntity::STATEMENT, DesignEntity::READ,     DesignEntity::PRINT,
     DesignEntity::WHILE,     DesignEntity::IF,       DesignEntity::ASSIGN,
@@ -104,6 +109,17 @@ optional<QueryToken> QueryParser::peekToken() {
   return {*it};
 }
 // ============ Helpers (Bool checks) ============
+bool QueryParser::IsKeyword(const string& name) {
+  return clauseKeywords.find(name) != clauseKeywords.end() ||
+         keywordToFollowsParentType.find(name) !=
+             keywordToFollowsParentType.end() ||
+         keywordToCallsType.find(name) != keywordToCallsType.end() ||
+         keywordToNextType.find(name) != keywordToNextType.end() ||
+         keywordToAffectsType.find(name) != keywordToAffectsType.end() ||
+         keywordToDesignEntity.find(name) != keywordToDesignEntity.end() ||
+         keywordToAttribute.find(name) != keywordToAttribute.end();
+}
+
 bool QueryParser::isDesignEntity(const string& maybeEntity) {
   return keywordToDesignEntity.find(maybeEntity) != keywordToDesignEntity.end();
 }
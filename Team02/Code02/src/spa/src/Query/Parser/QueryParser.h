@@ -17,6 +17,9 @@ class QueryParser {
   QueryParser();
   std::tuple<query::SynonymMap, query::SelectClause> Parse(const std::string&);
 
+  // true if the given NAME has a fixed meaning in PQL (e.g. Select, Follows)
+  static bool IsKeyword(const std::string&);
+
   // Error messages for invalid queries
   inline static const std::string INVALID_INSUFFICIENT_TOKENS_MSG =
       "QueryParser expected another QueryToken but received None.";
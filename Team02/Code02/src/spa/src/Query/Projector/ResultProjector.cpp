@@ -2,8 +2,10 @@
 
 #include <Common/Global.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -34,15 +36,14 @@ list<string> ResultProjector::formatResults(SelectType selectType,
   }
 
   if (selectType == SelectType::SYNONYMS) {
-    for (auto res : results) {
-      string formattedString = "";
+    string formattedString;
+    for (const vector<int>& res : results) {
+      formattedString.clear();
       for (unsigned long i = 0; i < selectSynonyms.size(); i++) {
-        Synonym synonym = selectSynonyms[i];
-        formattedString += getStringForSynonym(synonym, res[i]);
-
-        if (i != selectSynonyms.size() - 1) {
+        if (i != 0) {
           formattedString += " ";
         }
+        formattedString += getOutputStringForSynonym(selectSynonyms[i], res[i]);
       }
       formattedResults.push_back(formattedString);
     }
@@ -51,6 +52,118 @@ list<string> ResultProjector::formatResults(SelectType selectType,
   return formattedResults;
 }
 
+list<string> ResultProjector::formatFactorisedResults(
+    SelectType selectType, const vector<Synonym>& selectSynonyms,
+    const FactorisedQueryResults& results) {
+  if (selectType == SelectType::BOOLEAN) {
+    return {results.isTrue ? "TRUE" : "FALSE"};
+  }
+  list<string> formattedResults = {};
+  if (!results.isTrue) {
+    return formattedResults;
+  }
+
+  // every value is formatted once per factor row rather than once per tuple
+  vector<int> factorOfSynonym(selectSynonyms.size(), -1);
+  vector<vector<string_view>> cellsOfSynonym(selectSynonyms.size());
+  // every line fits in a buffer sized by the longest value of each column
+  size_t maxLineLength = selectSynonyms.size();
+  for (unsigned long i = 0; i < selectSynonyms.size(); i++) {
+    const Synonym& synonym = selectSynonyms[i];
+    for (unsigned long f = 0; f < results.factors.size(); f++) {
+      const ResultFactor& factor = results.factors[f];
+      auto it =
+          find(factor.synonyms.begin(), factor.synonyms.end(), synonym.name);
+      if (it == factor.synonyms.end()) {
+        continue;
+      }
+      int column = it - factor.synonyms.begin();
+      factorOfSynonym[i] = f;
+      cellsOfSynonym[i].reserve(factor.rows.size());
+      size_t maxCellLength = 0;
+      for (const vector<int>& row : factor.rows) {
+        string_view cell = getOutputStringForSynonym(synonym, row[column]);
+        maxCellLength = max(maxCellLength, cell.size());
+        cellsOfSynonym[i].push_back(cell);
+      }
+      maxLineLength += maxCellLength;
+      break;
+    }
+  }
+  // a synonym in no factor has no values to project
+  if (find(factorOfSynonym.begin(), factorOfSynonym.end(), -1) !=
+      factorOfSynonym.end()) {
+    return formattedResults;
+  }
+  for (const ResultFactor& factor : results.factors) {
+    if (factor.rows.empty()) {
+      return formattedResults;
+    }
+  }
+
+  // rows within a factor are distinct and every factor column is selected, so
+  // each combination of rows gives a distinct tuple
+  vector<unsigned long> rowIndices(results.factors.size(), 0);
+  string formattedString;
+  formattedString.reserve(maxLineLength);
+  while (true) {
+    formattedString.clear();
+    for (unsigned long i = 0; i < selectSynonyms.size(); i++) {
+      if (i != 0) {
+        formattedString += " ";
+      }
+      formattedString += cellsOfSynonym[i][rowIndices[factorOfSynonym[i]]];
+    }
+    formattedResults.push_back(formattedString);
+
+    int f = rowIndices.size() - 1;
+    while (f >= 0 && ++rowIndices[f] == results.factors[f].rows.size()) {
+      rowIndices[f] = 0;
+      f--;
+    }
+    if (f < 0) {
+      break;
+    }
+  }
+
+  return formattedResults;
+}
+
+string_view ResultProjector::getOutputStringForSynonym(const Synonym& synonym,
+                                                      int result) {
+  string_view outputString;
+  if (pkb->hasOutputStrings()) {
+    bool isNameAttribute =
+        synonym.hasAttribute && (synonym.attribute == Attribute::PROC_NAME ||
+                                 synonym.attribute == Attribute::VAR_NAME);
+    switch (synonym.entity) {
+      case DesignEntity::VARIABLE:
+        outputString = pkb->getOutputString(TableType::VAR_TABLE, result);
+        break;
+      case DesignEntity::PROCEDURE:
+        outputString = pkb->getOutputString(TableType::PROC_TABLE, result);
+        break;
+      case DesignEntity::CONSTANT:
+        outputString = pkb->getOutputString(TableType::CONST_TABLE, result);
+        break;
+      case DesignEntity::CALL:
+      case DesignEntity::READ:
+      case DesignEntity::PRINT:
+        outputString = isNameAttribute
+                           ? pkb->getNameAttributeOutputString(result)
+                           : pkb->getStmtOutputString(result);
+        break;
+      default:
+        outputString = pkb->getStmtOutputString(result);
+    }
+  }
+  if (outputString.empty()) {
+    formattedStrings.push_back(getStringForSynonym(synonym, result));
+    outputString = formattedStrings.back();
+  }
+  return outputString;
+}
+
 string ResultProjector::getStringForSynonym(Synonym synonym, int result) {
   bool hasAttribute = synonym.hasAttribute;
   Attribute attribute = synonym.attribute;
@@ -65,8 +178,7 @@ string ResultProjector::getStringForSynonym(Synonym synonym, int result) {
       return pkb->getElementAt(TableType::CONST_TABLE, result);
     case DesignEntity::CALL: {
       if (hasAttribute && attribute == Attribute::PROC_NAME) {
-        int procIdx =
-            *(pkb->getRight(RelationshipType::CALLS_S, result).begin());
+        int procIdx = pkb->getNameAttribute(DesignEntity::CALL, result);
         return pkb->getElementAt(TableType::PROC_TABLE, procIdx);
       } else {
         return to_string(result);
@@ -74,8 +186,7 @@ string ResultProjector::getStringForSynonym(Synonym synonym, int result) {
     }
     case DesignEntity::READ: {
       if (hasAttribute && attribute == Attribute::VAR_NAME) {
-        int varIdx =
-            *pkb->getRight(RelationshipType::MODIFIES_S, result).begin();
+        int varIdx = pkb->getNameAttribute(DesignEntity::READ, result);
         return pkb->getElementAt(TableType::VAR_TABLE, varIdx);
       } else {
         return to_string(result);
@@ -83,7 +194,7 @@ string ResultProjector::getStringForSynonym(Synonym synonym, int result) {
     }
     case DesignEntity::PRINT: {
       if (hasAttribute && attribute == Attribute::VAR_NAME) {
-        int varIdx = *pkb->getRight(RelationshipType::USES_S, result).begin();
+        int varIdx = pkb->getNameAttribute(DesignEntity::PRINT, result);
         return pkb->getElementAt(TableType::VAR_TABLE, varIdx);
       } else {
         return to_string(result);
@@ -3,8 +3,10 @@
 #include <PKB/PKB.h>
 #include <Query/Common.h>
 
+#include <deque>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class ResultProjector {
@@ -13,8 +15,18 @@ class ResultProjector {
   std::list<std::string> formatResults(
       query::SelectType selectType, std::vector<query::Synonym> selectSynonyms,
       query::FinalQueryResults results);
+  // expands the cross product of the factors while writing the output
+  std::list<std::string> formatFactorisedResults(
+      query::SelectType selectType,
+      const std::vector<query::Synonym>& selectSynonyms,
+      const query::FactorisedQueryResults& results);
 
  private:
   PKB* pkb;
+  // owns the strings formatted when the pkb has no output strings
+  std::deque<std::string> formattedStrings;
+
+  std::string_view getOutputStringForSynonym(const query::Synonym& synonym,
+                                             int result);
   std::string getStringForSynonym(query::Synonym synonym, int result);
 };
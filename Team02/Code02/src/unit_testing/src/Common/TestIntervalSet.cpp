@@ -0,0 +1,109 @@
+#include <Common/IntervalSet.h>
+
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("IntervalSet: Consecutive Values Merge Into Intervals") {
+  IntervalSet values({1, 2, 3, 7, 8, 10});
+  REQUIRE(values.getIntervals() ==
+          vector<IntervalSet::Interval>({{1, 3}, {7, 8}, {10, 10}}));
+  REQUIRE(values.size() == 6);
+  REQUIRE(values.contains(2));
+  REQUIRE(values.contains(10));
+  REQUIRE_FALSE(values.contains(4));
+  REQUIRE_FALSE(values.contains(0));
+  REQUIRE_FALSE(values.contains(11));
+  REQUIRE(values.toSet() == unordered_set<int>({1, 2, 3, 7, 8, 10}));
+
+  SECTION("Inserting between intervals joins them") {
+    values.insert(9);
+    REQUIRE(values.getIntervals() ==
+            vector<IntervalSet::Interval>({{1, 3}, {7, 10}}));
+    values.insertInterval(4, 6);
+    REQUIRE(values.getIntervals() == vector<IntervalSet::Interval>({{1, 10}}));
+    REQUIRE(values.size() == 10);
+  }
+
+  SECTION("Inserting in increasing order appends") {
+    IntervalSet appended;
+    for (int value : {1, 2, 3, 7, 8, 10}) {
+      appended.insert(value);
+    }
+    REQUIRE(appended == values);
+  }
+
+  SECTION("Empty set") {
+    IntervalSet empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty.size() == 0);
+    REQUIRE_FALSE(empty.contains(1));
+    values.insertInterval(5, 4);
+    REQUIRE(values == IntervalSet({1, 2, 3, 7, 8, 10}));
+    REQUIRE(values.intersectWith(empty).empty());
+    REQUIRE(values.unionWith(empty) == values);
+    REQUIRE(values.differenceWith(empty) == values);
+  }
+}
+
+TEST_CASE("IntervalSet: Set Operations Agree With Sets Of Values") {
+  mt19937 generator(3230);
+  for (int round = 0; round < 50; round++) {
+    unordered_set<int> left;
+    unordered_set<int> right;
+    for (int i = 0; i < 40; i++) {
+      // runs of values, as Next* rows mostly are
+      int start = generator() % 200;
+      int length = generator() % 6;
+      for (int value = start; value <= start + length; value++) {
+        (i % 2 == 0 ? left : right).insert(value);
+      }
+    }
+    IntervalSet leftSet(left);
+    IntervalSet rightSet(right);
+
+    unordered_set<int> expectedUnion = left;
+    expectedUnion.insert(right.begin(), right.end());
+    unordered_set<int> expectedIntersection;
+    unordered_set<int> expectedDifference;
+    for (int value : left) {
+      if (right.count(value) > 0) {
+        expectedIntersection.insert(value);
+      } else {
+        expectedDifference.insert(value);
+      }
+    }
+
+    REQUIRE(leftSet.unionWith(rightSet).toSet() == expectedUnion);
+    REQUIRE(leftSet.intersectWith(rightSet).toSet() == expectedIntersection);
+    REQUIRE(leftSet.differenceWith(rightSet).toSet() == expectedDifference);
+    REQUIRE(leftSet.unionWith(rightSet) == IntervalSet(expectedUnion));
+    REQUIRE(leftSet.differenceWith(rightSet) ==
+            IntervalSet(expectedDifference));
+  }
+}
+
+TEST_CASE("IntervalSet: Inserted Intervals Agree With Sets Of Values") {
+  mt19937 generator(3230);
+  for (int round = 0; round < 50; round++) {
+    unordered_set<int> expected;
+    IntervalSet values;
+    for (int i = 0; i < 40; i++) {
+      // runs of values in any order, as Next* rows are found
+      int start = generator() % 200;
+      int length = generator() % 6;
+      values.insertInterval(start, start + length);
+      for (int value = start; value <= start + length; value++) {
+        expected.insert(value);
+      }
+    }
+
+    REQUIRE(values.toSet() == expected);
+    REQUIRE(values == IntervalSet(expected));
+    REQUIRE(values.size() == expected.size());
+  }
+}
@@ -0,0 +1,45 @@
+#include <Common/ThreadPool.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("ThreadPool: Runs All Tasks") {
+  ThreadPool pool(2);
+  atomic<int> sum(0);
+  vector<future<void>> futures;
+  for (int i = 1; i <= 100; i++) {
+    futures.push_back(pool.submit([&sum, i] { sum += i; }));
+  }
+  pool.wait(&futures);
+  REQUIRE(sum == 5050);
+}
+
+TEST_CASE("ThreadPool: Tasks Waiting On Nested Tasks") {
+  // the only worker waits on tasks it submitted, which it runs itself
+  ThreadPool pool(1);
+  atomic<int> numRun(0);
+  vector<future<void>> futures;
+  futures.push_back(pool.submit([&pool, &numRun] {
+    vector<future<void>> nestedFutures;
+    for (int i = 0; i < 4; i++) {
+      nestedFutures.push_back(pool.submit([&numRun] { numRun++; }));
+    }
+    pool.wait(&nestedFutures);
+    numRun++;
+  }));
+  pool.wait(&futures);
+  REQUIRE(numRun == 5);
+}
+
+TEST_CASE("ThreadPool: Rethrows Exceptions Of Tasks") {
+  ThreadPool pool(1);
+  vector<future<void>> futures;
+  futures.push_back(pool.submit([] { throw runtime_error("task failed"); }));
+  REQUIRE_THROWS_AS(pool.wait(&futures), runtime_error);
+}
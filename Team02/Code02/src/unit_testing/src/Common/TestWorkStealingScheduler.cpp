@@ -0,0 +1,62 @@
+#include <Common/ThreadPool.h>
+#include <Common/WorkStealingScheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("WorkStealingScheduler: Runs Every Task Once") {
+  ThreadPool threadPool(3);
+  for (int numWorkers : {1, 2, 4, 8}) {
+    WorkStealingScheduler scheduler(&threadPool, numWorkers);
+    vector<atomic<int>> timesRun(100);
+    atomic<bool> isWorkerInRange(true);
+    scheduler.run(timesRun.size(), [&](int task, int worker) {
+      timesRun[task]++;
+      if (worker < 0 || worker >= numWorkers) {
+        isWorkerInRange = false;
+      }
+    });
+    for (const atomic<int>& times : timesRun) {
+      REQUIRE(times == 1);
+    }
+    REQUIRE(isWorkerInRange);
+  }
+}
+
+TEST_CASE("WorkStealingScheduler: Idle Workers Steal Tasks") {
+  // each worker starts with 4 tasks and runs its own from the back, so task 3
+  // is held up by the first worker until the second steals from its queue
+  ThreadPool threadPool(1);
+  WorkStealingScheduler scheduler(&threadPool, 2);
+  vector<atomic<int>> timesRun(8);
+  atomic<int> numStolen(0);
+  scheduler.run(timesRun.size(), [&](int task, int worker) {
+    if (task / 4 != worker) {
+      numStolen++;
+    }
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    while (task == 3 && numStolen == 0 &&
+           chrono::steady_clock::now() < deadline) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    timesRun[task]++;
+  });
+  for (const atomic<int>& times : timesRun) {
+    REQUIRE(times == 1);
+  }
+  REQUIRE(numStolen > 0);
+}
+
+TEST_CASE("WorkStealingScheduler: No Tasks") {
+  ThreadPool threadPool(1);
+  WorkStealingScheduler scheduler(&threadPool, 4);
+  int numRun = 0;
+  scheduler.run(0, [&numRun](int task, int worker) { numRun++; });
+  REQUIRE(numRun == 0);
+}
@@ -4,6 +4,10 @@
 #include <PKB/PKB.h>
 #include <Parser/Parser.h>
 
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
 #include "catch.hpp"
 
 using namespace std;
@@ -359,3 +363,142 @@ TEST_CASE("[DE][AffectsInfo] multiple procedures") {
   REQUIRE(set(allFirstStmts.begin(), allFirstStmts.end()) ==
           set<int>({1, 2, 4}));
 }
+
+TEST_CASE("[DE][StmtRanges] structural Next* agrees with the CFG") {
+  string program =
+      "procedure a {                "
+      "  x = 1;                     "  // 1
+      "  if (x == 0) then {         "  // 2
+      "    while (x == 0) {         "  // 3
+      "      if (y == 2) then {     "  // 4
+      "        x = 2; }             "  // 5
+      "      else { y = 3; }        "  // 6
+      "      x = 4; }               "  // 7
+      "    if (z == 1) then {       "  // 8
+      "      z = 2; }               "  // 9
+      "    else {                   "
+      "      if (z == 2) then {     "  // 10
+      "        z = 3; }             "  // 11
+      "      else { z = 4; } } }    "  // 12
+      "  else {                     "
+      "    call b;                  "  // 13
+      "    while (y == 0) {         "  // 14
+      "      if (y == 1) then {     "  // 15
+      "        y = 2; }             "  // 16
+      "      else {                 "
+      "        while (y == 3) {     "  // 17
+      "          y = 4; } } } }     "  // 18
+      "  print x;                   "  // 19
+      "}                            "
+      "procedure b {                "
+      "  if (x == 0) then {         "  // 20
+      "    x = 1; }                 "  // 21
+      "  else { x = 2; }            "  // 22
+      "}                            ";
+
+  ProgramAST* ast = Parser().Parse(Tokenizer::TokenizeProgramString(program));
+  PKB* pkb = new PKB();
+  DesignExtractor de = DesignExtractor(pkb);
+  de.Extract(ast);
+
+  REQUIRE(pkb->hasStmtRanges());
+  REQUIRE(pkb->isStructuralNextT(5, 6));
+  REQUIRE(pkb->isStructuralNextT(7, 3));
+  REQUIRE_FALSE(pkb->isStructuralNextT(9, 10));
+  REQUIRE_FALSE(pkb->isStructuralNextT(5, 13));
+  REQUIRE_FALSE(pkb->isStructuralNextT(19, 20));
+  REQUIRE(pkb->getStructuralNextTStmts(9, true).getIntervals() ==
+          vector<IntervalSet::Interval>({{19, 19}}));
+  REQUIRE(pkb->getStructuralNextTStmts(16, false).getIntervals() ==
+          vector<IntervalSet::Interval>({{1, 2}, {13, 18}}));
+
+  // the reachability index searches the CFG itself
+  for (int s1 = 0; s1 <= 23; s1++) {
+    unordered_set<int> forwardStmts;
+    unordered_set<int> backwardStmts;
+    for (int s2 = 0; s2 <= 23; s2++) {
+      CHECK(pkb->isStructuralNextT(s1, s2) == pkb->isNextT(s1, s2));
+      if (pkb->isNextT(s1, s2)) {
+        forwardStmts.insert(s2);
+      }
+      if (pkb->isNextT(s2, s1)) {
+        backwardStmts.insert(s2);
+      }
+    }
+    CHECK(pkb->getStructuralNextTStmts(s1, true).toSet() == forwardStmts);
+    CHECK(pkb->getStructuralNextTStmts(s1, false).toSet() == backwardStmts);
+  }
+}
+
+TEST_CASE("[DE][Dominators] dominator trees agree with the CFG") {
+  string program =
+      "procedure a {                "
+      "  x = 1;                     "  // 1
+      "  if (x == 0) then {         "  // 2
+      "    while (x == 0) {         "  // 3
+      "      if (y == 2) then {     "  // 4
+      "        x = 2; }             "  // 5
+      "      else { y = 3; }        "  // 6
+      "      x = 4; }               "  // 7
+      "    z = 1; }                 "  // 8
+      "  else {                     "
+      "    call b;                  "  // 9
+      "    while (y == 0) {         "  // 10
+      "      y = 2; } }             "  // 11
+      "  print x;                   "  // 12
+      "}                            "
+      "procedure b {                "
+      "  if (x == 0) then {         "  // 13
+      "    x = 1; }                 "  // 14
+      "  else { x = 2; }            "  // 15
+      "}                            ";
+
+  ProgramAST* ast = Parser().Parse(Tokenizer::TokenizeProgramString(program));
+  PKB* pkb = new PKB();
+  DesignExtractor de = DesignExtractor(pkb);
+  de.Extract(ast);
+
+  REQUIRE(pkb->hasDominators());
+  REQUIRE(pkb->isDominator(2, 11));
+  REQUIRE(pkb->isDominator(3, 8));
+  REQUIRE_FALSE(pkb->isDominator(5, 7));
+  REQUIRE(pkb->isPostDominator(12, 1));
+  REQUIRE(pkb->isPostDominator(8, 3));
+  REQUIRE_FALSE(pkb->isPostDominator(3, 2));
+  REQUIRE_FALSE(pkb->isPostDominator(14, 13));
+  REQUIRE_FALSE(pkb->isDominator(1, 13));
+
+  // d dominates s if s cannot be reached from the entry without d, and
+  // post-dominates it if no exit can be reached from s without d
+  auto canReach = [pkb](StmtNo from, unordered_set<StmtNo> targets,
+                        StmtNo avoidedStmt) {
+    unordered_set<StmtNo> visited = {from};
+    vector<StmtNo> stmtStack = {from};
+    while (!stmtStack.empty()) {
+      StmtNo stmt = stmtStack.back();
+      stmtStack.pop_back();
+      if (targets.count(stmt) > 0) {
+        return true;
+      }
+      for (StmtNo next : pkb->getRight(RelationshipType::NEXT, stmt)) {
+        if (next != avoidedStmt && visited.insert(next).second) {
+          stmtStack.push_back(next);
+        }
+      }
+    }
+    return false;
+  };
+  vector<tuple<StmtNo, StmtNo, unordered_set<StmtNo>>> procs = {
+      {1, 12, {12}}, {13, 15, {14, 15}}};
+  for (const auto& [firstStmt, lastStmt, exitStmts] : procs) {
+    for (StmtNo d = firstStmt; d <= lastStmt; d++) {
+      for (StmtNo stmt = firstStmt; stmt <= lastStmt; stmt++) {
+        bool isDominator =
+            d == stmt || d == firstStmt || !canReach(firstStmt, {stmt}, d);
+        bool isPostDominator = d == stmt || !canReach(stmt, exitStmts, d);
+        CHECK(pkb->isDominator(d, stmt) == isDominator);
+        CHECK(pkb->isPostDominator(d, stmt) == isPostDominator);
+      }
+    }
+  }
+}
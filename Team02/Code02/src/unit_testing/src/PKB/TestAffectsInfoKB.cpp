@@ -1,4 +1,5 @@
 #include <set>
+#include <utility>
 
 #include "PKB/PKB.h"
 #include "catch.hpp"
@@ -40,4 +41,19 @@ TEST_CASE("AFFECTS_INFO_TABLE") {
 
   // invalid queries
   REQUIRE(db.getNextStmtForIfStmt(2) == -1);
+
+  SECTION("Procedures of stmts and their ranges") {
+    for (int s = 1; s <= 7; s++) {
+      db.addProcOfStmt(s < 4 ? "a" : "b", s);
+    }
+    ProcIdx a = db.getIndexOf(TableType::PROC_TABLE, "a");
+    ProcIdx b = db.getIndexOf(TableType::PROC_TABLE, "b");
+    REQUIRE(db.getProcOfStmt(3) == a);
+    REQUIRE(db.getProcOfStmt(4) == b);
+    REQUIRE(db.getProcRange(a) == pair<StmtNo, StmtNo>({1, 3}));
+    REQUIRE(db.getProcRange(b) == pair<StmtNo, StmtNo>({4, 7}));
+    REQUIRE(db.getProcOfStmt(0) == -1);
+    REQUIRE(db.getProcOfStmt(8) == -1);
+    REQUIRE(db.getProcRange(2) == pair<StmtNo, StmtNo>({-1, -1}));
+  }
 }
@@ -0,0 +1,146 @@
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "PKB/PKB.h"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("DEF_USE_KB") {
+  PKB db = PKB();
+
+  /* source code looks like:
+   * procedure a {
+   *   x = 1;              // stmt# 1
+   *   while (x > 0) {     // stmt# 2
+   *     y = x + y;        // stmt# 3
+   *     if (y > 1) then { // stmt# 4
+   *       x = y; }        // stmt# 5
+   *     else {
+   *       read y; } }     // stmt# 6
+   *   z = x + y;          // stmt# 7
+   *   call b;             // stmt# 8
+   *   z = x;              // stmt# 9
+   * }
+   * procedure b {
+   *   x = 2;              // stmt# 10
+   * }
+   */
+  for (int s = 1; s <= 10; s++) {
+    db.addStmt(DesignEntity::STATEMENT, s);
+  }
+  for (int s : {1, 3, 5, 7, 9, 10}) {
+    db.addStmt(DesignEntity::ASSIGN, s);
+  }
+  db.addStmt(DesignEntity::WHILE, 2);
+  db.addStmt(DesignEntity::IF, 4);
+  db.addStmt(DesignEntity::READ, 6);
+  db.addStmt(DesignEntity::CALL, 8);
+  db.addRs(RelationshipType::NEXT, 1, 2);
+  db.addRs(RelationshipType::NEXT, 2, 3);
+  db.addRs(RelationshipType::NEXT, 3, 4);
+  db.addRs(RelationshipType::NEXT, 4, 5);
+  db.addRs(RelationshipType::NEXT, 4, 6);
+  db.addRs(RelationshipType::NEXT, 5, 2);
+  db.addRs(RelationshipType::NEXT, 6, 2);
+  db.addRs(RelationshipType::NEXT, 2, 7);
+  db.addRs(RelationshipType::NEXT, 7, 8);
+  db.addRs(RelationshipType::NEXT, 8, 9);
+  db.addRs(RelationshipType::MODIFIES_S, 1, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 2, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 2, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::MODIFIES_S, 3, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::MODIFIES_S, 4, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 4, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::MODIFIES_S, 5, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 6, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::MODIFIES_S, 7, TableType::VAR_TABLE, "z");
+  db.addRs(RelationshipType::MODIFIES_S, 8, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 9, TableType::VAR_TABLE, "z");
+  db.addRs(RelationshipType::MODIFIES_S, 10, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::USES_S, 3, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::USES_S, 3, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::USES_S, 5, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::USES_S, 7, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::USES_S, 7, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::USES_S, 9, TableType::VAR_TABLE, "x");
+
+  REQUIRE(db.hasDefUseIndex());
+
+  SECTION("Definitions reach uses until modified again") {
+    REQUIRE(db.getAffects(1, true) == unordered_set<StmtNo>({3, 7}));
+    REQUIRE(db.getAffects(3, true) == unordered_set<StmtNo>({3, 5, 7}));
+    REQUIRE(db.getAffects(5, true) == unordered_set<StmtNo>({3, 7}));
+    REQUIRE(db.getAffects(7, true).empty());
+    REQUIRE(db.getAffects(10, true).empty());
+    REQUIRE(db.getNumAffects() == 7);
+  }
+
+  SECTION("Inverse rows hold the definitions reaching each use") {
+    REQUIRE(db.getAffects(3, false) == unordered_set<StmtNo>({1, 3, 5}));
+    REQUIRE(db.getAffects(5, false) == unordered_set<StmtNo>({3}));
+    REQUIRE(db.getAffects(7, false) == unordered_set<StmtNo>({1, 3, 5}));
+    REQUIRE(db.getAffects(1, false).empty());
+  }
+
+  SECTION("Reads, calls and assignments kill, containers do not") {
+    REQUIRE(db.isAffects(1, 3));
+    REQUIRE_FALSE(db.isAffects(1, 9));
+    REQUIRE_FALSE(db.isAffects(5, 9));
+    REQUIRE_FALSE(db.isAffects(1, 5));
+    REQUIRE_FALSE(db.isAffects(7, 9));
+  }
+
+  SECTION("Statements not in the pkb affect nothing") {
+    REQUIRE_FALSE(db.isAffects(0, 3));
+    REQUIRE_FALSE(db.isAffects(-1, 3));
+    REQUIRE(db.getAffects(11, true).empty());
+    REQUIRE(db.getAffects(-1, false).empty());
+  }
+
+  SECTION("Index is rebuilt after Modifies is added") {
+    REQUIRE(db.isAffects(3, 7));
+    db.addRs(RelationshipType::MODIFIES_S, 2, TableType::VAR_TABLE, "w");
+    db.addStmt(DesignEntity::ASSIGN, 11);
+    db.addRs(RelationshipType::NEXT, 9, 11);
+    db.addRs(RelationshipType::MODIFIES_S, 11, TableType::VAR_TABLE, "z");
+    db.addRs(RelationshipType::USES_S, 11, TableType::VAR_TABLE, "z");
+    REQUIRE(db.isAffects(9, 11));
+    REQUIRE_FALSE(db.isAffects(7, 11));
+  }
+
+  SECTION("Searches pruned by the dominator trees find the same uses") {
+    vector<pair<StmtNo, StmtNo>> dominators = {
+        {1, -1}, {2, 1}, {3, 2}, {4, 3}, {5, 4},
+        {6, 4},  {7, 2}, {8, 7}, {9, 8}, {10, -1}};
+    vector<pair<StmtNo, StmtNo>> postDominators = {
+        {1, 2}, {2, 7}, {3, 4}, {4, 2}, {5, 2},
+        {6, 2}, {7, 8}, {8, 9}, {9, -1}, {10, -1}};
+    for (const auto& [stmt, dominator] : dominators) {
+      db.addImmediateDominator(stmt, dominator);
+    }
+    for (const auto& [stmt, postDominator] : postDominators) {
+      db.addImmediatePostDominator(stmt, postDominator);
+    }
+    REQUIRE(db.hasDominators());
+    // the call at 8 dominates 9, which 1 is cut off from
+    REQUIRE(db.getAffects(1, true) == unordered_set<StmtNo>({3, 7}));
+    REQUIRE(db.getAffects(3, true) == unordered_set<StmtNo>({3, 5, 7}));
+    REQUIRE(db.getAffects(5, true) == unordered_set<StmtNo>({3, 7}));
+    REQUIRE(db.getAffects(7, false) == unordered_set<StmtNo>({1, 3, 5}));
+    REQUIRE(db.getNumAffects() == 7);
+  }
+
+  SECTION("Built when frozen in eager mode") {
+    db.setDefUseIndexMode(DefUseIndexMode::EAGER);
+    db.freeze();
+    REQUIRE(db.hasDefUseIndex());
+    REQUIRE(db.isAffects(5, 7));
+  }
+
+  SECTION("Without an index") {
+    db.setDefUseIndexMode(DefUseIndexMode::NONE);
+    REQUIRE_FALSE(db.hasDefUseIndex());
+  }
+}
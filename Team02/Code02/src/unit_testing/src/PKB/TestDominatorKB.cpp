@@ -0,0 +1,63 @@
+#include "PKB/PKB.h"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("DOMINATOR_KB") {
+  PKB db = PKB();
+
+  /* dominator tree of a procedure of statements 1 to 6, and another of 7:
+   *       1
+   *       |
+   *       2     7
+   *      / \
+   *     3   6
+   *    / \
+   *   4   5
+   */
+  db.addImmediateDominator(1, -1);
+  db.addImmediateDominator(2, 1);
+  db.addImmediateDominator(3, 2);
+  db.addImmediateDominator(4, 3);
+  db.addImmediateDominator(5, 3);
+  db.addImmediateDominator(6, 2);
+  db.addImmediateDominator(7, -1);
+  for (int s = 1; s <= 7; s++) {
+    db.addImmediatePostDominator(s, -1);
+  }
+
+  REQUIRE(db.hasDominators());
+
+  SECTION("Statements dominate their subtrees") {
+    REQUIRE(db.isDominator(1, 5));
+    REQUIRE(db.isDominator(2, 6));
+    REQUIRE(db.isDominator(3, 4));
+    REQUIRE(db.isDominator(4, 4));
+    REQUIRE_FALSE(db.isDominator(3, 6));
+    REQUIRE_FALSE(db.isDominator(4, 5));
+    REQUIRE_FALSE(db.isDominator(5, 1));
+  }
+
+  SECTION("Trees of different procedures are apart") {
+    REQUIRE_FALSE(db.isDominator(1, 7));
+    REQUIRE_FALSE(db.isDominator(7, 1));
+    REQUIRE(db.isDominator(7, 7));
+  }
+
+  SECTION("Statements not in any tree dominate nothing") {
+    REQUIRE_FALSE(db.isDominator(0, 1));
+    REQUIRE_FALSE(db.isDominator(1, 8));
+    REQUIRE_FALSE(db.isDominator(-1, 2));
+  }
+
+  SECTION("Trees are renumbered after statements are added") {
+    db.addImmediateDominator(8, 6);
+    REQUIRE(db.isDominator(2, 8));
+    REQUIRE_FALSE(db.isDominator(3, 8));
+  }
+
+  SECTION("Post-dominators are kept apart") {
+    REQUIRE_FALSE(db.isPostDominator(1, 5));
+    REQUIRE(db.isPostDominator(5, 5));
+  }
+}
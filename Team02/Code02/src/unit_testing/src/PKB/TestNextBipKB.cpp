@@ -0,0 +1,79 @@
+#include "PKB/PKB.h"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("NEXT_BIP_KB") {
+  PKB db = PKB();
+
+  /* procedure A { 1. x = 1; 2. call B; 3. y = x; }
+   * procedure B { 4. z = 2; 5. call C; }
+   * procedure C { 6. w = 3; }
+   */
+  db.addFirstStmtOfProc("A", 1);
+  db.addFirstStmtOfProc("B", 4);
+  db.addFirstStmtOfProc("C", 6);
+  db.addRs(RelationshipType::NEXT, 1, 2);
+  db.addRs(RelationshipType::NEXT, 2, 3);
+  db.addRs(RelationshipType::NEXT, 4, 5);
+  db.addRs(RelationshipType::CALLS_S, 2, TableType::PROC_TABLE, "B");
+  db.addRs(RelationshipType::CALLS_S, 5, TableType::PROC_TABLE, "C");
+  for (int s = 1; s <= 6; s++) {
+    db.addStmt(DesignEntity::STATEMENT, s);
+  }
+  db.addExitStmtOfProc("A", 3);
+  db.addExitStmtOfProc("B", 5);
+  db.addExitStmtOfProc("C", 6);
+
+  SECTION("Calls lead to the first statement of their callee") {
+    REQUIRE(db.getRight(RelationshipType::NEXT_BIP, 2) ==
+            unordered_set<int>({4}));
+    REQUIRE(db.getRight(RelationshipType::NEXT_BIP, 5) ==
+            unordered_set<int>({6}));
+    REQUIRE(db.getLeft(RelationshipType::NEXT_BIP, 4) ==
+            unordered_set<int>({2}));
+    REQUIRE_FALSE(db.isRs(RelationshipType::NEXT_BIP, 2, 3));
+  }
+
+  SECTION("Exits return through calls at the end of their caller") {
+    REQUIRE(db.getRight(RelationshipType::NEXT_BIP, 6) ==
+            unordered_set<int>({3}));
+    REQUIRE(db.getLeft(RelationshipType::NEXT_BIP, 3) ==
+            unordered_set<int>({6}));
+    REQUIRE(db.isRs(RelationshipType::NEXT_BIP, 6, 3));
+    REQUIRE_FALSE(db.hasRight(RelationshipType::NEXT_BIP, 3));
+  }
+
+  SECTION("Next within a procedure is kept") {
+    REQUIRE(db.isRs(RelationshipType::NEXT_BIP, 1, 2));
+    REQUIRE(db.isRs(RelationshipType::NEXT_BIP, 4, 5));
+    REQUIRE(db.getLeft(RelationshipType::NEXT_BIP, 1).empty());
+  }
+
+  SECTION("Pairs are materialised on demand") {
+    REQUIRE(db.getMappings(RelationshipType::NEXT_BIP, ParamPosition::BOTH) ==
+            SetOfStmtLists({{1, 2}, {2, 4}, {4, 5}, {5, 6}, {6, 3}}));
+    REQUIRE(db.getMappings(RelationshipType::NEXT_BIP, ParamPosition::LEFT) ==
+            SetOfStmtLists({{1}, {2}, {4}, {5}, {6}}));
+  }
+
+  SECTION("Rows are derived again after later insertions") {
+    db.addRs(RelationshipType::NEXT, 3, 7);
+    db.addStmt(DesignEntity::STATEMENT, 7);
+    REQUIRE(db.getRight(RelationshipType::NEXT_BIP, 3) ==
+            unordered_set<int>({7}));
+    REQUIRE(db.getMappings(RelationshipType::NEXT_BIP, ParamPosition::BOTH)
+                .count({3, 7}) == 1);
+  }
+}
+
+TEST_CASE("NEXT_BIP_KB Without Exits") {
+  PKB db = PKB();
+  db.addRs(RelationshipType::NEXT, 1, 2);
+  db.addRs(RelationshipType::NEXT_BIP, 1, 3);
+
+  REQUIRE(db.getRight(RelationshipType::NEXT_BIP, 1) ==
+          unordered_set<int>({3}));
+  REQUIRE(db.getMappings(RelationshipType::NEXT_BIP, ParamPosition::BOTH) ==
+          SetOfStmtLists({{1, 3}}));
+}
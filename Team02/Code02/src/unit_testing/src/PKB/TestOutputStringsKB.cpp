@@ -0,0 +1,61 @@
+#include <string_view>
+
+#include "PKB/PKB.h"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("OUTPUT_STRINGS_KB") {
+  PKB db = PKB();
+
+  /* source code looks like:
+   * procedure a {
+   *   read x;           // stmt# 1
+   *   call b;           // stmt# 2
+   *   print x;          // stmt# 3
+   * }
+   * procedure b {
+   *   x = 5;            // stmt# 4
+   * }
+   */
+  db.addStmt(DesignEntity::READ, 1);
+  db.addStmt(DesignEntity::CALL, 2);
+  db.addStmt(DesignEntity::PRINT, 3);
+  db.addStmt(DesignEntity::ASSIGN, 4);
+  db.insertAt(TableType::PROC_TABLE, "a");
+  db.addRs(RelationshipType::MODIFIES_S, 1, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::CALLS_S, 2, TableType::PROC_TABLE, "b");
+  db.addRs(RelationshipType::USES_S, 3, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 4, TableType::VAR_TABLE, "x");
+  db.insertAt(TableType::CONST_TABLE, "5");
+
+  REQUIRE_FALSE(db.hasOutputStrings());
+  db.freeze();
+  REQUIRE(db.hasOutputStrings());
+  REQUIRE(db.hasStatistics());
+
+  SECTION("Names and numbers") {
+    REQUIRE(db.getOutputString(TableType::VAR_TABLE, 0) == "x");
+    REQUIRE(db.getOutputString(TableType::PROC_TABLE, 1) == "b");
+    REQUIRE(db.getOutputString(TableType::CONST_TABLE, 0) == "5");
+    REQUIRE(db.getStmtOutputString(4) == "4");
+    // values not in the pkb have no string
+    REQUIRE(db.getStmtOutputString(5).empty());
+    REQUIRE(db.getOutputString(TableType::VAR_TABLE, 1).empty());
+  }
+
+  SECTION("Name attributes of calls, reads and prints") {
+    REQUIRE(db.getNameAttributeOutputString(1) == "x");
+    REQUIRE(db.getNameAttributeOutputString(2) == "b");
+    REQUIRE(db.getNameAttributeOutputString(3) == "x");
+    REQUIRE(db.getNameAttributeOutputString(4).empty());
+  }
+
+  SECTION("Equal strings are interned once") {
+    db.addStmt(DesignEntity::ASSIGN, 5);
+    REQUIRE(db.getStmtOutputString(5).data() ==
+            db.getOutputString(TableType::CONST_TABLE, 0).data());
+    REQUIRE(db.getNameAttributeOutputString(1).data() ==
+            db.getOutputString(TableType::VAR_TABLE, 0).data());
+  }
+}
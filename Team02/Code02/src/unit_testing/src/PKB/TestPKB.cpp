@@ -131,3 +131,38 @@ TEST_CASE("PKB_TABLES_TEST") {
   REQUIRE(db.getElementAt(TableType::VAR_TABLE, 0) == "a");
   REQUIRE(db.getAllElementsAt(TableType::VAR_TABLE) == answer);
 }
+
+TEST_CASE("PKB_NAME_ATTRIBUTES_TEST") {
+  PKB db = PKB();
+  db.addStmt(DesignEntity::READ, 1);
+  db.addStmt(DesignEntity::CALL, 2);
+  db.addStmt(DesignEntity::PRINT, 3);
+  db.addStmt(DesignEntity::ASSIGN, 4);
+  int xIdx = db.insertAt(TableType::VAR_TABLE, "x");
+  int yIdx = db.insertAt(TableType::VAR_TABLE, "y");
+  int procIdx = db.insertAt(TableType::PROC_TABLE, "main");
+  db.addRs(RelationshipType::MODIFIES_S, 1, xIdx);
+  db.addRs(RelationshipType::CALLS_S, 2, procIdx);
+  db.addRs(RelationshipType::USES_S, 3, yIdx);
+  db.addRs(RelationshipType::MODIFIES_S, 4, yIdx);
+
+  SECTION("Before the pkb is frozen") {
+    REQUIRE(db.getNameAttribute(DesignEntity::READ, 1) == xIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::CALL, 2) == procIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::PRINT, 3) == yIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::ASSIGN, 4) == -1);
+  }
+
+  SECTION("After the pkb is frozen") {
+    db.freeze();
+    REQUIRE(db.getNameAttribute(DesignEntity::READ, 1) == xIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::CALL, 2) == procIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::PRINT, 3) == yIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::ASSIGN, 4) == -1);
+
+    // statements added later are looked up in the relationship tables
+    db.addStmt(DesignEntity::READ, 5);
+    db.addRs(RelationshipType::MODIFIES_S, 5, yIdx);
+    REQUIRE(db.getNameAttribute(DesignEntity::READ, 5) == yIdx);
+  }
+}
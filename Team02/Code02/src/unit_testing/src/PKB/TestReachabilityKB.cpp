@@ -0,0 +1,180 @@
+#include <queue>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "PKB/PKB.h"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("REACHABILITY_KB") {
+  PKB db = PKB();
+
+  /* source code looks like:
+   * procedure a {
+   *   x = 1;              // stmt# 1
+   *   while (x > 0) {     // stmt# 2
+   *     if (x > 1) then { // stmt# 3
+   *       x = 2; }        // stmt# 4
+   *     else {
+   *       x = 3; } }      // stmt# 5
+   *   call b;             // stmt# 6
+   * }
+   * procedure b {
+   *   y = 1;              // stmt# 7
+   *   print y;            // stmt# 8
+   * }
+   */
+  for (int s = 1; s <= 8; s++) {
+    db.addStmt(DesignEntity::STATEMENT, s);
+  }
+  db.addRs(RelationshipType::NEXT, 1, 2);
+  db.addRs(RelationshipType::NEXT, 2, 3);
+  db.addRs(RelationshipType::NEXT, 3, 4);
+  db.addRs(RelationshipType::NEXT, 3, 5);
+  db.addRs(RelationshipType::NEXT, 4, 2);
+  db.addRs(RelationshipType::NEXT, 5, 2);
+  db.addRs(RelationshipType::NEXT, 2, 6);
+  db.addRs(RelationshipType::NEXT, 7, 8);
+
+  REQUIRE_FALSE(db.hasReachabilityIndex());
+  db.computeReachabilityIndex();
+  REQUIRE(db.hasReachabilityIndex());
+
+  for (ReachabilityIndexType type : {ReachabilityIndexType::TWO_HOP_LABELS,
+                                     ReachabilityIndexType::FULL_CLOSURE}) {
+    db.setReachabilityIndexType(type);
+
+    SECTION("Statements reach along Next") {
+      REQUIRE(db.isNextT(1, 6));
+      REQUIRE(db.isNextT(4, 5));
+      REQUIRE(db.isNextT(5, 6));
+      REQUIRE(db.isNextT(7, 8));
+      REQUIRE_FALSE(db.isNextT(6, 1));
+      REQUIRE_FALSE(db.isNextT(2, 1));
+      REQUIRE_FALSE(db.isNextT(8, 7));
+      REQUIRE_FALSE(db.isNextT(6, 7));
+    }
+
+    SECTION("Only statements in loops reach themselves") {
+      REQUIRE(db.isNextT(2, 2));
+      REQUIRE(db.isNextT(4, 4));
+      REQUIRE_FALSE(db.isNextT(1, 1));
+      REQUIRE_FALSE(db.isNextT(6, 6));
+    }
+
+    SECTION("Statements not in the pkb reach nothing") {
+      REQUIRE_FALSE(db.isNextT(0, 1));
+      REQUIRE_FALSE(db.isNextT(8, 9));
+      REQUIRE_FALSE(db.isNextT(-1, 2));
+    }
+
+    SECTION("Index is rebuilt after Next is added") {
+      db.addRs(RelationshipType::NEXT, 6, 7);
+      REQUIRE(db.isNextT(1, 8));
+      REQUIRE_FALSE(db.isNextT(7, 6));
+    }
+  }
+
+  SECTION("Without an index") {
+    db.setReachabilityIndexType(ReachabilityIndexType::NONE);
+    REQUIRE_FALSE(db.hasReachabilityIndex());
+  }
+}
+
+TEST_CASE("REACHABILITY_KB: Built When Frozen Without Stmt Ranges") {
+  PKB db = PKB();
+  for (int s = 1; s <= 3; s++) {
+    db.addStmt(DesignEntity::STATEMENT, s);
+  }
+  db.addRs(RelationshipType::NEXT, 1, 2);
+  db.addRs(RelationshipType::NEXT, 2, 3);
+
+  SECTION("Without stmt ranges") {
+    db.freeze();
+    REQUIRE(db.hasReachabilityIndex());
+    REQUIRE(db.isNextT(1, 3));
+  }
+
+  SECTION("With stmt ranges, which answer Next* instead") {
+    db.insertAt(TableType::PROC_TABLE, "a");
+    db.addProcRange("a", 1, 3);
+    db.freeze();
+    REQUIRE(db.hasStmtRanges());
+    REQUIRE_FALSE(db.hasReachabilityIndex());
+    REQUIRE(db.isStructuralNextT(1, 3));
+    REQUIRE(db.getNextTOracle() == NextTOracle::STMT_RANGES);
+  }
+
+  SECTION("With stmt ranges and the index configured") {
+    db.insertAt(TableType::PROC_TABLE, "a");
+    db.addProcRange("a", 1, 3);
+    db.setNextTOracle(NextTOracle::REACHABILITY_INDEX);
+    REQUIRE(db.getNextTOracle() == NextTOracle::STMT_RANGES);
+    db.freeze();
+    REQUIRE(db.hasReachabilityIndex());
+    REQUIRE(db.getNextTOracle() == NextTOracle::REACHABILITY_INDEX);
+    REQUIRE(db.isNextT(1, 3));
+  }
+
+  SECTION("With search configured") {
+    db.setNextTOracle(NextTOracle::SEARCH);
+    db.freeze();
+    REQUIRE_FALSE(db.hasReachabilityIndex());
+    REQUIRE(db.getNextTOracle() == NextTOracle::SEARCH);
+  }
+}
+
+TEST_CASE("REACHABILITY_KB: Indexes Agree With Search") {
+  // procedures of chains with loops back and branches forward
+  const int numStmts = 300;
+  PKB db = PKB();
+  mt19937 generator(3230);
+  vector<vector<int>> successors(numStmts + 1);
+  for (int s = 1; s <= numStmts; s++) {
+    db.addStmt(DesignEntity::STATEMENT, s);
+    if (s % 50 == 0) {
+      continue;
+    }
+    vector<int> nextStmts = {s + 1};
+    int offset = generator() % 12;
+    if (offset < 4 && s - offset - 1 >= s - s % 50 + 1) {
+      nextStmts.push_back(s - offset - 1);
+    } else if (offset > 8 && s + offset <= s - s % 50 + 50) {
+      nextStmts.push_back(s + offset);
+    }
+    for (int nextStmt : nextStmts) {
+      db.addRs(RelationshipType::NEXT, s, nextStmt);
+      successors[s].push_back(nextStmt);
+    }
+  }
+
+  vector<unordered_set<int>> expected(numStmts + 1);
+  for (int s = 1; s <= numStmts; s++) {
+    queue<int> stmtQueue;
+    stmtQueue.push(s);
+    while (!stmtQueue.empty()) {
+      int stmt = stmtQueue.front();
+      stmtQueue.pop();
+      for (int nextStmt : successors[stmt]) {
+        if (expected[s].insert(nextStmt).second) {
+          stmtQueue.push(nextStmt);
+        }
+      }
+    }
+  }
+
+  for (ReachabilityIndexType type : {ReachabilityIndexType::TWO_HOP_LABELS,
+                                     ReachabilityIndexType::FULL_CLOSURE}) {
+    db.setReachabilityIndexType(type);
+    db.computeReachabilityIndex();
+    for (int s1 = 1; s1 <= numStmts; s1++) {
+      for (int s2 = 1; s2 <= numStmts; s2++) {
+        if (db.isNextT(s1, s2) != (expected[s1].count(s2) > 0)) {
+          FAIL("Next*(" << s1 << ", " << s2 << ") differs from search");
+        }
+      }
+    }
+  }
+}
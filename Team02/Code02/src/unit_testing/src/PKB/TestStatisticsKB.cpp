@@ -0,0 +1,87 @@
+#include <vector>
+
+#include "PKB/PKB.h"
+#include "catch.hpp"
+
+using namespace std;
+
+TEST_CASE("STATISTICS_KB") {
+  PKB db = PKB();
+
+  /* source code looks like:
+   * procedure a {
+   *   x = 1;            // stmt# 1
+   *   while (x > 0) {   // stmt# 2
+   *     y = x;          // stmt# 3
+   *     x = y; }        // stmt# 4
+   *   print y;          // stmt# 5
+   * }
+   */
+  db.addStmt(DesignEntity::ASSIGN, 1);
+  db.addStmt(DesignEntity::WHILE, 2);
+  db.addStmt(DesignEntity::ASSIGN, 3);
+  db.addStmt(DesignEntity::ASSIGN, 4);
+  db.addStmt(DesignEntity::PRINT, 5);
+  db.addRs(RelationshipType::FOLLOWS, 1, 2);
+  db.addRs(RelationshipType::FOLLOWS, 2, 5);
+  db.addRs(RelationshipType::FOLLOWS, 3, 4);
+  db.addRs(RelationshipType::PARENT, 2, 3);
+  db.addRs(RelationshipType::PARENT, 2, 4);
+  db.addRs(RelationshipType::MODIFIES_S, 1, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::MODIFIES_S, 3, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::MODIFIES_S, 4, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::USES_S, 3, TableType::VAR_TABLE, "x");
+  db.addRs(RelationshipType::USES_S, 4, TableType::VAR_TABLE, "y");
+  db.addRs(RelationshipType::USES_S, 5, TableType::VAR_TABLE, "y");
+
+  REQUIRE_FALSE(db.hasStatistics());
+  db.computeStatistics();
+  REQUIRE(db.hasStatistics());
+
+  SECTION("Pair and distinct counts") {
+    const RsStatistics& parent = db.getRsStatistics(RelationshipType::PARENT);
+    REQUIRE(parent.numPairs == 2);
+    REQUIRE(parent.numDistinctLeft == 1);
+    REQUIRE(parent.numDistinctRight == 2);
+    REQUIRE(parent.numPairsByLeftEntity.at(DesignEntity::WHILE) == 2);
+    REQUIRE(parent.numPairsByRightEntity.at(DesignEntity::ASSIGN) == 2);
+    REQUIRE(parent.numDistinctRightByEntity.at(DesignEntity::STATEMENT) == 2);
+    REQUIRE(parent.numPairsByLeftEntity.count(DesignEntity::ASSIGN) == 0);
+
+    const RsStatistics& follows = db.getRsStatistics(RelationshipType::FOLLOWS);
+    REQUIRE(follows.numPairs == 3);
+    REQUIRE(follows.numPairsByLeftEntity.at(DesignEntity::ASSIGN) == 2);
+    REQUIRE(follows.numPairsByRightEntity.at(DesignEntity::PRINT) == 1);
+
+    // no statistics for relationships without pairs
+    REQUIRE(db.getRsStatistics(RelationshipType::CALLS).numPairs == 0);
+  }
+
+  SECTION("Variables are not counted by statement entity") {
+    const RsStatistics& uses = db.getRsStatistics(RelationshipType::USES_S);
+    REQUIRE(uses.numPairs == 3);
+    REQUIRE(uses.numDistinctRight == 2);
+    REQUIRE(uses.numPairsByLeftEntity.at(DesignEntity::ASSIGN) == 2);
+    REQUIRE(uses.numPairsByRightEntity.empty());
+  }
+
+  SECTION("Fan-out histograms") {
+    const RsStatistics& parent = db.getRsStatistics(RelationshipType::PARENT);
+    // stmt 2 has 2 children, stmts 3 and 4 have 1 parent each
+    REQUIRE(parent.leftFanOutHistogram == vector<int>({0, 1}));
+    REQUIRE(parent.rightFanOutHistogram == vector<int>({2}));
+    REQUIRE(StatisticsKB::getTypicalFanOut(parent.leftFanOutHistogram) == 2.5);
+    REQUIRE(StatisticsKB::getTypicalFanOut(parent.rightFanOutHistogram) == 1);
+    REQUIRE(StatisticsKB::getTypicalFanOut({}) == 0);
+  }
+
+  SECTION("Assignment def-use pairs") {
+    // x: defined by 1 and 4, used by 3; y: defined by 3, used by 4
+    REQUIRE(db.getNumAssignDefUsePairs() == 3);
+  }
+
+  SECTION("Statistics are recomputed after later insertions") {
+    db.addRs(RelationshipType::PARENT, 2, 5);
+    REQUIRE(db.getRsStatistics(RelationshipType::PARENT).numPairs == 3);
+  }
+}
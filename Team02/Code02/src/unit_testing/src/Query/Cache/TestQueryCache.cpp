@@ -0,0 +1,82 @@
+#include <PKB/PKB.h>
+#include <Query/Cache/QueryCache.h>
+#include <Query/Parser/QueryLexerParserCommon.h>
+
+#include <string>
+
+#include "catch.hpp"
+
+using namespace std;
+using namespace query;
+
+TEST_CASE("Queries differing in whitespace and synonym names share a key") {
+  string query =
+      "stmt s1; assign a; Select s1 such that Follows*(s1, a) pattern a(_, "
+      "_\"x\"_)";
+  string renamedQuery =
+      "stmt  first ;assign second;\nSelect first such that "
+      "Follows* ( first,second ) pattern second ( _ , _ \"x\" _ )";
+
+  REQUIRE(QueryCache::Canonicalise(query) ==
+          QueryCache::Canonicalise(renamedQuery));
+  REQUIRE(QueryCache::Canonicalise(query) ==
+          "stmt s0 ; assign s1 ; Select s0 such that Follows* ( s0 , s1 ) "
+          "pattern s1 ( _ , _ \" x \" _ )");
+}
+
+TEST_CASE("Canonicalisation keeps keywords and quoted names") {
+  SECTION("Names within quotes are not renamed") {
+    REQUIRE(QueryCache::Canonicalise(
+                "variable v; Select v such that Modifies(\"main\", v)") !=
+            QueryCache::Canonicalise(
+                "variable v; Select v such that Modifies(\"other\", v)"));
+  }
+
+  SECTION("Synonyms named after keywords are not renamed") {
+    REQUIRE(QueryCache::Canonicalise("stmt Select; Select Select") ==
+            "stmt Select ; Select Select");
+    REQUIRE(QueryCache::Canonicalise("stmt BOOLEAN; Select BOOLEAN") !=
+            QueryCache::Canonicalise("stmt s; Select s"));
+  }
+
+  SECTION("Distinct synonyms are not merged") {
+    REQUIRE(QueryCache::Canonicalise(
+                "stmt s1, s2; Select s1 such that Follows(s1, s2)") !=
+            QueryCache::Canonicalise(
+                "stmt s1, s2; Select s1 such that Follows(s1, s1)"));
+  }
+}
+
+TEST_CASE("Query cache returns parsed queries and evicts the oldest entry") {
+  PKB* pkb = new PKB();
+  QueryCache queryCache(pkb, 2);
+
+  string queryA = "stmt s; Select s such that Follows(s, 2)";
+  string queryB = "assign a; Select a such that Parent(1, a)";
+  string queryC = "variable v; Select v";
+
+  const cache::CachedQuery& cachedA = queryCache.GetOrParse(queryA);
+  REQUIRE(cachedA.synonymMap ==
+          SynonymMap({{"s0", DesignEntity::STATEMENT}}));
+  REQUIRE(cachedA.selectClause.conditionClauses.size() == 1);
+
+  // same shape with different names hits the existing entry
+  queryCache.GetOrParse("stmt x; Select x such that Follows(x,2)");
+  REQUIRE(queryCache.GetSize() == 1);
+
+  queryCache.GetOrParse(queryB);
+  queryCache.GetOrParse(queryA);
+  queryCache.GetOrParse(queryC);
+  REQUIRE(queryCache.GetSize() == 2);
+
+  // queryB was the least recently used and has been replaced
+  const cache::CachedQuery& cachedB = queryCache.GetOrParse(queryB);
+  REQUIRE(cachedB.synonymMap == SynonymMap({{"s0", DesignEntity::ASSIGN}}));
+  REQUIRE(queryCache.GetSize() == 2);
+
+  SECTION("Invalid queries are not cached") {
+    REQUIRE_THROWS_AS(queryCache.GetOrParse("stmt s; Select s such"),
+                      qpp::SyntacticErrorException);
+    REQUIRE(queryCache.GetSize() == 2);
+  }
+}
@@ -3,6 +3,7 @@
 #include <Query/Evaluator/AffectsOnDemandEvaluator.h>
 
 #include <iostream>
+#include <tuple>
 
 #include "catch.hpp"
 
@@ -1930,7 +1931,7 @@ TEST_CASE("AffectsBip - Truthy Values") {
   pkb->insertAt(TableType::PROC_TABLE, "B");
   pkb->addFirstStmtOfProc("B", 8);
   pkb->insertAt(TableType::PROC_TABLE, "C");
-  pkb->addFirstStmtOfProc("B", 9);
+  pkb->addFirstStmtOfProc("C", 9);
   for (int i = 1; i <= 9; i++) {
     pkb->addStmt(DesignEntity::STATEMENT, i);
   }
@@ -1948,15 +1949,15 @@ TEST_CASE("AffectsBip - Truthy Values") {
   // 8:  call C; }
   // procedure C {
   // 9:  x = x + 1; }
-  RelationshipType cfgRsType = RelationshipType::NEXT_BIP;
+  // calls are stepped over within each procedure
+  RelationshipType cfgRsType = RelationshipType::NEXT;
   pkb->addRs(cfgRsType, 1, 2);
   pkb->addRs(cfgRsType, 2, 3);
   pkb->addRs(cfgRsType, 3, 4);
   pkb->addRs(cfgRsType, 4, 5);
   pkb->addRs(cfgRsType, 4, 6);
-  pkb->addRs(cfgRsType, 6, 8);
-  pkb->addRs(cfgRsType, 8, 9);
-  pkb->addRs(cfgRsType, 9, 2);
+  pkb->addRs(cfgRsType, 5, 2);
+  pkb->addRs(cfgRsType, 6, 2);
   pkb->addRs(cfgRsType, 2, 7);
 
   pkb->addStmt(DesignEntity::WHILE, 2);
@@ -1986,6 +1987,16 @@ TEST_CASE("AffectsBip - Truthy Values") {
   pkb->addRs(RelationshipType::USES_S, 7, TableType::VAR_TABLE, "x");
   pkb->addRs(RelationshipType::MODIFIES_S, 9, TableType::VAR_TABLE, "x");
   pkb->addRs(RelationshipType::USES_S, 9, TableType::VAR_TABLE, "x");
+  for (string procName : {"A", "B", "C"}) {
+    pkb->addRs(RelationshipType::MODIFIES_P, TableType::PROC_TABLE, procName,
+               TableType::VAR_TABLE, "x");
+    pkb->addRs(RelationshipType::USES_P, TableType::PROC_TABLE, procName,
+               TableType::VAR_TABLE, "x");
+  }
+  pkb->addRs(RelationshipType::USES_P, TableType::PROC_TABLE, "A",
+             TableType::VAR_TABLE, "y");
+  pkb->addRs(RelationshipType::MODIFIES_P, TableType::PROC_TABLE, "A",
+             TableType::VAR_TABLE, "y");
 
   unordered_map<string, DesignEntity> synonyms = {
       {"s1", DesignEntity::STATEMENT},
@@ -2087,3 +2098,342 @@ TEST_CASE("AffectsBip - Truthy Values") {
     REQUIRE_THAT(results, VectorContains(vector<int>({9, 7})));
   }
 }
+
+TEST_CASE("AffectsOnDemandEvaluator: Affects Over Many Procedures") {
+  // procedure p has statements 5p + 1 to 5p + 5, all of them x = x + 1
+  const int numProcs = 20;
+  PKB* pkb = new PKB();
+  ClauseIncomingResults expected;
+  for (int p = 0; p < numProcs; p++) {
+    string procName = "proc" + to_string(p);
+    pkb->insertAt(TableType::PROC_TABLE, procName);
+    pkb->addFirstStmtOfProc(procName, 5 * p + 1);
+    for (int s = 5 * p + 1; s <= 5 * p + 5; s++) {
+      pkb->addStmt(DesignEntity::ASSIGN, s);
+      pkb->addRs(RelationshipType::MODIFIES_S, s, TableType::VAR_TABLE, "x");
+      pkb->addRs(RelationshipType::USES_S, s, TableType::VAR_TABLE, "x");
+      if (s < 5 * p + 5) {
+        pkb->addRs(RelationshipType::NEXT, s, s + 1);
+        expected.insert({s, s + 1});
+      }
+    }
+  }
+
+  // procedures are walked in parallel only without the def-use index
+  pkb->setDefUseIndexMode(DefUseIndexMode::NONE);
+  ThreadPool threadPool(3);
+  for (int numWorkers : {1, 2, 4, 8}) {
+    WorkStealingScheduler scheduler(&threadPool, numWorkers);
+    AffectsOnDemandEvaluator ae(pkb, &scheduler);
+    Param a1 = {ParamType::SYNONYM, "a1"};
+    Param a2 = {ParamType::SYNONYM, "a2"};
+    REQUIRE(ae.evaluatePairAffects(RelationshipType::AFFECTS, a1, a2) ==
+            expected);
+    REQUIRE(ae.getAffectsInv(RelationshipType::AFFECTS, 10) ==
+            unordered_set<StmtNo>({9}));
+  }
+}
+
+TEST_CASE("AffectsOnDemandEvaluator: Affects Of Many Statements At Once") {
+  // procedure p has statements 5p + 1 to 5p + 5, all of them x = x + 1
+  const int numProcs = 6;
+  PKB* pkb = new PKB();
+  for (int p = 0; p < numProcs; p++) {
+    string procName = "proc" + to_string(p);
+    pkb->insertAt(TableType::PROC_TABLE, procName);
+    pkb->addFirstStmtOfProc(procName, 5 * p + 1);
+    for (int s = 5 * p + 1; s <= 5 * p + 5; s++) {
+      pkb->addProcOfStmt(procName, s);
+      pkb->addStmt(DesignEntity::ASSIGN, s);
+      pkb->addRs(RelationshipType::MODIFIES_S, s, TableType::VAR_TABLE, "x");
+      pkb->addRs(RelationshipType::USES_S, s, TableType::VAR_TABLE, "x");
+      if (s < 5 * p + 5) {
+        pkb->addRs(RelationshipType::NEXT, s, s + 1);
+      }
+    }
+  }
+
+  RelationshipType rsType = RelationshipType::AFFECTS;
+  pkb->setDefUseIndexMode(DefUseIndexMode::NONE);
+  AffectsOnDemandEvaluator batched(pkb);
+  batched.cacheAffectsOfStmts({1, 3, 5, 12, 13, 30});
+  for (StmtNo s = 1; s <= 5 * numProcs; s++) {
+    AffectsOnDemandEvaluator single(pkb);
+    Param stmt = {ParamType::INTEGER_LITERAL, to_string(s)};
+    Param a = {ParamType::SYNONYM, "a"};
+    REQUIRE(batched.evaluateStmtAffects(rsType, stmt, a) ==
+            single.evaluateStmtAffects(rsType, stmt, a));
+    REQUIRE(batched.evaluateStmtAffects(rsType, a, stmt) ==
+            single.evaluateStmtAffects(rsType, a, stmt));
+  }
+  Param left = {ParamType::INTEGER_LITERAL, "12"};
+  Param right = {ParamType::INTEGER_LITERAL, "13"};
+  REQUIRE(batched.evaluateBoolAffects(rsType, left, right) == true);
+  right = {ParamType::INTEGER_LITERAL, "14"};
+  REQUIRE(batched.evaluateBoolAffects(rsType, left, right) == false);
+}
+
+TEST_CASE("AffectsOnDemandEvaluator: Affects Of A Stmt Over Its Variables") {
+  // procedure A {
+  // 1: x = 1;
+  // 2: y = x;
+  // 3: while (i > 0) {
+  // 4:   x = x + y;
+  // 5:   read y;
+  // 6:   if (x > 2) then {
+  // 7:     call B; }
+  //      else {
+  // 8:     y = x + y; } }
+  // 9: z = x + y; }
+  // procedure B {
+  // 10: y = 3; }
+  PKB* pkb = new PKB();
+  pkb->insertAt(TableType::PROC_TABLE, "A");
+  pkb->addFirstStmtOfProc("A", 1);
+  pkb->insertAt(TableType::PROC_TABLE, "B");
+  pkb->addFirstStmtOfProc("B", 10);
+  for (int i = 1; i <= 10; i++) {
+    pkb->addStmt(DesignEntity::STATEMENT, i);
+    pkb->addProcOfStmt(i <= 9 ? "A" : "B", i);
+  }
+  for (auto stmt : {1, 2, 4, 8, 9, 10}) {
+    pkb->addStmt(DesignEntity::ASSIGN, stmt);
+  }
+  pkb->addStmt(DesignEntity::WHILE, 3);
+  pkb->addStmt(DesignEntity::READ, 5);
+  pkb->addStmt(DesignEntity::IF, 6);
+  pkb->addStmt(DesignEntity::CALL, 7);
+  pkb->addNextStmtForIfStmt(6, 3);
+  pkb->addRs(RelationshipType::CALLS_S, 7, TableType::PROC_TABLE, "B");
+  for (auto [left, right] : vector<pair<int, int>>(
+           {{1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 6}, {6, 7}, {6, 8}, {7, 3},
+            {8, 3}, {3, 9}})) {
+    pkb->addRs(RelationshipType::NEXT, left, right);
+  }
+  // the while and if modify what is modified in them, but do not kill it
+  for (auto [stmt, var] : vector<pair<int, string>>(
+           {{1, "x"}, {2, "y"}, {3, "x"}, {3, "y"}, {4, "x"}, {5, "y"},
+            {6, "y"}, {7, "y"}, {8, "y"}, {9, "z"}, {10, "y"}})) {
+    pkb->addRs(RelationshipType::MODIFIES_S, stmt, TableType::VAR_TABLE, var);
+  }
+  for (auto [stmt, var] : vector<pair<int, string>>(
+           {{2, "x"}, {3, "i"}, {3, "x"}, {3, "y"}, {4, "x"}, {4, "y"},
+            {6, "x"}, {6, "y"}, {8, "x"}, {8, "y"}, {9, "x"}, {9, "y"}})) {
+    pkb->addRs(RelationshipType::USES_S, stmt, TableType::VAR_TABLE, var);
+  }
+  // literal pairs are ruled out by kills that dominate or post-dominate
+  for (auto [stmt, dominator, postDominator] : vector<tuple<int, int, int>>(
+           {{1, -1, 2},
+            {2, 1, 3},
+            {3, 2, 9},
+            {4, 3, 5},
+            {5, 4, 6},
+            {6, 5, 3},
+            {7, 6, 3},
+            {8, 6, 3},
+            {9, 3, -1},
+            {10, -1, -1}})) {
+    pkb->addImmediateDominator(stmt, dominator);
+    pkb->addImmediatePostDominator(stmt, postDominator);
+  }
+
+  RelationshipType rsType = RelationshipType::AFFECTS;
+  Param a1 = {ParamType::SYNONYM, "a1"};
+  Param a2 = {ParamType::SYNONYM, "a2"};
+  Param wildcard = {ParamType::WILDCARD, "_"};
+  pkb->setDefUseIndexMode(DefUseIndexMode::NONE);
+  AffectsOnDemandEvaluator full(pkb);
+  ClauseIncomingResults allAffects = full.evaluatePairAffects(rsType, a1, a2);
+  REQUIRE(allAffects == ClauseIncomingResults({{1, 2},
+                                               {1, 4},
+                                               {1, 9},
+                                               {2, 4},
+                                               {2, 9},
+                                               {4, 4},
+                                               {4, 8},
+                                               {4, 9},
+                                               {8, 4},
+                                               {8, 9}}));
+
+  for (StmtNo s = 1; s <= 10; s++) {
+    Param stmt = {ParamType::INTEGER_LITERAL, to_string(s)};
+    unordered_set<int> affected;
+    unordered_set<int> affecting;
+    for (const auto& pair : allAffects) {
+      if (pair[0] == s) {
+        affected.insert(pair[1]);
+      }
+      if (pair[1] == s) {
+        affecting.insert(pair[0]);
+      }
+    }
+    AffectsOnDemandEvaluator sliced(pkb);
+    REQUIRE(sliced.evaluateBoolAffects(rsType, stmt, wildcard) ==
+            !affected.empty());
+    REQUIRE(sliced.evaluateBoolAffects(rsType, wildcard, stmt) ==
+            !affecting.empty());
+    REQUIRE(sliced.evaluateStmtAffects(rsType, stmt, a2) == affected);
+    REQUIRE(sliced.evaluateStmtAffects(rsType, a1, stmt) == affecting);
+    for (StmtNo other = 1; other <= 10; other++) {
+      AffectsOnDemandEvaluator pairSliced(pkb);
+      Param otherStmt = {ParamType::INTEGER_LITERAL, to_string(other)};
+      REQUIRE(pairSliced.evaluateBoolAffects(rsType, stmt, otherStmt) ==
+              affected.count(other) > 0);
+    }
+  }
+
+  SECTION("Def-use index agrees with the search") {
+    ClauseIncomingResults allAffectsT = full.evaluatePairAffectsT(a1, a2);
+    pkb->setDefUseIndexMode(DefUseIndexMode::LAZY);
+    AffectsOnDemandEvaluator indexed(pkb);
+    REQUIRE(indexed.evaluatePairAffects(rsType, a1, a2) == allAffects);
+    REQUIRE(indexed.evaluatePairAffectsT(a1, a2) == allAffectsT);
+    Param left = {ParamType::INTEGER_LITERAL, "2"};
+    Param right = {ParamType::INTEGER_LITERAL, "8"};
+    REQUIRE(indexed.evaluateBoolAffectsT(left, right) == true);
+    REQUIRE(indexed.evaluateBoolAffects(rsType, left, right) == false);
+  }
+}
+
+TEST_CASE("AffectsOnDemandEvaluator: Affects*, Cycle Of Affects") {
+  PKB* pkb = new PKB();
+  pkb->insertAt(TableType::PROC_TABLE, "A");
+  pkb->addFirstStmtOfProc("A", 1);
+  // example procedure
+  // 1: while (i != 0) {
+  // 2:   x = y + 1;
+  // 3:   y = x + 1; }
+  // 4: z = x;
+  for (int i = 1; i <= 4; i++) {
+    pkb->addStmt(DesignEntity::STATEMENT, i);
+  }
+  pkb->addStmt(DesignEntity::WHILE, 1);
+  pkb->addStmt(DesignEntity::ASSIGN, 2);
+  pkb->addStmt(DesignEntity::ASSIGN, 3);
+  pkb->addStmt(DesignEntity::ASSIGN, 4);
+  pkb->addRs(RelationshipType::NEXT, 1, 2);
+  pkb->addRs(RelationshipType::NEXT, 2, 3);
+  pkb->addRs(RelationshipType::NEXT, 3, 1);
+  pkb->addRs(RelationshipType::NEXT, 1, 4);
+  pkb->addRs(RelationshipType::MODIFIES_S, 2, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::USES_S, 2, TableType::VAR_TABLE, "y");
+  pkb->addRs(RelationshipType::MODIFIES_S, 3, TableType::VAR_TABLE, "y");
+  pkb->addRs(RelationshipType::USES_S, 3, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::MODIFIES_S, 4, TableType::VAR_TABLE, "z");
+  pkb->addRs(RelationshipType::USES_S, 4, TableType::VAR_TABLE, "x");
+
+  AffectsOnDemandEvaluator ae(pkb);
+  Param a1 = {ParamType::SYNONYM, "a1"};
+  Param a2 = {ParamType::SYNONYM, "a2"};
+
+  SECTION("Affects*(a1, a2)") {
+    ClauseIncomingResults expected = {{2, 2}, {2, 3}, {2, 4},
+                                      {3, 2}, {3, 3}, {3, 4}};
+    REQUIRE(ae.evaluatePairAffectsT(a1, a2) == expected);
+
+    // both directions come from the same computation
+    REQUIRE(ae.evaluateStmtAffectsT(a1, {ParamType::INTEGER_LITERAL, "4"}) ==
+            unordered_set<StmtNo>({2, 3}));
+    REQUIRE(ae.evaluateStmtAffectsT({ParamType::INTEGER_LITERAL, "4"}, a2)
+                .empty());
+  }
+
+  SECTION("Affects*(3, 3) and Affects*(4, 2)") {
+    REQUIRE(ae.evaluateBoolAffectsT({ParamType::INTEGER_LITERAL, "3"},
+                                    {ParamType::INTEGER_LITERAL, "3"}));
+    REQUIRE_FALSE(ae.evaluateBoolAffectsT({ParamType::INTEGER_LITERAL, "4"},
+                                          {ParamType::INTEGER_LITERAL, "2"}));
+  }
+
+  SECTION("Affects*(3, a2) and Affects*(a1, 2)") {
+    REQUIRE(ae.evaluateStmtAffectsT({ParamType::INTEGER_LITERAL, "3"}, a2) ==
+            unordered_set<StmtNo>({2, 3, 4}));
+    REQUIRE(ae.evaluateStmtAffectsT(a1, {ParamType::INTEGER_LITERAL, "2"}) ==
+            unordered_set<StmtNo>({2, 3}));
+  }
+}
+
+TEST_CASE("AffectsOnDemandEvaluator: AffectsBip*, Callee Shared By Callers") {
+  PKB* pkb = new PKB();
+  for (string procName : {"A", "B", "C"}) {
+    pkb->insertAt(TableType::PROC_TABLE, procName);
+  }
+  pkb->addFirstStmtOfProc("A", 1);
+  pkb->addFirstStmtOfProc("B", 5);
+  pkb->addFirstStmtOfProc("C", 7);
+  pkb->addTopoSortedProcs({"A", "B", "C"});
+  // procedure A {
+  // 1: z = 1;
+  // 2: x = 2;
+  // 3: call C;
+  // 4: y = z + w; }
+  // procedure B {
+  // 5: z = 5;
+  // 6: call C; }
+  // procedure C {
+  // 7: w = x + 1;
+  // 8: x = w; }
+  for (int i = 1; i <= 8; i++) {
+    pkb->addStmt(DesignEntity::STATEMENT, i);
+    if (i != 3 && i != 6) {
+      pkb->addStmt(DesignEntity::ASSIGN, i);
+    }
+  }
+  pkb->addStmt(DesignEntity::CALL, 3);
+  pkb->addStmt(DesignEntity::CALL, 6);
+  pkb->addRs(RelationshipType::NEXT, 1, 2);
+  pkb->addRs(RelationshipType::NEXT, 2, 3);
+  pkb->addRs(RelationshipType::NEXT, 3, 4);
+  pkb->addRs(RelationshipType::NEXT, 5, 6);
+  pkb->addRs(RelationshipType::NEXT, 7, 8);
+  pkb->addRs(RelationshipType::CALLS_S, 3, TableType::PROC_TABLE, "C");
+  pkb->addRs(RelationshipType::CALLS_S, 6, TableType::PROC_TABLE, "C");
+  pkb->addRs(RelationshipType::MODIFIES_S, 1, TableType::VAR_TABLE, "z");
+  pkb->addRs(RelationshipType::MODIFIES_S, 2, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::MODIFIES_S, 4, TableType::VAR_TABLE, "y");
+  pkb->addRs(RelationshipType::USES_S, 4, TableType::VAR_TABLE, "z");
+  pkb->addRs(RelationshipType::USES_S, 4, TableType::VAR_TABLE, "w");
+  pkb->addRs(RelationshipType::MODIFIES_S, 5, TableType::VAR_TABLE, "z");
+  pkb->addRs(RelationshipType::MODIFIES_S, 7, TableType::VAR_TABLE, "w");
+  pkb->addRs(RelationshipType::USES_S, 7, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::MODIFIES_S, 8, TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::USES_S, 8, TableType::VAR_TABLE, "w");
+  unordered_map<string, vector<string>> procToModifiedVars = {
+      {"A", {"x", "y", "z", "w"}}, {"B", {"x", "z", "w"}}, {"C", {"x", "w"}}};
+  for (const auto& procAndVars : procToModifiedVars) {
+    for (const string& var : procAndVars.second) {
+      pkb->addRs(RelationshipType::MODIFIES_P, TableType::PROC_TABLE,
+                 procAndVars.first, TableType::VAR_TABLE, var);
+    }
+    for (string var : {"x", "w"}) {
+      pkb->addRs(RelationshipType::USES_P, TableType::PROC_TABLE,
+                 procAndVars.first, TableType::VAR_TABLE, var);
+    }
+  }
+  pkb->addRs(RelationshipType::USES_P, TableType::PROC_TABLE, "A",
+             TableType::VAR_TABLE, "z");
+
+  AffectsOnDemandEvaluator ae(pkb);
+  Param a1 = {ParamType::SYNONYM, "a1"};
+  Param a2 = {ParamType::SYNONYM, "a2"};
+
+  SECTION("AffectsBip(a1, a2)") {
+    // z = 5 in B never returns into A, which only the call from B reaches
+    ClauseIncomingResults expected = {{1, 4}, {2, 7}, {7, 4}, {7, 8}};
+    REQUIRE(ae.evaluatePairAffects(RelationshipType::AFFECTS_BIP, a1, a2) ==
+            expected);
+    REQUIRE_FALSE(ae.evaluateBoolAffects(RelationshipType::AFFECTS_BIP,
+                                         {ParamType::INTEGER_LITERAL, "5"},
+                                         {ParamType::INTEGER_LITERAL, "4"}));
+  }
+
+  SECTION("AffectsBip*(a1, a2)") {
+    ClauseIncomingResults expected = {{1, 4}, {2, 4}, {2, 7},
+                                      {2, 8}, {7, 4}, {7, 8}};
+    REQUIRE(ae.evaluatePairAffectsBipT(a1, a2) == expected);
+    REQUIRE(ae.evaluateBoolAffectsBipT({ParamType::INTEGER_LITERAL, "2"},
+                                       {ParamType::INTEGER_LITERAL, "4"}));
+    REQUIRE(ae.evaluateStmtAffectsBipT(a1, {ParamType::INTEGER_LITERAL, "4"}) ==
+            unordered_set<StmtNo>({1, 2, 7}));
+  }
+}
@@ -0,0 +1,54 @@
+#include <Query/Common.h>
+#include <Query/Evaluator/LeapfrogTriejoin.h>
+
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace std;
+using namespace query;
+using namespace leapfrog;
+using Catch::Matchers::UnorderedEquals;
+
+TEST_CASE("LeapfrogTriejoin: Triangle") {
+  // edges 1->2, 2->3, 3->1 form the only triangle, 1->3 and 2->4 do not
+  vector<vector<int>> edges = {{1, 2}, {2, 3}, {3, 1}, {1, 3}, {2, 4}};
+  vector<JoinRelation> relations = {
+      {{"a", "b"}, edges}, {{"b", "c"}, edges}, {{"c", "a"}, edges}};
+
+  vector<IntermediateQueryResult> results =
+      LeapfrogTriejoin(relations).join(false);
+  vector<IntermediateQueryResult> expected = {
+      {{"a", 1}, {"b", 2}, {"c", 3}},
+      {{"a", 2}, {"b", 3}, {"c", 1}},
+      {{"a", 3}, {"b", 1}, {"c", 2}}};
+  REQUIRE_THAT(results, UnorderedEquals(expected));
+
+  SECTION("Stops at the first result") {
+    REQUIRE(LeapfrogTriejoin(relations).join(true).size() == 1);
+  }
+}
+
+TEST_CASE("LeapfrogTriejoin: Unary Relations and Duplicates") {
+  vector<JoinRelation> relations = {
+      {{"w", "s"}, {{1, 2}, {1, 3}, {1, 3}, {4, 5}, {4, 6}}},
+      {{"s"}, {{3}, {5}, {6}}},
+      {{"w"}, {{4}, {1}}},
+      {{"s", "w"}, {{3, 1}, {6, 4}, {2, 4}}}};
+
+  vector<IntermediateQueryResult> results =
+      LeapfrogTriejoin(relations).join(false);
+  vector<IntermediateQueryResult> expected = {{{"w", 1}, {"s", 3}},
+                                              {{"w", 4}, {"s", 6}}};
+  REQUIRE_THAT(results, UnorderedEquals(expected));
+}
+
+TEST_CASE("LeapfrogTriejoin: No Results") {
+  vector<JoinRelation> relations = {{{"a", "b"}, {{1, 2}, {2, 3}}},
+                                    {{"b", "c"}, {{3, 4}}},
+                                    {{"c", "a"}, {{4, 1}}}};
+  REQUIRE(LeapfrogTriejoin(relations).join(false).empty());
+
+  relations.push_back({{"a"}, {}});
+  REQUIRE(LeapfrogTriejoin(relations).join(false).empty());
+}
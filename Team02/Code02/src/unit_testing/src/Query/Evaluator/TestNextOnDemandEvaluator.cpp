@@ -2,7 +2,9 @@
 #include <Query/Common.h>
 #include <Query/Evaluator/NextOnDemandEvaluator.h>
 
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 #include "catch.hpp"
 
@@ -441,12 +443,11 @@ TEST_CASE("NextOnDemandEvaluator: NextBipT") {
   }
   // proc A {
   // 1: x = 1;
-  // 2: x = 5; }
+  // 2: call B; }
   // proc B {
   // 3: if (x == 2) then {
   // 4:   read x; }
-  // 5: else { x = 3; } }
-  // proc C {
+  // 5: else { x = 3; }
   // 6: y = 2; }
 
   RelationshipType nextBipRsType = RelationshipType::NEXT_BIP;
@@ -459,6 +460,20 @@ TEST_CASE("NextOnDemandEvaluator: NextBipT") {
   pkb->addRs(nextBipRsType, 4, 6);
   pkb->addRs(nextBipRsType, 5, 6);
 
+  // NextBip* follows Next within procedures and steps into calls
+  pkb->addRs(RelationshipType::NEXT, 1, 2);
+  pkb->addRs(RelationshipType::NEXT, 3, 4);
+  pkb->addRs(RelationshipType::NEXT, 3, 5);
+  pkb->addRs(RelationshipType::NEXT, 4, 6);
+  pkb->addRs(RelationshipType::NEXT, 5, 6);
+  pkb->addStmt(DesignEntity::CALL, 2);
+  pkb->addRs(RelationshipType::CALLS_S, 2, TableType::PROC_TABLE, "B");
+  pkb->addFirstStmtOfProc("A", 1);
+  pkb->addFirstStmtOfProc("B", 3);
+  for (int i = 1; i <= 6; i++) {
+    pkb->addProcOfStmt(i <= 2 ? "A" : "B", i);
+  }
+
   NextOnDemandEvaluator ne(pkb);
 
   /* NextBip* -------------------------------------------------------- */
@@ -508,3 +523,237 @@ TEST_CASE("NextOnDemandEvaluator: NextBipT") {
     REQUIRE_THAT(result, !VectorContains(vector<int>({4, 5})));
   }
 }
+
+TEST_CASE("NextOnDemandEvaluator: NextT Over Many Statements") {
+  // 20 procedures of 5 statements, each a while loop around the next 4
+  const int numProcs = 20;
+  PKB* pkb = new PKB();
+  ClauseIncomingResults expected;
+  for (int p = 0; p < numProcs; p++) {
+    int whileStmt = 5 * p + 1;
+    for (int s = whileStmt; s <= whileStmt + 4; s++) {
+      pkb->addStmt(DesignEntity::STATEMENT, s);
+      for (int t = whileStmt; t <= whileStmt + 4; t++) {
+        expected.insert({s, t});
+      }
+    }
+    pkb->addRs(RelationshipType::NEXT, whileStmt, whileStmt + 1);
+    pkb->addRs(RelationshipType::NEXT, whileStmt + 1, whileStmt + 2);
+    pkb->addRs(RelationshipType::NEXT, whileStmt + 2, whileStmt + 3);
+    pkb->addRs(RelationshipType::NEXT, whileStmt + 3, whileStmt + 4);
+    pkb->addRs(RelationshipType::NEXT, whileStmt + 4, whileStmt);
+  }
+
+  ThreadPool threadPool(3);
+  Param s1 = {ParamType::SYNONYM, "s1"};
+  Param s2 = {ParamType::SYNONYM, "s2"};
+  for (int numWorkers : {1, 2, 4, 8}) {
+    WorkStealingScheduler scheduler(&threadPool, numWorkers);
+    NextOnDemandEvaluator ne(pkb, &scheduler);
+    // a cached statement is reused rather than traversed again
+    ne.evaluateNextTNextBipT(RelationshipType::NEXT_T,
+                             {ParamType::INTEGER_LITERAL, "7"}, s2);
+    REQUIRE(ne.evaluatePairNextTNextBipT(RelationshipType::NEXT_T, s1, s2) ==
+            expected);
+  }
+}
+
+TEST_CASE("NextOnDemandEvaluator: NextT Of Two Statements By Each Oracle") {
+  // procedure a { 1. x = 1; 2. while (x > 0) { 3. x = x - 1; } 4. y = x; }
+  RelationshipType rsType = RelationshipType::NEXT_T;
+  for (NextTOracle oracle :
+       {NextTOracle::STMT_RANGES, NextTOracle::REACHABILITY_INDEX,
+        NextTOracle::SEARCH}) {
+    PKB* pkb = new PKB();
+    for (int s = 1; s <= 4; s++) {
+      pkb->addStmt(DesignEntity::STATEMENT, s);
+    }
+    pkb->addRs(RelationshipType::NEXT, 1, 2);
+    pkb->addRs(RelationshipType::NEXT, 2, 3);
+    pkb->addRs(RelationshipType::NEXT, 3, 2);
+    pkb->addRs(RelationshipType::NEXT, 2, 4);
+    pkb->insertAt(TableType::PROC_TABLE, "a");
+    pkb->addProcRange("a", 1, 4);
+    pkb->addWhileRange(2, 3);
+    pkb->setNextTOracle(oracle);
+    pkb->freeze();
+    REQUIRE(pkb->getNextTOracle() == oracle);
+
+    NextOnDemandEvaluator ne(pkb);
+    auto isNextT = [&ne, rsType](int fromStmt, int toStmt) {
+      return ne.evaluateBoolNextTNextBipT(
+          rsType, {ParamType::INTEGER_LITERAL, to_string(fromStmt)},
+          {ParamType::INTEGER_LITERAL, to_string(toStmt)});
+    };
+    REQUIRE(isNextT(1, 4));
+    REQUIRE(isNextT(3, 3));
+    REQUIRE(isNextT(3, 4));
+    REQUIRE_FALSE(isNextT(1, 1));
+    REQUIRE_FALSE(isNextT(4, 2));
+  }
+}
+
+TEST_CASE("NextOnDemandEvaluator: NextT Rows Met With Synonym Domains") {
+  // 1 to 10 in a row, with 5 a while loop around 6
+  PKB* pkb = new PKB();
+  for (int s = 1; s <= 10; s++) {
+    pkb->addStmt(DesignEntity::STATEMENT, s);
+    if (s != 6 && s != 10) {
+      pkb->addRs(RelationshipType::NEXT, s, s + 1);
+    }
+  }
+  pkb->addRs(RelationshipType::NEXT, 6, 5);
+  pkb->addRs(RelationshipType::NEXT, 5, 7);
+
+  RelationshipType rsType = RelationshipType::NEXT_T;
+  Param s1 = {ParamType::SYNONYM, "s1"};
+  Param s2 = {ParamType::SYNONYM, "s2"};
+  Param wildcard = {ParamType::WILDCARD, "_"};
+  IntervalSet leftDomain({2, 3, 9});
+  IntervalSet rightDomain({1, 4, 5, 6});
+  NextOnDemandEvaluator ne(pkb);
+
+  SECTION("Rows of a statement") {
+    REQUIRE(ne.evaluateNextTNextBipT(rsType,
+                                     {ParamType::INTEGER_LITERAL, "3"}, s2,
+                                     &rightDomain) ==
+            unordered_set<int>({4, 5, 6}));
+    REQUIRE(ne.evaluateNextTNextBipT(rsType, s1,
+                                     {ParamType::INTEGER_LITERAL, "6"},
+                                     &leftDomain) ==
+            unordered_set<int>({2, 3}));
+    // the cached rows are left whole
+    REQUIRE(ne.evaluateNextTNextBipT(rsType,
+                                     {ParamType::INTEGER_LITERAL, "3"}, s2)
+                .size() == 7);
+  }
+
+  SECTION("Pairs of two synonyms") {
+    ClauseIncomingResults expected = {{2, 4}, {2, 5}, {2, 6},
+                                      {3, 4}, {3, 5}, {3, 6}};
+    REQUIRE(ne.evaluatePairNextTNextBipT(rsType, s1, s2, &leftDomain,
+                                         &rightDomain) == expected);
+  }
+
+  SECTION("Pairs of a synonym and a wildcard") {
+    REQUIRE(ne.evaluatePairNextTNextBipT(rsType, wildcard, s2, nullptr,
+                                         &rightDomain) ==
+            ClauseIncomingResults({{4}, {5}, {6}}));
+    REQUIRE(ne.evaluatePairNextTNextBipT(rsType, s1, wildcard, &leftDomain,
+                                         nullptr) ==
+            ClauseIncomingResults({{2}, {3}, {9}}));
+  }
+}
+
+TEST_CASE("NextOnDemandEvaluator: NextBipT, Callee Shared By Callers") {
+  PKB* pkb = new PKB();
+  // proc A {
+  // 1: call C;
+  // 2: x = 1; }
+  // proc B {
+  // 3: call C;
+  // 4: y = 1; }
+  // proc C {
+  // 5: z = 1; }
+  for (int i = 1; i <= 5; i++) {
+    pkb->addStmt(DesignEntity::STATEMENT, i);
+  }
+  pkb->addStmt(DesignEntity::CALL, 1);
+  pkb->addStmt(DesignEntity::CALL, 3);
+  pkb->addRs(RelationshipType::NEXT, 1, 2);
+  pkb->addRs(RelationshipType::NEXT, 3, 4);
+  pkb->addRs(RelationshipType::CALLS_S, 1, TableType::PROC_TABLE, "C");
+  pkb->addRs(RelationshipType::CALLS_S, 3, TableType::PROC_TABLE, "C");
+  pkb->addFirstStmtOfProc("A", 1);
+  pkb->addFirstStmtOfProc("B", 3);
+  pkb->addFirstStmtOfProc("C", 5);
+  vector<string> procOfStmts = {"A", "A", "B", "B", "C"};
+  for (int i = 1; i <= 5; i++) {
+    pkb->addProcOfStmt(procOfStmts[i - 1], i);
+  }
+
+  NextOnDemandEvaluator ne(pkb);
+  RelationshipType rsType = RelationshipType::NEXT_BIP_T;
+  Param s = {ParamType::SYNONYM, "s"};
+
+  SECTION("Calls return to where they were made") {
+    REQUIRE(ne.evaluateNextTNextBipT(rsType,
+                                     {ParamType::INTEGER_LITERAL, "1"}, s) ==
+            unordered_set<int>({5, 2}));
+    REQUIRE(ne.evaluateNextTNextBipT(rsType, s,
+                                     {ParamType::INTEGER_LITERAL, "4"}) ==
+            unordered_set<int>({3, 5}));
+    REQUIRE_FALSE(ne.evaluateBoolNextTNextBipT(
+        rsType, {ParamType::INTEGER_LITERAL, "1"},
+        {ParamType::INTEGER_LITERAL, "4"}));
+  }
+
+  SECTION("A callee returns to any of its callers") {
+    REQUIRE(ne.evaluateNextTNextBipT(rsType,
+                                     {ParamType::INTEGER_LITERAL, "5"}, s) ==
+            unordered_set<int>({2, 4}));
+    REQUIRE(ne.evaluateNextTNextBipT(rsType, s,
+                                     {ParamType::INTEGER_LITERAL, "5"}) ==
+            unordered_set<int>({1, 3}));
+  }
+
+  SECTION("NextBipT(s1, s2)") {
+    ClauseIncomingResults expected = {{1, 5}, {1, 2}, {3, 5},
+                                      {3, 4}, {5, 2}, {5, 4}};
+    REQUIRE(ne.evaluatePairNextTNextBipT(rsType, s,
+                                         {ParamType::SYNONYM, "s2"}) ==
+            expected);
+  }
+}
+
+TEST_CASE("NextOnDemandEvaluator: Speedup Of NextT Rows With Workers",
+          "[.][benchmark]") {
+  // not run by default. times the rows of every statement, traversed in
+  // parallel, at 1, 2, 4 and 8 workers. run with "[benchmark]" on a machine
+  // with at least as many cores for the speedups to mean anything.
+  // 1 to 2000 is a chain of while loops, each over the next 19 statements
+  const int NUM_STMTS = 2000;
+  const int LOOP_SIZE = 20;
+  PKB* pkb = new PKB();
+  for (int i = 1; i <= NUM_STMTS; i++) {
+    pkb->addStmt(DesignEntity::STATEMENT, i);
+  }
+  for (int whileStmt = 1; whileStmt <= NUM_STMTS; whileStmt += LOOP_SIZE) {
+    int lastStmt = min(whileStmt + LOOP_SIZE - 1, NUM_STMTS);
+    for (int i = whileStmt; i < lastStmt; i++) {
+      pkb->addRs(RelationshipType::NEXT, i, i + 1);
+    }
+    if (lastStmt > whileStmt) {
+      pkb->addRs(RelationshipType::NEXT, lastStmt, whileStmt);
+    }
+    if (whileStmt + LOOP_SIZE <= NUM_STMTS) {
+      pkb->addRs(RelationshipType::NEXT, whileStmt, whileStmt + LOOP_SIZE);
+    }
+  }
+  Param left = {ParamType::SYNONYM, "s"};
+  Param right = {ParamType::WILDCARD, "_"};
+
+  double singleWorkerSeconds = 0;
+  ClauseIncomingResults singleWorkerResults;
+  for (int numWorkers : {1, 2, 4, 8}) {
+    ThreadPool threadPool(numWorkers);
+    WorkStealingScheduler scheduler(&threadPool, numWorkers);
+    NextOnDemandEvaluator ne(pkb, &scheduler);
+    auto start = chrono::steady_clock::now();
+    ClauseIncomingResults results =
+        ne.evaluatePairNextTNextBipT(RelationshipType::NEXT_T, left, right);
+    double seconds =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (numWorkers == 1) {
+      singleWorkerSeconds = seconds;
+      singleWorkerResults = results;
+    }
+    REQUIRE(results == singleWorkerResults);
+    double speedup = singleWorkerSeconds / seconds;
+    WARN(numWorkers << " workers: " << seconds << "s, speedup " << speedup);
+    if (numWorkers > 1 && numWorkers <= thread::hardware_concurrency()) {
+      REQUIRE(speedup > 1);
+    }
+  }
+}
@@ -451,4 +451,112 @@ TEST_CASE("WithEvaluator: Integer Attributes") {
     REQUIRE_THAT(newQueryResults,
                  VectorContains(IntermediateQueryResult({{"s1", 2}})));
   }
+
+  /* Constants Too Large For A long long --------------------------------- */
+  string bigConst = "123456789012345678901234567890";
+  int bigConstIdx = pkb->insertAt(TableType::CONST_TABLE, bigConst);
+
+  SECTION("with c1.value = c2.value, of a large constant") {
+    Param left = {ParamType::ATTRIBUTE_VALUE, "c1"};
+    Param right = {ParamType::ATTRIBUTE_VALUE, "c2"};
+    vector<IntermediateQueryResult> currentResults = {
+        {{"c1", bigConstIdx}, {"c2", bigConstIdx}},
+        {{"c1", bigConstIdx}, {"c2", const1Idx}}};
+    auto results = we.evaluateAttributes(left, right, synonyms, currentResults);
+    auto newQueryResults = get<1>(results);
+    REQUIRE(get<0>(results));
+    REQUIRE(newQueryResults ==
+            vector<IntermediateQueryResult>(
+                {{{"c1", bigConstIdx}, {"c2", bigConstIdx}}}));
+
+    ClauseIncomingResults joinedValues = we.joinAttributes(
+        left, right, synonyms, {const1Idx, bigConstIdx},
+        {const2Idx, bigConstIdx});
+    REQUIRE(joinedValues ==
+            ClauseIncomingResults({{bigConstIdx, bigConstIdx}}));
+  }
+
+  SECTION("with c1.value = n1 and c1.value = literal, of a large constant") {
+    Param left = {ParamType::ATTRIBUTE_VALUE, "c1"};
+    Param right = {ParamType::SYNONYM, "n1"};
+    vector<IntermediateQueryResult> currentResults = {
+        {{"c1", bigConstIdx}, {"n1", 1}}, {{"c1", const1Idx}, {"n1", 1}}};
+    auto results = we.evaluateAttributes(left, right, synonyms, currentResults);
+    REQUIRE(get<1>(results) == vector<IntermediateQueryResult>(
+                                   {{{"c1", const1Idx}, {"n1", 1}}}));
+
+    right = {ParamType::INTEGER_LITERAL, bigConst};
+    currentResults = {{{"c1", bigConstIdx}}, {{"c1", const1Idx}}};
+    results = we.evaluateAttributes(left, right, synonyms, currentResults);
+    REQUIRE(get<1>(results) ==
+            vector<IntermediateQueryResult>({{{"c1", bigConstIdx}}}));
+  }
+
+  SECTION("with literal = literal, of large numbers") {
+    Param left = {ParamType::INTEGER_LITERAL, bigConst};
+    Param right = {ParamType::INTEGER_LITERAL, bigConst};
+    vector<IntermediateQueryResult> currentResults = {{{"s1", 1}}};
+    REQUIRE(get<0>(
+        we.evaluateAttributes(left, right, synonyms, currentResults)));
+
+    right = {ParamType::INTEGER_LITERAL, bigConst + "1"};
+    REQUIRE_FALSE(get<0>(
+        we.evaluateAttributes(left, right, synonyms, currentResults)));
+  }
+}
+
+TEST_CASE("WithEvaluator: Join Attributes") {
+  PKB* pkb = new PKB();
+  pkb->addStmt(DesignEntity::CALL, 1);
+  pkb->addStmt(DesignEntity::READ, 2);
+  pkb->addStmt(DesignEntity::ASSIGN, 3);
+  int procAIdx = pkb->insertAt(TableType::PROC_TABLE, "A");
+  int procBIdx = pkb->insertAt(TableType::PROC_TABLE, "B");
+  int varBIdx = pkb->insertAt(TableType::VAR_TABLE, "B");
+  int varXIdx = pkb->insertAt(TableType::VAR_TABLE, "x");
+  pkb->addRs(RelationshipType::CALLS_S, 1, procBIdx);
+  pkb->addRs(RelationshipType::MODIFIES_S, 2, varBIdx);
+  int const3Idx = pkb->insertAt(TableType::CONST_TABLE, "3");
+  int const03Idx = pkb->insertAt(TableType::CONST_TABLE, "03");
+  int const7Idx = pkb->insertAt(TableType::CONST_TABLE, "7");
+
+  WithEvaluator we(pkb);
+  unordered_map<string, DesignEntity> synonyms = {
+      {"p", DesignEntity::PROCEDURE}, {"c", DesignEntity::CALL},
+      {"v", DesignEntity::VARIABLE},  {"rd", DesignEntity::READ},
+      {"s", DesignEntity::STATEMENT}, {"cn", DesignEntity::CONSTANT}};
+
+  SECTION("with p.procName = v.varName") {
+    Param left = {ParamType::ATTRIBUTE_PROC_NAME, "p"};
+    Param right = {ParamType::ATTRIBUTE_VAR_NAME, "v"};
+    REQUIRE(we.joinAttributes(left, right, synonyms, {procAIdx, procBIdx},
+                              {varBIdx, varXIdx}) ==
+            ClauseIncomingResults({{procBIdx, varBIdx}}));
+  }
+
+  SECTION("with c.procName = rd.varName") {
+    Param left = {ParamType::ATTRIBUTE_PROC_NAME, "c"};
+    Param right = {ParamType::ATTRIBUTE_VAR_NAME, "rd"};
+    REQUIRE(we.joinAttributes(left, right, synonyms, {1}, {2}) ==
+            ClauseIncomingResults({{1, 2}}));
+  }
+
+  SECTION("with s.stmt# = cn.value") {
+    // constants are compared by value rather than by spelling
+    Param left = {ParamType::ATTRIBUTE_STMT_NUM, "s"};
+    Param right = {ParamType::ATTRIBUTE_VALUE, "cn"};
+    REQUIRE(we.joinAttributes(left, right, synonyms, {1, 2, 3},
+                              {const3Idx, const03Idx, const7Idx}) ==
+            ClauseIncomingResults({{3, const3Idx}, {3, const03Idx}}));
+  }
+
+  SECTION("with p.procName = 'C'") {
+    Param left = {ParamType::ATTRIBUTE_PROC_NAME, "p"};
+    Param right = {ParamType::NAME_LITERAL, "C"};
+    vector<IntermediateQueryResult> currentResults = {{{"p", procAIdx}},
+                                                      {{"p", procBIdx}}};
+    auto results = we.evaluateAttributes(left, right, synonyms, currentResults);
+    REQUIRE_FALSE(get<0>(results));
+    REQUIRE(get<1>(results).empty());
+  }
 }
@@ -272,3 +272,68 @@ TEST_CASE("Project with attributes") {
             set<string>({"procA procA x 4", "procB procB y 5"}));
   }
 }
+
+TEST_CASE("Project factorised results") {
+  PKB* pkb = new PKB();
+  int xVarIdx = pkb->insertAt(TableType::VAR_TABLE, "x");
+  int yVarIdx = pkb->insertAt(TableType::VAR_TABLE, "y");
+  int aProcIdx = pkb->insertAt(TableType::PROC_TABLE, "procA");
+
+  ResultProjector projector(pkb);
+  vector<Synonym> selectSynonyms = {{DesignEntity::VARIABLE, "v", false, {}},
+                                    {DesignEntity::ASSIGN, "a", false, {}},
+                                    {DesignEntity::PROCEDURE, "p", false, {}}};
+
+  SECTION("Select <v, a, p> - cross product of factors") {
+    FactorisedQueryResults results = {
+        true,
+        {{{"a", "p"}, {{1, aProcIdx}, {2, aProcIdx}}},
+         {{"v"}, {{xVarIdx}, {yVarIdx}}}}};
+    list<string> result = projector.formatFactorisedResults(
+        SelectType::SYNONYMS, selectSynonyms, results);
+    REQUIRE(result.size() == 4);
+    REQUIRE(set<string>(result.begin(), result.end()) ==
+            set<string>({"x 1 procA", "x 2 procA", "y 1 procA",
+                         "y 2 procA"}));
+  }
+
+  SECTION("Select <v, a, p> - empty factor") {
+    FactorisedQueryResults results = {
+        true, {{{"a", "p"}, {{1, aProcIdx}}}, {{"v"}, {}}}};
+    REQUIRE(projector
+                .formatFactorisedResults(SelectType::SYNONYMS, selectSynonyms,
+                                         results)
+                .empty());
+  }
+
+  SECTION("Select <v, a, p> - synonym in no factor") {
+    FactorisedQueryResults results = {true, {{{"a", "p"}, {{1, aProcIdx}}}}};
+    REQUIRE(projector
+                .formatFactorisedResults(SelectType::SYNONYMS, selectSynonyms,
+                                         results)
+                .empty());
+    REQUIRE(projector
+                .formatFactorisedResults(SelectType::SYNONYMS, selectSynonyms,
+                                         {true, {}})
+                .empty());
+  }
+
+  SECTION("Select <v, a, p> - strings precomputed by the pkb") {
+    pkb->addStmt(DesignEntity::ASSIGN, 1);
+    pkb->freeze();
+    FactorisedQueryResults results = {
+        true, {{{"a", "p"}, {{1, aProcIdx}}}, {{"v"}, {{yVarIdx}}}}};
+    REQUIRE(projector.formatFactorisedResults(SelectType::SYNONYMS,
+                                              selectSynonyms, results) ==
+            list<string>({"y 1 procA"}));
+  }
+
+  SECTION("Select BOOLEAN") {
+    REQUIRE(projector.formatFactorisedResults(SelectType::BOOLEAN, {},
+                                              {true, {}}) ==
+            list<string>({"TRUE"}));
+    REQUIRE(projector.formatFactorisedResults(SelectType::BOOLEAN, {},
+                                              {false, {}}) ==
+            list<string>({"FALSE"}));
+  }
+}